@@ -3,6 +3,10 @@
 #include "calc.h"
 
 
+// Errors of in-process module can't call exit, that's why error jumps back to mdl_invoke
+static __thread jmp_buf _calc_error;
+
+
 /* Stack implementation */
 void stack_init(simple_stack_t *s) {
     s->pos = -1;
@@ -10,13 +14,13 @@ void stack_init(simple_stack_t *s) {
 }
 
 void stack_push(int64_t data, simple_stack_t *s) {
-    if (s->pos + 1 >= MAX_ADT_SIZE) exit(1);
+    if (s->pos + 1 >= MAX_ADT_SIZE) CALC_FAIL(1);
     s->pos++;
     s->data[s->pos] = data;
 }
 
 int64_t stack_pop(simple_stack_t *s) {
-    if (stack_is_empty(s)) exit(11);
+    if (stack_is_empty(s)) CALC_FAIL(11);
     return s->data[s->pos--];
 }
 
@@ -25,7 +29,7 @@ int stack_is_empty(const simple_stack_t *s) {
 }
 
 int64_t stack_peek(const simple_stack_t *s) {
-    if (stack_is_empty(s)) exit(2);
+    if (stack_is_empty(s)) CALC_FAIL(2);
     return s->data[s->pos];
 }
 
@@ -36,7 +40,7 @@ void queue_init(simple_queue_t* q) {
 }
 
 void queue_enqueue(token_t data, simple_queue_t* q) {
-    if (q->back + 1 >= MAX_ADT_SIZE) exit(3);
+    if (q->back + 1 >= MAX_ADT_SIZE) CALC_FAIL(3);
     if (q->front == -1) {
         /* Empty queue */
         q->front = 0;
@@ -47,7 +51,7 @@ void queue_enqueue(token_t data, simple_queue_t* q) {
 }
 
 token_t queue_dequeue (simple_queue_t* q) {
-    if (queue_is_empty(q)) exit(4);
+    if (queue_is_empty(q)) CALC_FAIL(4);
     return q->data[q->front++];
 }
 
@@ -148,7 +152,7 @@ void shunting_yard(const char* input, simple_stack_t* ops, simple_queue_t* outpu
                 /* Balanced parenthesis check */
                 if (stack_is_empty(&parenthesis)) {
                     /* We must have a '(' */
-                    exit(8);
+                    CALC_FAIL(8);
                 }
                 
                 stack_pop(&parenthesis);
@@ -160,7 +164,7 @@ void shunting_yard(const char* input, simple_stack_t* ops, simple_queue_t* outpu
             default: {
                 int64_t number = 0;
                 if (!isdigit(c)){
-                    exit(7);
+                    CALC_FAIL(7);
                 }
 
                 while (isdigit(input[i])){
@@ -181,7 +185,7 @@ void shunting_yard(const char* input, simple_stack_t* ops, simple_queue_t* outpu
 
     /* Parenthesis stack must be empty */
     if (!stack_is_empty(&parenthesis)) {
-        exit(6);
+        CALC_FAIL(6);
     }
 
     /* Put remaining operators in the tokens queue */
@@ -232,7 +236,7 @@ int64_t compute_rpn(simple_queue_t *q) {
                     op2 = stack_pop(&work_area);
                     op1 = stack_pop(&work_area);
                     if (op2 == 0) {
-                         exit(10);
+                         CALC_FAIL(10);
                     }
 
                     res = op1 / op2;
@@ -244,7 +248,7 @@ int64_t compute_rpn(simple_queue_t *q) {
                     op2 = stack_pop(&work_area);
                     op1 = stack_pop(&work_area);
                     if (op2 == 0) {
-                        exit(9);
+                        CALC_FAIL(9);
                     }
 
                     res = op1 % op2;
@@ -267,27 +271,54 @@ int64_t compute_rpn(simple_queue_t *q) {
     }
 
     if (work_area.pos != 0) {
-        exit(10);
+        CALC_FAIL(10);
     }
 
     return stack_peek(&work_area);
 }
 
-int main(int argc, char* argv[]) {
-    int64_t result;
-    simple_queue_t output;
-    simple_stack_t ops;
+int mdl_init() {
+    return MDL_SUCCESS;
+}
 
-    if (argc != 2) {
-        return 13;
+int mdl_invoke(int argc, char* argv[], char* output, size_t output_size) {
+    if (argc < 2) return 13;
+
+    // Expression can be splitted by spaces in values, that's why all arguments joined back
+    char expression[MAX_EXPRESSION_SIZE] = { 0 };
+    for (int i = 1; i < argc; i++) {
+        strncat(expression, argv[i], sizeof(expression) - strlen(expression) - 1);
+        if (i + 1 < argc) strncat(expression, " ", sizeof(expression) - strlen(expression) - 1);
     }
 
-    queue_init(&output);
+    int error = setjmp(_calc_error);
+    if (error) return error;
+
+    simple_queue_t rpn;
+    simple_stack_t ops;
+    queue_init(&rpn);
     stack_init(&ops);
 
-    shunting_yard(argv[1], &ops, &output);
+    shunting_yard(expression, &ops, &rpn);
+    snprintf(output, output_size, "%lld", (long long)compute_rpn(&rpn));
+    return MDL_SUCCESS;
+}
 
-    result = compute_rpn(&output);
-    printf("%lld", result);
-    return 100;
-}
\ No newline at end of file
+int mdl_flags() {
+    return MDL_DETERMINISTIC;
+}
+
+MDL_BATCH_ENTRY
+
+void mdl_free() {
+    return;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc == 2 && strcmp(argv[1], MDL_BATCH_FLAG) == 0) return mdl_serve_batch();
+
+    char result[MAX_EXPRESSION_SIZE] = { 0 };
+    int code = mdl_invoke(argc, argv, result, sizeof(result));
+    if (code == MDL_SUCCESS) printf("%s", result);
+    return code;
+}
@@ -1,4 +1,5 @@
-// tcc calc.c -o calc.mdl -lm
+// Executable: gcc calc.c -o calc.mdl -lm
+// Shared: gcc -shared -fPIC calc.c -o calc.so -lm
 #ifndef CALCULATOR_H_
 #define CALCULATOR_H_
 
@@ -7,6 +8,10 @@
 #include <stdlib.h>
 #include <ctype.h>
 #include <math.h>
+#include <setjmp.h>
+#include <stdint.h>
+
+#include "../mdl.h"
 
 /*
   '%'  -  37
@@ -20,6 +25,8 @@
 */
 
 #define MAX_ADT_SIZE 100 /* Max size of Stack and Queue */
+#define MAX_EXPRESSION_SIZE 256
+#define CALC_FAIL(code) longjmp(_calc_error, (code))
 
 /* Data type for numbers and operators */
 typedef enum
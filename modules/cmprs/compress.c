@@ -45,3 +45,39 @@ int UNZ_byte_by_bits(unsigned char* data, size_t data_size, unsigned char* outpu
 
     return current_index;
 }
+
+int mdl_init() {
+    return MDL_SUCCESS;
+}
+
+int mdl_invoke(int argc, char* argv[], char* output, size_t output_size) {
+    if (argc != 3 || output_size < 1) return 1;
+
+    unsigned char result[MAX_CMPRS_SIZE * 2] = { 0 };
+    size_t data_size = strlen(argv[2]) < MAX_CMPRS_SIZE ? strlen(argv[2]) : MAX_CMPRS_SIZE;
+
+    int result_size = 0;
+    if (strcmp(argv[1], ZIP) == 0) result_size = CMP_byte_by_bits((unsigned char*)argv[2], data_size, result);
+    else if (strcmp(argv[1], UNZIP) == 0) result_size = UNZ_byte_by_bits((unsigned char*)argv[2], data_size, result);
+    else return 2;
+
+    if ((size_t)result_size > output_size - 1) result_size = output_size - 1;
+    memcpy(output, result, result_size);
+    output[result_size] = '\0';
+    return MDL_SUCCESS;
+}
+
+MDL_BATCH_ENTRY
+
+void mdl_free() {
+    return;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc == 2 && strcmp(argv[1], MDL_BATCH_FLAG) == 0) return mdl_serve_batch();
+
+    char result[MAX_CMPRS_SIZE * 2 + 1] = { 0 };
+    int code = mdl_invoke(argc, argv, result, sizeof(result));
+    if (code == MDL_SUCCESS) printf("%s", result);
+    return code;
+}
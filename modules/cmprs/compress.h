@@ -11,6 +11,8 @@
  *  If not, see https://www.gnu.org/licenses/.
  */
 
+// Executable: gcc compress.c -o cmprs.mdl
+// Shared: gcc -shared -fPIC compress.c -o cmprs.so
 #ifndef COMPRESS_H_
 #define COMPRESS_H_
 
@@ -18,6 +20,8 @@
 #include <string.h>
 #include <stdio.h>
 
+#include "../mdl.h"
+
 
 // Insert bit to byte by provided index and value
 #define INSERT_BIT(byte, index, value) \
@@ -33,6 +37,10 @@
 // Get bit from byte by provided index
 #define GET_BIT(byte, index)       (((byte) >> (index)) & 0x01)
 
+#define ZIP     "zip"
+#define UNZIP   "unzip"
+#define MAX_CMPRS_SIZE 256
+
 
 int CMP_byte_by_bits(unsigned char* data, size_t data_size, unsigned char* output);
 int UNZ_byte_by_bits(unsigned char* data, size_t data_size, unsigned char* output);
@@ -1,5 +1,6 @@
 // Ubuntu: sudo apt install libssl-dev
 // - tcc hash.c -o hash.mdl -lssl -lcrypto
+// - gcc -shared -fPIC hash.c -o hash.so -lssl -lcrypto
 // MacOS: brew install openssh
 // - gcc-14 hash.c -o hash.mdl -I$(brew --prefix openssl)/include -L$(brew --prefix openssl)/lib -lssl -lcrypto
 #include <openssl/sha.h>
@@ -7,6 +8,8 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include "../mdl.h"
+
 
 char* hash_string(const char* input, size_t output_size) {
     unsigned char hash[SHA256_DIGEST_LENGTH];
@@ -28,14 +31,37 @@ char* hash_string(const char* input, size_t output_size) {
     return output;
 }
 
-int main(int argc, char* argv[]) {
+int mdl_init() {
+    return MDL_SUCCESS;
+}
+
+int mdl_invoke(int argc, char* argv[], char* output, size_t output_size) {
     if (argc != 3) return 1;
 
     char* hash_result = hash_string(argv[1], atoi(argv[2]));
     if (!hash_result) return 3;
 
-    printf("%s", hash_result);
+    snprintf(output, output_size, "%s", hash_result);
     free(hash_result);
 
-    return 100;
+    return MDL_SUCCESS;
+}
+
+int mdl_flags() {
+    return MDL_DETERMINISTIC;
+}
+
+MDL_BATCH_ENTRY
+
+void mdl_free() {
+    return;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc == 2 && strcmp(argv[1], MDL_BATCH_FLAG) == 0) return mdl_serve_batch();
+
+    char result[SHA256_DIGEST_LENGTH * 2 + 1] = { 0 };
+    int code = mdl_invoke(argc, argv, result, sizeof(result));
+    if (code == MDL_SUCCESS) printf("%s", result);
+    return code;
 }
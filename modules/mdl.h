@@ -0,0 +1,133 @@
+/*
+ *  License:
+ *  Copyright (C) 2024 Nikolaj Fot
+ *
+ *  This program is free software: you can redistribute it and/or modify it under the terms of
+ *  the GNU General Public License as published by the Free Software Foundation, version 3.
+ *  This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License along with this program.
+ *  If not, see https://www.gnu.org/licenses/.
+ *
+ *  Description:
+ *  Module ABI. Module, that built as shared object (<name>.so), loaded by kernel once and invoked
+ *  in kernel process. Module, that built as executable (<name>.mdl), launched by kernel for every call.
+ *  Same source can be built in both ways: main only calls mdl_invoke and prints answer.
+ *  Note: Shared module invoked from many sessions at same time, that's why mdl_invoke should be reentrant
+ *  and should never call exit.
+ *
+ *  Batch:
+ *  Kernel invokes modules for page of rows at once. Shared module can export mdl_invoke_batch (MDL_BATCH_ENTRY
+ *  gives default one). Executable module, that launched with MDL_BATCH_FLAG argument, should serve framed
+ *  requests from stdin (mdl_serve_batch does it):
+ *  request  - [ length (4 bytes LE) | args (length bytes) ]
+ *  response - [ code (4 bytes LE) | length (4 bytes LE) | answer (length bytes) ]
+ *  Module exits with MDL_SUCCESS after stdin closed. Module without batch support will be launched for every row.
+ *  Kernel keeps batch module alive between calls (worker), that's why every answer should be flushed.
+ */
+
+#ifndef MDL_H_
+#define MDL_H_
+
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+
+// Exit code (and mdl_invoke return value) of success. Kernel ignores answer with other code.
+#define MDL_SUCCESS 100
+
+// Module answer depends only from arguments. Kernel can reuse answer for same arguments.
+#define MDL_DETERMINISTIC 0x01
+
+#define MDL_BATCH_FLAG      "--batch"
+#define MDL_MAX_ARGS        16
+#define MDL_MAX_REQUEST     256
+#define MDL_MAX_ANSWER      128
+
+
+/*
+Called once, when kernel loads module. Optional.
+
+Return MDL_SUCCESS if module ready for work.
+*/
+int mdl_init();
+
+/*
+Invoke module. Arguments splitted by spaces, as in executable module.
+
+Params:
+- argc - Arguments count.
+- argv - Arguments. argv[0] is module name.
+- output - Destination for answer. Answer should be null-terminated.
+- output_size - Size of output.
+
+Return MDL_SUCCESS if answer placed to output.
+*/
+int mdl_invoke(int argc, char* argv[], char* output, size_t output_size);
+
+/*
+Invoke module for many argument tuples. Optional.
+
+Params:
+- count - Tuples count.
+- argcs - Arguments count of every tuple.
+- argvs - Arguments of every tuple.
+- outputs - Destination for answers. Answer of tuple i placed at outputs + i * output_size.
+- output_size - Size of one answer.
+- codes - Destination for result code of every tuple.
+
+Return count of invoked tuples.
+*/
+int mdl_invoke_batch(int count, int argcs[], char** argvs[], char* outputs, size_t output_size, int codes[]);
+
+/*
+Flags of module. Optional.
+
+Return flags (MDL_DETERMINISTIC) or 0.
+*/
+int mdl_flags();
+
+/*
+Called once, when kernel unloads module. Optional.
+*/
+void mdl_free();
+
+
+// Default batch entry point, that invokes mdl_invoke for every tuple
+#define MDL_BATCH_ENTRY                                                                                   \
+    int mdl_invoke_batch(int count, int argcs[], char** argvs[], char* outputs, size_t output_size, int codes[]) { \
+        for (int i = 0; i < count; i++) codes[i] = mdl_invoke(argcs[i], argvs[i], outputs + i * output_size, output_size); \
+        return count;                                                                                     \
+    }
+
+/*
+Serve framed batch requests from stdin until it closed. Used by executable module, if kernel
+launched it with MDL_BATCH_FLAG.
+
+Return MDL_SUCCESS if all requests served.
+*/
+static inline int mdl_serve_batch() {
+    unsigned int length = 0;
+    while (fread(&length, sizeof(length), 1, stdin) == 1) {
+        char request[MDL_MAX_REQUEST] = { 0 };
+        char answer[MDL_MAX_ANSWER] = { 0 };
+        if (length >= sizeof(request) || fread(request, 1, length, stdin) != length) return 1;
+
+        char* argv[MDL_MAX_ARGS + 1] = { "mdl" };
+        int argc = 1;
+        for (char* token = strtok(request, " "); token && argc < MDL_MAX_ARGS; token = strtok(NULL, " ")) argv[argc++] = token;
+
+        int code = mdl_invoke(argc, argv, answer, sizeof(answer));
+        unsigned int answer_length = code == MDL_SUCCESS ? (unsigned int)strnlen(answer, sizeof(answer)) : 0;
+        fwrite(&code, sizeof(code), 1, stdout);
+        fwrite(&answer_length, sizeof(answer_length), 1, stdout);
+        fwrite(answer, 1, answer_length, stdout);
+        fflush(stdout);
+    }
+
+    return MDL_SUCCESS;
+}
+
+#endif
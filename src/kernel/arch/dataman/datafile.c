@@ -68,6 +68,7 @@ int DB_save_database(database_t* database) {
 
             fsync(fd);
             close(fd);
+            MTR_add(MTR_FSYNCS, 1);
         }
     }
 
@@ -43,6 +43,56 @@ static table_t* _get_table_access(
     return table;
 }
 
+static void _sort_keys(unsigned char** keys, size_t count, size_t key_size) {
+    // Shell sort by raw key bytes. We don't use qsort here, because comparator should know key size.
+    for (size_t gap = count / 2; gap > 0; gap /= 2) {
+        for (size_t i = gap; i < count; i++) {
+            unsigned char* key = keys[i];
+            size_t j = i;
+            for (; j >= gap && memcmp(keys[j - gap], key, key_size) > 0; j -= gap) keys[j] = keys[j - gap];
+            keys[j] = key;
+        }
+    }
+}
+
+static int _find_key(unsigned char** keys, size_t count, unsigned char* key, size_t key_size) {
+    size_t left = 0, right = count;
+    while (left < right) {
+        size_t middle = left + (right - left) / 2;
+        int comparison = memcmp(keys[middle], key, key_size);
+        if (comparison == 0) return 1;
+        else if (comparison < 0) left = middle + 1;
+        else right = middle;
+    }
+
+    return 0;
+}
+
+static int _is_increment_column(table_column_t* column) {
+    if (GET_COLUMN_TYPE(column->type) != COLUMN_AUTO_INCREMENT) return 0;
+    if (GET_COLUMN_DATA_TYPE(column->type) == COLUMN_TYPE_INT) return 1;
+    if (GET_COLUMN_DATA_TYPE(column->type) != COLUMN_TYPE_BINARY) return 0;
+    return GET_COLUMN_BINARY_TYPE(column->type) == COLUMN_BINARY_I32 || GET_COLUMN_BINARY_TYPE(column->type) == COLUMN_BINARY_I64;
+}
+
+static long long _get_increment_value(table_column_t* column, unsigned char* data) {
+    if (GET_COLUMN_BINARY(column->type)) return TBM_get_binary_int(column->type, data);
+    char number_buffer[128] = { 0 };
+    strncpy(number_buffer, (char*)data, MIN(column->size, sizeof(number_buffer) - 1));
+    return atoll(number_buffer);
+}
+
+static void _set_increment_value(table_column_t* column, long long value, unsigned char* data) {
+    int32_t value32 = (int32_t)value;
+    char buffer[128] = { 0 };
+    if (GET_COLUMN_BINARY_TYPE(column->type) == COLUMN_BINARY_I32 && GET_COLUMN_BINARY(column->type)) memcpy(data, &value32, sizeof(int32_t));
+    else if (GET_COLUMN_BINARY(column->type)) memcpy(data, &value, sizeof(long long));
+    else {
+        sprintf(buffer, "%0*lld", column->size, value);
+        memcpy(data, buffer, column->size);
+    }
+}
+
 #pragma region [CRUD]
 
 int DB_append_row(
@@ -51,7 +101,7 @@ int DB_append_row(
 ) {
     table_t* table = _get_table_access(database, table_name, access, check_write_access);
     if (table == NULL) return -4;
-    if (table->row_size > data_size) {
+    if (table->text_row_size > data_size) {
         TBM_flush_table(table);
         return -5;
     }
@@ -62,6 +112,17 @@ int DB_append_row(
         return result - 10;
     }
 
+    // Text row converted to storage format once. Below we work only with storage row.
+    unsigned char row[PAGE_CONTENT_SIZE] = { 0 };
+    result = TBM_encode_row(table, data, row);
+    if (result != 1) {
+        TBM_flush_table(table);
+        return result - 10;
+    }
+
+    data = row;
+    data_size = table->row_size;
+
     // Get primary column and column offset
     int column_offset = 0;
     table_column_t* primary_column = NULL;
@@ -71,20 +132,12 @@ int DB_append_row(
         }
 
         unsigned char* current_data = data + column_offset;
-        if (
-            GET_COLUMN_TYPE(table->columns[i]->type) == COLUMN_AUTO_INCREMENT && 
-            GET_COLUMN_DATA_TYPE(table->columns[i]->type) == COLUMN_TYPE_INT
-        ) {
+        if (_is_increment_column(table->columns[i])) {
             unsigned char* previous_data = (unsigned char*)malloc(table->row_size);
             if (previous_data != NULL) {
-                if (DB_get_row(database, table_name, MAX(table->header->row_count - 1, 0), access, previous_data, table->row_size)) {
-                    char number_buffer[128] = { 0 };
-                    strncpy(number_buffer, (char*)(previous_data + column_offset), table->columns[i]->size);
-
-                    char buffer[128] = { 0 };
-                    sprintf(buffer, "%0*d", table->columns[i]->size, atoi(number_buffer) + 1);
-
-                    memcpy(current_data, buffer, table->columns[i]->size);
+                if (DB_get_row(database, table_name, MAX(table->header->row_count - 1, 0), access, previous_data, table->row_size, NULL)) {
+                    long long previous_value = _get_increment_value(table->columns[i], previous_data + column_offset);
+                    _set_increment_value(table->columns[i], previous_value + 1, current_data);
                 }
 
                 free(previous_data);
@@ -110,7 +163,7 @@ int DB_append_row(
         }
     }
 
-    TBM_invoke_modules(table, data, COLUMN_MODULE_PRELOAD); // O(n)
+    TBM_invoke_modules(table, data, COLUMN_MODULE_PRELOAD, NULL); // O(n)
     result = TBM_append_content(table, data, data_size);
 
     table->header->row_count++;
@@ -118,22 +171,174 @@ int DB_append_row(
     return result;
 }
 
+int DB_append_rows(
+    database_t* __restrict database, char* __restrict table_name, 
+    unsigned char* data[], size_t data_size[], size_t rows_count, unsigned char access
+) {
+    table_t* table = _get_table_access(database, table_name, access, check_write_access);
+    if (table == NULL) return -4;
+    if (rows_count == 0) {
+        TBM_flush_table(table);
+        return 1;
+    }
+
+    unsigned char* rows = (unsigned char*)malloc(table->row_size * rows_count);
+    if (!rows) {
+        TBM_flush_table(table);
+        return -1;
+    }
+
+    // Validate whole batch before any disk operation
+    int result = 1;
+    for (size_t i = 0; i < rows_count && result == 1; i++) { // O(n * m)
+        if (table->text_row_size > data_size[i]) result = -5;
+        else {
+            int signature = TBM_check_signature(table, data[i]);
+            if (signature == 1) signature = TBM_encode_row(table, data[i], rows + i * table->row_size);
+            if (signature != 1) result = signature - 10;
+        }
+    }
+
+    // Get primary column and fill auto increment columns.
+    // Previous row loaded once for whole batch.
+    int column_offset = 0;
+    int primary_offset = 0;
+    table_column_t* primary_column = NULL;
+    for (int i = 0; i < table->header->column_count && result == 1; i++) {
+        if (GET_COLUMN_PRIMARY(table->columns[i]->type) == COLUMN_PRIMARY) {
+            primary_column = table->columns[i];
+            primary_offset = column_offset;
+        }
+
+        if (_is_increment_column(table->columns[i])) {
+            unsigned char* previous_data = (unsigned char*)malloc(table->row_size);
+            if (previous_data != NULL) {
+                // If table is empty, first row keeps his own value
+                long long next_value = 0;
+                if (DB_get_row(database, table_name, MAX(table->header->row_count - 1, 0), access, previous_data, table->row_size, NULL)) {
+                    next_value = _get_increment_value(table->columns[i], previous_data + column_offset) + 1;
+                }
+                else {
+                    next_value = _get_increment_value(table->columns[i], rows + column_offset);
+                }
+
+                for (size_t j = 0; j < rows_count; j++) {
+                    _set_increment_value(table->columns[i], next_value++, rows + j * table->row_size + column_offset);
+                }
+
+                free(previous_data);
+            }
+        }
+
+        column_offset += table->columns[i]->size;
+    }
+
+    // Uniqueness of primary column checked in one merge pass.
+    // We sort batch keys, check them for duplicates, and then compare each existed row with batch.
+    if (result == 1 && primary_column != NULL) {
+        unsigned char** keys = (unsigned char**)malloc(sizeof(unsigned char*) * rows_count);
+        unsigned char* page_buffer = (unsigned char*)malloc(PAGE_CONTENT_SIZE);
+        if (!keys || !page_buffer) result = -1;
+        else {
+            for (size_t i = 0; i < rows_count; i++) keys[i] = rows + i * table->row_size + primary_offset;
+            _sort_keys(keys, rows_count, primary_column->size);
+            for (size_t i = 1; i < rows_count && result == 1; i++) {
+                if (memcmp(keys[i - 1], keys[i], primary_column->size) == 0) result = -20;
+            }
+
+            int rows_per_page = PAGE_CONTENT_SIZE / table->row_size;
+            for (int offset = 0; result == 1; offset += PAGE_CONTENT_SIZE) {
+                memset(page_buffer, PAGE_EMPTY, PAGE_CONTENT_SIZE);
+                if (!TBM_get_content(table, offset, page_buffer, PAGE_CONTENT_SIZE)) break;
+                for (int j = 0; j < rows_per_page; j++) {
+                    unsigned char* row_data = page_buffer + j * table->row_size;
+                    if (*row_data == PAGE_EMPTY) continue;
+                    if (_find_key(keys, rows_count, row_data + primary_offset, primary_column->size)) {
+                        result = -20;
+                        break;
+                    }
+                }
+            }
+        }
+
+        SOFT_FREE(keys);
+        SOFT_FREE(page_buffer);
+    }
+
+    if (result == 1) {
+        TBM_invoke_modules_batch(table, rows, rows_count, COLUMN_MODULE_PRELOAD, NULL);
+        if (THR_require_lock(&table->lock, omp_get_thread_num()) == 1) {
+            // Part of rows can be already placed to pages, when write failed
+            result = TBM_append_rows(table, rows, rows_count) == 1 ? 1 : -3;
+            if (result == 1) table->header->row_count += rows_count;
+            THR_release_lock(&table->lock, omp_get_thread_num());
+        }
+        else {
+            result = -1;
+        }
+    }
+
+    free(rows);
+    TBM_flush_table(table);
+    return result;
+}
+
 int DB_get_row(
     database_t* __restrict database, char* __restrict table_name, int row, unsigned char access, 
-    unsigned char* buffer, size_t buffer_size
+    unsigned char* buffer, size_t buffer_size, unsigned char* columns
 ) {
     table_t* table = _get_table_access(database, table_name, access, check_write_access);
     if (table == NULL) return 0;
 
     int get_result = TBM_get_content(table, _get_global_offset(table->row_size, row), buffer, buffer_size);
     if (get_result) {
-        TBM_invoke_modules(table, buffer, COLUMN_MODULE_POSTLOAD);
+        TBM_invoke_modules(table, buffer, COLUMN_MODULE_POSTLOAD, columns);
     }
 
     TBM_flush_table(table);
     return get_result;
 }
 
+int DB_get_page_rows(
+    database_t* __restrict database, char* __restrict table_name, int page, 
+    unsigned char access, unsigned char* buffer, unsigned char* columns
+) {
+    table_t* table = _get_table_access(database, table_name, access, check_write_access);
+    if (table == NULL) return -1;
+
+    unsigned long long start = QST_time();
+    int rows_per_page = PAGE_CONTENT_SIZE / table->row_size;
+    memset(buffer, PAGE_EMPTY, PAGE_CONTENT_SIZE);
+    if (!TBM_get_page_columns(table, page, columns, buffer)) {
+        TBM_flush_table(table);
+        return 0;
+    }
+
+    int rows_count = 0;
+    for (int i = 0; i < rows_per_page; i++) {
+        if (buffer[i * table->row_size] != PAGE_EMPTY) rows_count++;
+    }
+
+    TBM_invoke_modules_batch(table, buffer, rows_per_page, COLUMN_MODULE_POSTLOAD, columns);
+
+    QST_end(QST_SCAN, start, rows_per_page, rows_count);
+    TBM_flush_table(table);
+    return rows_per_page;
+}
+
+int DB_get_page_zone(
+    database_t* __restrict database, char* __restrict table_name, int page, unsigned char access,
+    page_zone_t* __restrict page_zone, page_zone_t* __restrict directory_zone, 
+    zone_layout_t* __restrict layout, unsigned char* __restrict bloom
+) {
+    table_t* table = _get_table_access(database, table_name, access, check_write_access);
+    if (table == NULL) return -1;
+
+    int result = TBM_get_page_zone(table, page, page_zone, directory_zone, layout, bloom);
+    TBM_flush_table(table);
+    return result;
+}
+
 int DB_insert_row(
     database_t* __restrict database, char* __restrict table_name, 
     int row, unsigned char* __restrict data, size_t data_size, unsigned char access
@@ -141,20 +346,22 @@ int DB_insert_row(
 #ifndef NO_UPDATE_COMMAND
     table_t* table = _get_table_access(database, table_name, access, check_write_access);
     if (table == NULL) return -1;
-    if (table->row_size > data_size) {
+    if (table->text_row_size > data_size) {
         TBM_flush_table(table);
         return -5;
     }
 
+    unsigned char storage_row[PAGE_CONTENT_SIZE] = { 0 };
     int result = TBM_check_signature(table, data);
+    if (result == 1) result = TBM_encode_row(table, data, storage_row);
     if (result != 1) {
         TBM_flush_table(table);
         return result - 10;
     }
 
-    TBM_invoke_modules(table, data, COLUMN_MODULE_PRELOAD);
+    TBM_invoke_modules(table, storage_row, COLUMN_MODULE_PRELOAD, NULL);
     if (THR_require_lock(&table->lock, omp_get_thread_num()) == 1) {
-        result = TBM_insert_content(table, _get_global_offset(table->row_size, row), data, data_size);
+        result = TBM_insert_content(table, _get_global_offset(table->row_size, row), storage_row, table->row_size);
         THR_release_lock(&table->lock, omp_get_thread_num());
     }
 
@@ -182,6 +389,47 @@ int DB_delete_row(database_t* __restrict database, char* __restrict table_name,
     return 1;
 }
 
+int DB_prepare_row(
+    database_t* __restrict database, char* __restrict table_name, unsigned char* __restrict data, size_t data_size, unsigned char access
+) {
+    table_t* table = _get_table_access(database, table_name, access, check_write_access);
+    if (table == NULL) return -1;
+    if (table->text_row_size > data_size) {
+        TBM_flush_table(table);
+        return -5;
+    }
+
+    // Storage row is never larger than text row, that's why it placed back to same buffer
+    unsigned char storage_row[PAGE_CONTENT_SIZE] = { 0 };
+    int result = TBM_check_signature(table, data);
+    if (result == 1) result = TBM_encode_row(table, data, storage_row);
+    if (result == 1) {
+        TBM_invoke_modules(table, storage_row, COLUMN_MODULE_PRELOAD, NULL);
+        memcpy(data, storage_row, table->row_size);
+    }
+
+    TBM_flush_table(table);
+    return result == 1 ? 1 : result - 10;
+}
+
+int DB_mutate_page(
+    database_t* __restrict database, char* __restrict table_name, int page, 
+    unsigned char* __restrict mask, unsigned char* __restrict data, unsigned char access
+) {
+    table_t* table = _get_table_access(database, table_name, access, data == NULL ? check_delete_access : check_write_access);
+    if (table == NULL) return -1;
+
+    int result = -1;
+    if (THR_require_lock(&table->lock, omp_get_thread_num()) == 1) {
+        result = TBM_mutate_page(table, page, mask, data);
+        if (data == NULL && result > 0) table->header->row_count = MAX(table->header->row_count - result, 0);
+        THR_release_lock(&table->lock, omp_get_thread_num());
+    }
+
+    TBM_flush_table(table);
+    return result;
+}
+
 #pragma endregion
 
 int DB_cleanup_tables(database_t* database) {
@@ -57,8 +57,21 @@ int DRM_save_directory(directory_t* directory) {
                     }
                 }
 
+                // Zone maps placed after all page name slots. Old directory files don't have this part.
+                int zones_offset = sizeof(directory_header_t) + PAGE_NAME_SIZE * PAGES_PER_DIRECTORY;
+                if (pwrite(fd, &directory->zone_layout, sizeof(zone_layout_t), zones_offset) != sizeof(zone_layout_t)) status = -1;
+                zones_offset += sizeof(zone_layout_t);
+                if (pwrite(fd, &directory->zone, sizeof(page_zone_t), zones_offset) != sizeof(page_zone_t)) status = -1;
+                zones_offset += sizeof(page_zone_t);
+                int zones_size = sizeof(page_zone_t) * directory->header->page_count;
+                if (pwrite(fd, directory->zones, zones_size, zones_offset) != zones_size) status = -1;
+                zones_offset += sizeof(page_zone_t) * PAGES_PER_DIRECTORY;
+                int blooms_size = PAGE_BLOOM_SIZE * directory->header->page_count;
+                if (pwrite(fd, directory->blooms, blooms_size, zones_offset) != blooms_size) status = -1;
+
                 fsync(fd);
                 close(fd);
+                MTR_add(MTR_FSYNCS, 1);
             }
         }
     }
@@ -76,9 +89,11 @@ directory_t* DRM_load_directory(char* name) {
     directory_t* loaded_directory = (directory_t*)CHC_find_entry(name, DIRECTORY_BASE_PATH, DIRECTORY_CACHE);
     if (loaded_directory != NULL) {
         print_io("Loading directory [%s] from GCT", load_path);
+        QST_add(directory_hits, 1);
         return loaded_directory;
     }
 
+    unsigned long long load_start = QST_time();
     #pragma omp critical (directory_load)
     {
         // Open file directory
@@ -107,6 +122,23 @@ directory_t* DRM_load_directory(char* name) {
                         for (int i = 0; i < MIN(header->page_count, PAGES_PER_DIRECTORY); i++)
                             pread(fd, directory->page_names[i], PAGE_NAME_SIZE, sizeof(directory_header_t) + PAGE_NAME_SIZE * i);
 
+                        // If zone maps not presented, layout stays empty and all zones invalid
+                        int zones_offset = sizeof(directory_header_t) + PAGE_NAME_SIZE * PAGES_PER_DIRECTORY;
+                        int zones_size  = sizeof(page_zone_t) * MIN(header->page_count, PAGES_PER_DIRECTORY);
+                        int blooms_size = PAGE_BLOOM_SIZE * MIN(header->page_count, PAGES_PER_DIRECTORY);
+                        int blooms_offset = zones_offset + sizeof(zone_layout_t) + sizeof(page_zone_t) * (PAGES_PER_DIRECTORY + 1);
+                        if (
+                            pread(fd, &directory->zone_layout, sizeof(zone_layout_t), zones_offset) != sizeof(zone_layout_t) ||
+                            pread(fd, &directory->zone, sizeof(page_zone_t), zones_offset + sizeof(zone_layout_t)) != sizeof(page_zone_t) ||
+                            pread(fd, directory->zones, zones_size, zones_offset + sizeof(zone_layout_t) + sizeof(page_zone_t)) != zones_size ||
+                            pread(fd, directory->blooms, blooms_size, blooms_offset) != blooms_size
+                        ) {
+                            memset(&directory->zone_layout, 0, sizeof(zone_layout_t));
+                            memset(&directory->zone, 0, sizeof(page_zone_t));
+                            memset(directory->zones, 0, sizeof(directory->zones));
+                            memset(directory->blooms, 0, sizeof(directory->blooms));
+                        }
+
                         // Close file directory
                         close(fd);
 
@@ -124,6 +156,8 @@ directory_t* DRM_load_directory(char* name) {
         }
     }
 
+    QST_add(directory_loads, 1);
+    QST_add(load_time, QST_time() - load_start);
     return loaded_directory;
 }
 
@@ -180,5 +214,9 @@ unsigned int DRM_get_checksum(directory_t* directory) {
 
     directory->header->checksum = prev_checksum;
     checksum = crc32(checksum, (const unsigned char*)directory->page_names, sizeof(directory->page_names));
+    checksum = crc32(checksum, (const unsigned char*)&directory->zone_layout, sizeof(zone_layout_t));
+    checksum = crc32(checksum, (const unsigned char*)&directory->zone, sizeof(page_zone_t));
+    checksum = crc32(checksum, (const unsigned char*)directory->zones, sizeof(directory->zones));
+    checksum = crc32(checksum, (const unsigned char*)directory->blooms, sizeof(directory->blooms));
     return checksum;
 }
@@ -13,10 +13,14 @@ static int _unlink_page_from_directory(directory_t* __restrict directory, char*
     {
         for (int i = 0; i < directory->header->page_count; i++) {
             if (strncmp(directory->page_names[i], page_name, PAGE_NAME_SIZE) == 0) {
-                for (int j = i; j < directory->header->page_count - 1; j++)
+                for (int j = i; j < directory->header->page_count - 1; j++) {
                     memcpy(directory->page_names[j], directory->page_names[j + 1], PAGE_NAME_SIZE);
+                    memcpy(&directory->zones[j], &directory->zones[j + 1], sizeof(page_zone_t));
+                    memcpy(directory->blooms[j], directory->blooms[j + 1], PAGE_BLOOM_SIZE);
+                }
 
                 directory->header->page_count--;
+                memset(&directory->zones[directory->header->page_count], 0, sizeof(page_zone_t));
                 directory->append_offset = MAX(directory->append_offset - 1, 0);
                 status = 1;
                 break;
@@ -27,12 +31,126 @@ static int _unlink_page_from_directory(directory_t* __restrict directory, char*
     return status;
 }
 
+static page_t* _load_page(directory_t* directory, int index) {
+    page_t* page = PGM_load_page(directory->header->name, directory->page_names[index]);
+    if (page) {
+        page->layout = &directory->page_layout;
+        page->codec  = directory->page_layout.codec;
+    }
+
+    return page;
+}
+
+#pragma region [Zones]
+
+    static void _update_directory_zone(directory_t* directory) {
+        page_zone_t* zone = &directory->zone;
+        memset(zone, 0, sizeof(page_zone_t));
+        zone->is_valid = directory->zone_layout.row_size > 0;
+        for (int i = 0; i < ZONE_COLUMNS; i++) {
+            zone->min[i] = INT_MAX;
+            zone->max[i] = INT_MIN;
+        }
+
+        for (int i = 0; i < directory->header->page_count && zone->is_valid; i++) {
+            page_zone_t* page_zone = &directory->zones[i];
+            if (!page_zone->is_valid) {
+                zone->is_valid = 0;
+                break;
+            }
+
+            zone->rows_count  += page_zone->rows_count;
+            zone->empty_count += page_zone->empty_count;
+            for (int j = 0; j < directory->zone_layout.column_count; j++) {
+                zone->min[j] = MIN(zone->min[j], page_zone->min[j]);
+                zone->max[j] = MAX(zone->max[j], page_zone->max[j]);
+            }
+        }
+    }
+
+    static unsigned int _hash_bloom_key(int column, unsigned char* key, int key_size) {
+        unsigned int hash = 2166136261u ^ (unsigned int)column;
+        for (int i = 0; i < key_size; i++) {
+            hash ^= key[i];
+            hash *= 16777619u;
+        }
+
+        return hash;
+    }
+
+    static void _add_bloom_key(unsigned char* __restrict bloom, int column, unsigned char* __restrict key, int key_size) {
+        // Double hashing: every next bit position is previous one plus second hash
+        unsigned int hash = _hash_bloom_key(column, key, key_size);
+        unsigned int step = (hash >> 17) | (hash << 15) | 1;
+        for (int i = 0; i < BLOOM_HASHES; i++, hash += step) {
+            unsigned int bit = hash % (PAGE_BLOOM_SIZE * 8);
+            bloom[bit / 8] |= 1 << (bit % 8);
+        }
+    }
+
+    /*
+    Recompute zone of page from page content. Bloom filter can be kept on delete, because
+    filter with deleted values still don't have false negatives.
+    */
+    static void _update_page_zone(directory_t* __restrict directory, int index, page_t* __restrict page, int update_bloom) {
+        zone_layout_t* layout = &directory->zone_layout;
+        if (layout->row_size == 0) return;
+
+        // Filter of page with unknown zone can be empty, that's why we rebuild it
+        if (!directory->zones[index].is_valid) update_bloom = 1;
+        if (update_bloom) memset(directory->blooms[index], 0, PAGE_BLOOM_SIZE);
+
+        page_zone_t zone;
+        memset(&zone, 0, sizeof(page_zone_t));
+        zone.is_valid = 1;
+        for (int i = 0; i < ZONE_COLUMNS; i++) {
+            zone.min[i] = INT_MAX;
+            zone.max[i] = INT_MIN;
+        }
+
+        unsigned char row_buffer[PAGE_CONTENT_SIZE];
+        int is_pax = directory->page_layout.type == PAGE_LAYOUT_PAX;
+        for (int slot = 0; slot < PAGE_CONTENT_SIZE / layout->row_size; slot++) {
+            // Row of PAX page assembled from minipages
+            unsigned char* row = page->content + slot * layout->row_size;
+            if (is_pax) {
+                PGM_get_content(page, slot * layout->row_size, row_buffer, layout->row_size);
+                row = row_buffer;
+            }
+
+            if (row[0] == PAGE_EMPTY) {
+                zone.empty_count++;
+                continue;
+            }
+
+            zone.rows_count++;
+            for (int i = 0; i < layout->column_count; i++) {
+                char value[ZONE_VALUE_SIZE + 1] = { 0 };
+                memcpy(value, row + layout->offsets[i], MIN(layout->sizes[i], ZONE_VALUE_SIZE));
+                int int_value = atoi(value);
+                zone.min[i] = MIN(zone.min[i], int_value);
+                zone.max[i] = MAX(zone.max[i], int_value);
+            }
+
+            for (int i = 0; i < layout->bloom_count && update_bloom; i++) {
+                unsigned char key[BLOOM_KEY_SIZE];
+                int key_size = DRM_get_bloom_key(row + layout->bloom_offsets[i], layout->bloom_sizes[i], layout->bloom_numeric[i], key);
+                _add_bloom_key(directory->blooms[index], i, key, key_size);
+            }
+        }
+
+        memcpy(&directory->zones[index], &zone, sizeof(page_zone_t));
+        _update_directory_zone(directory);
+    }
+
+#pragma endregion
+
 #pragma region [CRUD]
 
 int DRM_append_content(directory_t* __restrict directory, unsigned char* __restrict data, size_t data_lenght) {
     // First we try to find fit empty place somewhere in linked pages
     for (int i = directory->append_offset; i < directory->header->page_count; i++) {
-        page_t* page = PGM_load_page(directory->header->name, directory->page_names[i]);
+        page_t* page = _load_page(directory, i);
         if (!page) continue;
         if (page->append_offset == -1) {
             page->append_offset = PGM_get_fit_free_space(page, PAGE_START, data_lenght);
@@ -42,6 +160,7 @@ int DRM_append_content(directory_t* __restrict directory, unsigned char* __restr
             if (THR_require_lock(&page->lock, omp_get_thread_num()) == 1) {
                 PGM_insert_content(page, page->append_offset, data, data_lenght);
                 page->append_offset += data_lenght;
+                _update_page_zone(directory, i, page, 1);
                 THR_release_lock(&page->lock, omp_get_thread_num());
                 PGM_flush_page(page);
                 return 1;
@@ -55,6 +174,8 @@ int DRM_append_content(directory_t* __restrict directory, unsigned char* __restr
     // We allocate memory for page structure with all needed data
     page_t* new_page = PGM_create_empty_page(directory->header->name);
     if (new_page == NULL) return -2;
+    new_page->layout = &directory->page_layout;
+    new_page->codec  = directory->page_layout.codec;
 
     // Insert new content to page and mark end
     directory->append_offset = directory->header->page_count;
@@ -62,12 +183,90 @@ int DRM_append_content(directory_t* __restrict directory, unsigned char* __restr
 
     // We link page to directory
     _link_page2dir(directory, new_page);
+    _update_page_zone(directory, directory->append_offset, new_page, 1);
     CHC_add_entry(new_page, new_page->header->name, directory->header->name, PAGE_CACHE, (void*)PGM_free_page, (void*)PGM_save_page);
     PGM_flush_page(new_page);
 
     return 2;
 }
 
+int DRM_append_rows(directory_t* __restrict directory, unsigned char* __restrict data, size_t row_size, size_t rows_count) {
+    int appended = 0;
+    int rows_per_page = PAGE_CONTENT_SIZE / (int)row_size;
+
+    // First we fill empty row slots in already linked pages
+    for (int i = directory->append_offset; i < directory->header->page_count && appended < (int)rows_count; i++) {
+        page_t* page = _load_page(directory, i);
+        if (!page) continue;
+        if (THR_require_lock(&page->lock, omp_get_thread_num()) == 1) {
+            for (int slot = 0; slot < rows_per_page && appended < (int)rows_count; slot++) {
+                if (page->content[PGM_get_physical_offset(page, slot * row_size)] != PAGE_EMPTY) continue;
+                PGM_insert_content(page, slot * row_size, data + appended * row_size, row_size);
+                appended++;
+            }
+
+            page->append_offset = -1;
+            _update_page_zone(directory, i, page, 1);
+            THR_release_lock(&page->lock, omp_get_thread_num());
+        }
+
+        PGM_flush_page(page);
+    }
+
+    // Then we build new pages in memory and write every page to disk only once.
+    // These pages don't go to GCT, because we don't want to evict hot pages by bulk data.
+    while (appended < (int)rows_count && directory->header->page_count < PAGES_PER_DIRECTORY) {
+        page_t* new_page = PGM_create_empty_page(directory->header->name);
+        if (new_page == NULL) return appended > 0 ? appended : -2;
+        new_page->layout = &directory->page_layout;
+        new_page->codec  = directory->page_layout.codec;
+
+        int page_rows = MIN(rows_per_page, (int)rows_count - appended);
+        PGM_insert_content(new_page, 0, data + appended * row_size, page_rows * row_size);
+        appended += page_rows;
+
+        directory->append_offset = directory->header->page_count;
+        _link_page2dir(directory, new_page);
+        _update_page_zone(directory, directory->append_offset, new_page, 1);
+        PGM_save_page(new_page);
+        PGM_free_page(new_page);
+    }
+
+    return appended;
+}
+
+int DRM_mutate_page(
+    directory_t* __restrict directory, int index, unsigned char* __restrict mask, size_t row_size, unsigned char* __restrict data
+) {
+    if (index < 0 || index >= directory->header->page_count) return -1;
+    page_t* page = _load_page(directory, index);
+    if (!page) return -1;
+
+    int changed = 0;
+    int rows_per_page = PAGE_CONTENT_SIZE / (int)row_size;
+    if (THR_require_lock(&page->lock, omp_get_thread_num()) == 1) {
+        // All marked slots changed in one pass under one page lock
+        for (int slot = 0; slot < rows_per_page; slot++) {
+            if (!mask[slot] || page->content[PGM_get_physical_offset(page, slot * row_size)] == PAGE_EMPTY) continue;
+            if (data != NULL) PGM_insert_content(page, slot * row_size, data, row_size);
+            else PGM_delete_content(page, slot * row_size, row_size);
+            changed++;
+        }
+
+        // Free space and zone recalculated once per page
+        if (data == NULL && changed > 0) {
+            page->append_offset = -1;
+            directory->append_offset = MIN(directory->append_offset, index);
+        }
+
+        if (changed > 0) _update_page_zone(directory, index, page, data != NULL);
+        THR_release_lock(&page->lock, omp_get_thread_num());
+    }
+
+    PGM_flush_page(page);
+    return changed;
+}
+
 int DRM_get_content(directory_t* __restrict directory, int offset, unsigned char* __restrict buffer, size_t data_lenght) {
     int status = 0;
     unsigned char* content_pointer = buffer;
@@ -75,7 +274,7 @@ int DRM_get_content(directory_t* __restrict directory, int offset, unsigned char
     int page_offset = offset % PAGE_CONTENT_SIZE;
     for (int i = start_page; i < directory->header->page_count && data_lenght > 0; i++) {
         // We load current page
-        page_t* page = PGM_load_page(directory->header->name, directory->page_names[i]);
+        page_t* page = _load_page(directory, i);
         if (!page) continue;
         if (THR_require_lock(&page->lock, omp_get_thread_num()) == 1) {
             // We work with page
@@ -105,12 +304,13 @@ int DRM_insert_content(directory_t* __restrict directory, int offset, unsigned c
     int index_offset = offset % PAGE_CONTENT_SIZE;
     for (int i = page_offset; i < directory->header->page_count && data_lenght > 0; i++) {
         // We load current page to memory
-        page_t* page = PGM_load_page(directory->header->name, directory->page_names[i]);
+        page_t* page = _load_page(directory, i);
         if (!page) return -1;
 
         // We insert current part of content with local offset
         if (THR_require_lock(&page->lock, omp_get_thread_num()) == 1) { 
             int result = PGM_insert_content(page, index_offset, data_pointer, (int)data_lenght);
+            _update_page_zone(directory, i, page, 1);
             THR_release_lock(&page->lock, omp_get_thread_num());
 
             // We reload local index and update size2delete
@@ -135,11 +335,12 @@ int DRM_delete_content(directory_t* directory, int offset, size_t data_size) {
     int page_offset = offset % PAGE_CONTENT_SIZE;
     for (int i = start_page; i < directory->header->page_count && data_size > 0; i++) {
         // We load current page
-        page_t* page = PGM_load_page(directory->header->name, directory->page_names[i]);
+        page_t* page = _load_page(directory, i);
         if (!page) return -1;
         if (THR_require_lock(&page->lock, omp_get_thread_num()) == 1) {
             int result = PGM_delete_content(page, page_offset, data_size);
             directory->append_offset = MIN(directory->append_offset, i);
+            _update_page_zone(directory, i, page, 0);
 
             // We reload local index and update size2delete
             page_offset = 0;
@@ -171,7 +372,7 @@ int DRM_find_content(
     unsigned char* data_pointer = data;
     for (; pages4search > 0 && temp_data_size > 0 && page_offset < directory->header->page_count; pages4search--) {
         // We load current page to memory.
-        page_t* page = PGM_load_page(directory->header->name, directory->page_names[page_offset]);
+        page_t* page = _load_page(directory, page_offset);
         if (!page) return -2;
 
         // We search part of data in this page, save index and unload page.
@@ -242,7 +443,66 @@ int DRM_cleanup_pages(directory_t* directory) {
     }
 
     ARRAY_SOFT_FREE(temp_names, temp_count);
+    _update_directory_zone(directory);
     return 1;
 #endif
     return -2;
 }
+
+int DRM_set_zone_layout(directory_t* __restrict directory, zone_layout_t* __restrict layout) {
+    if (memcmp(&directory->zone_layout, layout, sizeof(zone_layout_t)) == 0) return 0;
+    memcpy(&directory->zone_layout, layout, sizeof(zone_layout_t));
+    memset(directory->zones, 0, sizeof(directory->zones));
+    memset(directory->blooms, 0, sizeof(directory->blooms));
+    _update_directory_zone(directory);
+    return 1;
+}
+
+int DRM_set_page_layout(directory_t* __restrict directory, page_layout_t* __restrict layout) {
+    if (memcmp(&directory->page_layout, layout, sizeof(page_layout_t)) == 0) return 0;
+    memcpy(&directory->page_layout, layout, sizeof(page_layout_t));
+    return 1;
+}
+
+int DRM_get_page_columns(
+    directory_t* __restrict directory, int index, unsigned char* __restrict columns, unsigned char* __restrict buffer
+) {
+    if (index < 0 || index >= directory->header->page_count) return -1;
+    page_t* page = _load_page(directory, index);
+    if (!page) return -1;
+
+    int status = -1;
+    if (THR_require_lock(&page->lock, omp_get_thread_num()) == 1) {
+        status = PGM_get_columns(page, columns, buffer);
+        THR_release_lock(&page->lock, omp_get_thread_num());
+    }
+
+    PGM_flush_page(page);
+    return status;
+}
+
+int DRM_get_bloom_key(unsigned char* __restrict data, size_t data_size, int is_numeric, unsigned char* __restrict key) {
+    char value[BLOOM_KEY_SIZE] = { 0 };
+    memcpy(value, data, MIN(data_size, BLOOM_KEY_SIZE - 1));
+    if (is_numeric) {
+        int int_value = atoi(value);
+        memcpy(key, &int_value, sizeof(int));
+        return sizeof(int);
+    }
+
+    char* start = value + strspn(value, " ");
+    int key_size = strlen(start);
+    memcpy(key, start, key_size);
+    return key_size;
+}
+
+int DRM_bloom_may_contain(unsigned char* __restrict bloom, int column, unsigned char* __restrict key, int key_size) {
+    unsigned int hash = _hash_bloom_key(column, key, key_size);
+    unsigned int step = (hash >> 17) | (hash << 15) | 1;
+    for (int i = 0; i < BLOOM_HASHES; i++, hash += step) {
+        unsigned int bit = hash % (PAGE_BLOOM_SIZE * 8);
+        if (!(bloom[bit / 8] & (1 << (bit % 8)))) return 0;
+    }
+
+    return 1;
+}
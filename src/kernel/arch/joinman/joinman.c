@@ -0,0 +1,272 @@
+#include "../../include/joinman.h"
+
+
+#pragma region [Keys]
+
+    static int _get_key(joiner_t* joiner, unsigned char* data, int data_size, unsigned char* key) {
+        if (joiner->flags & JOIN_NUMERIC_KEY) {
+            long long value = strntoll((char*)data, data_size);
+            memcpy(key, &value, sizeof(long long));
+            return sizeof(long long);
+        }
+
+        if (joiner->flags & JOIN_BINARY_KEY) {
+            long long value = 0;
+            if (data_size == sizeof(int32_t)) {
+                int32_t value32 = 0;
+                memcpy(&value32, data, sizeof(int32_t));
+                value = value32;
+            }
+            else memcpy(&value, data, sizeof(long long));
+
+            memcpy(key, &value, sizeof(long long));
+            return sizeof(long long);
+        }
+
+        // String keys compared without padding spaces, because columns can have different size.
+        // Numeric keys parsed from whole column, string keys limited by key buffer.
+        int start = 0, end = MIN(data_size, JOIN_KEY_SIZE);
+        while (start < end && data[start] == ' ') start++;
+        while (end > start && data[end - 1] == ' ') end--;
+        memcpy(key, data + start, end - start);
+        return end - start;
+    }
+
+    static unsigned int _hash_key(unsigned char* key, int key_size) {
+        unsigned int hash = 2166136261u;
+        for (int i = 0; i < key_size; i++) {
+            hash ^= key[i];
+            hash *= 16777619u;
+        }
+
+        return hash;
+    }
+
+#pragma endregion
+
+#pragma region [Hash table]
+
+    static int _allocate_table(joiner_t* joiner, size_t capacity) {
+        unsigned char* buffer = (unsigned char*)realloc(joiner->buffer, capacity * joiner->build.row_size);
+        if (!buffer) return -1;
+        joiner->buffer = buffer;
+
+        join_entry_t* entries = (join_entry_t*)realloc(joiner->entries, capacity * sizeof(join_entry_t));
+        if (!entries) return -1;
+        joiner->entries = entries;
+
+        size_t bucket_count = 1;
+        while (bucket_count < capacity) bucket_count <<= 1;
+
+        int* buckets = (int*)realloc(joiner->buckets, bucket_count * sizeof(int));
+        if (!buckets) return -1;
+        joiner->buckets = buckets;
+        joiner->bucket_count = bucket_count;
+        joiner->rows_capacity = capacity;
+
+        // Rebuild chains for rows, that already in table
+        memset(joiner->buckets, 0xFF, bucket_count * sizeof(int));
+        for (size_t i = 0; i < joiner->rows_count; i++) {
+            size_t bucket = (joiner->entries[i].hash / JOIN_PARTITIONS) & (bucket_count - 1);
+            joiner->entries[i].next = joiner->buckets[bucket];
+            joiner->buckets[bucket] = i;
+        }
+
+        return 1;
+    }
+
+    static void _clear_table(joiner_t* joiner) {
+        joiner->rows_count = 0;
+        memset(joiner->buckets, 0xFF, joiner->bucket_count * sizeof(int));
+    }
+
+    static void _insert_row(joiner_t* joiner, unsigned char* row, unsigned int hash) {
+        size_t index = joiner->rows_count++;
+        memcpy(joiner->buffer + index * joiner->build.row_size, row, joiner->build.row_size);
+
+        // Low bits of hash used for partition, that's why bucket takes next bits
+        size_t bucket = (hash / JOIN_PARTITIONS) & (joiner->bucket_count - 1);
+        joiner->entries[index].hash = hash;
+        joiner->entries[index].next = joiner->buckets[bucket];
+        joiner->buckets[bucket] = index;
+    }
+
+    static int _probe_table(
+        joiner_t* joiner, unsigned char* row, unsigned char* key, int key_size, unsigned int hash,
+        int (*output)(void*, unsigned char*, unsigned char*), void* ctx
+    ) {
+        size_t bucket = (hash / JOIN_PARTITIONS) & (joiner->bucket_count - 1);
+        for (int i = joiner->buckets[bucket]; i != -1; i = joiner->entries[i].next) {
+            if (joiner->entries[i].hash != hash) continue;
+
+            unsigned char* build_row = joiner->buffer + i * joiner->build.row_size;
+            unsigned char build_key[JOIN_KEY_SIZE];
+            int build_key_size = _get_key(joiner, build_row + joiner->build.offset, joiner->build.size, build_key);
+            if (build_key_size != key_size || memcmp(build_key, key, key_size) != 0) continue;
+            if (output(ctx, build_row, row) != 1) return 0;
+        }
+
+        return 1;
+    }
+
+#pragma endregion
+
+#pragma region [Partitions]
+
+    static int _spill_build_rows(joiner_t* joiner) {
+        print_debug("Join build side exceed memory budget. Partitioning [%i] rows", (int)joiner->rows_count);
+        joiner->is_partitioned = 1;
+        for (size_t i = 0; i < joiner->rows_count; i++) {
+            int partition = joiner->entries[i].hash % JOIN_PARTITIONS;
+            unsigned char* row = joiner->buffer + i * joiner->build.row_size;
+            if (SRT_append_run_row(&joiner->build_partitions[partition], &joiner->build_pages[partition], row, joiner->build.row_size) != 1) {
+                return -1;
+            }
+        }
+
+        _clear_table(joiner);
+        return 1;
+    }
+
+    static int _load_build_partition(joiner_t* joiner, sort_run_t* partition, unsigned char* page_buffer) {
+        int rows_per_page = PAGE_CONTENT_SIZE / joiner->build.row_size;
+        size_t rows_left = partition->rows_count;
+        while (rows_left > 0) {
+            if (SRT_read_run_page(partition, page_buffer) != 1) return -1;
+            for (int i = 0; i < rows_per_page && rows_left > 0; i++, rows_left--) {
+                // Partition can be larger then budget with bad key distribution. We can't split it by same hash.
+                if (joiner->rows_count >= joiner->rows_capacity) {
+                    print_warn("Join partition exceed memory budget. Capacity increased to [%i] rows", (int)joiner->rows_capacity * 2);
+                    if (_allocate_table(joiner, joiner->rows_capacity * 2) != 1) return -1;
+                }
+
+                unsigned char* row = page_buffer + i * joiner->build.row_size;
+                unsigned char key[JOIN_KEY_SIZE];
+                int key_size = _get_key(joiner, row + joiner->build.offset, joiner->build.size, key);
+                _insert_row(joiner, row, _hash_key(key, key_size));
+            }
+        }
+
+        return 1;
+    }
+
+    static int _probe_partition(
+        joiner_t* joiner, sort_run_t* partition, unsigned char* page_buffer,
+        int (*output)(void*, unsigned char*, unsigned char*), void* ctx
+    ) {
+        int rows_per_page = PAGE_CONTENT_SIZE / joiner->probe.row_size;
+        size_t rows_left = partition->rows_count;
+        while (rows_left > 0) {
+            if (SRT_read_run_page(partition, page_buffer) != 1) return -1;
+            for (int i = 0; i < rows_per_page && rows_left > 0; i++, rows_left--) {
+                unsigned char* row = page_buffer + i * joiner->probe.row_size;
+                unsigned char key[JOIN_KEY_SIZE];
+                int key_size = _get_key(joiner, row + joiner->probe.offset, joiner->probe.size, key);
+                if (_probe_table(joiner, row, key, key_size, _hash_key(key, key_size), output, ctx) != 1) return 0;
+            }
+        }
+
+        return 1;
+    }
+
+#pragma endregion
+
+
+joiner_t* JNM_create_joiner(
+    size_t build_row_size, int build_key_offset, int build_key_size,
+    size_t probe_row_size, int probe_key_offset, int probe_key_size, unsigned char flags
+) {
+    if (build_row_size == 0 || build_row_size > PAGE_CONTENT_SIZE) return NULL;
+    if (probe_row_size == 0 || probe_row_size > PAGE_CONTENT_SIZE) return NULL;
+
+    joiner_t* joiner = (joiner_t*)malloc(sizeof(joiner_t));
+    if (!joiner) return NULL;
+    memset(joiner, 0, sizeof(joiner_t));
+
+    joiner->build.row_size = build_row_size;
+    joiner->build.offset   = build_key_offset;
+    joiner->build.size     = build_key_size;
+    joiner->probe.row_size = probe_row_size;
+    joiner->probe.offset   = probe_key_offset;
+    joiner->probe.size     = probe_key_size;
+    joiner->flags          = flags;
+
+    if (_allocate_table(joiner, MAX(JOIN_BUFFER_SIZE / build_row_size, 1)) != 1) {
+        JNM_free_joiner(joiner);
+        return NULL;
+    }
+
+    return joiner;
+}
+
+int JNM_add_build_row(joiner_t* __restrict joiner, unsigned char* __restrict row) {
+    unsigned char key[JOIN_KEY_SIZE];
+    int key_size = _get_key(joiner, row + joiner->build.offset, joiner->build.size, key);
+    unsigned int hash = _hash_key(key, key_size);
+
+    if (!joiner->is_partitioned && joiner->rows_count >= joiner->rows_capacity) {
+        if (_spill_build_rows(joiner) != 1) return -1;
+    }
+
+    if (joiner->is_partitioned) {
+        int partition = hash % JOIN_PARTITIONS;
+        return SRT_append_run_row(&joiner->build_partitions[partition], &joiner->build_pages[partition], row, joiner->build.row_size);
+    }
+
+    _insert_row(joiner, row, hash);
+    return 1;
+}
+
+int JNM_probe_row(joiner_t* joiner, unsigned char* row, int (*output)(void*, unsigned char*, unsigned char*), void* ctx) {
+    unsigned char key[JOIN_KEY_SIZE];
+    int key_size = _get_key(joiner, row + joiner->probe.offset, joiner->probe.size, key);
+    unsigned int hash = _hash_key(key, key_size);
+
+    if (joiner->is_partitioned) {
+        int partition = hash % JOIN_PARTITIONS;
+        return SRT_append_run_row(&joiner->probe_partitions[partition], &joiner->probe_pages[partition], row, joiner->probe.row_size);
+    }
+
+    return _probe_table(joiner, row, key, key_size, hash, output, ctx);
+}
+
+int JNM_finish(joiner_t* joiner, int (*output)(void*, unsigned char*, unsigned char*), void* ctx) {
+    if (!joiner->is_partitioned) return 1;
+
+    for (int i = 0; i < JOIN_PARTITIONS; i++) {
+        if (SRT_close_run_page(&joiner->build_pages[i]) != 1) return -1;
+        if (SRT_close_run_page(&joiner->probe_pages[i]) != 1) return -1;
+    }
+
+    unsigned char* page_buffer = (unsigned char*)malloc(PAGE_CONTENT_SIZE);
+    if (!page_buffer) return -1;
+
+    int status = 1;
+    for (int i = 0; i < JOIN_PARTITIONS && status == 1; i++) {
+        _clear_table(joiner);
+        status = _load_build_partition(joiner, &joiner->build_partitions[i], page_buffer);
+        if (status == 1) status = _probe_partition(joiner, &joiner->probe_partitions[i], page_buffer, output, ctx);
+
+        SRT_free_run(&joiner->build_partitions[i]);
+        SRT_free_run(&joiner->probe_partitions[i]);
+    }
+
+    free(page_buffer);
+    return status == -1 ? -1 : 1;
+}
+
+int JNM_free_joiner(joiner_t* joiner) {
+    if (!joiner) return -1;
+    for (int i = 0; i < JOIN_PARTITIONS; i++) {
+        SRT_close_run_page(&joiner->build_pages[i]);
+        SRT_close_run_page(&joiner->probe_pages[i]);
+        SRT_free_run(&joiner->build_partitions[i]);
+        SRT_free_run(&joiner->probe_partitions[i]);
+    }
+
+    SOFT_FREE(joiner->buffer);
+    SOFT_FREE(joiner->entries);
+    SOFT_FREE(joiner->buckets);
+    SOFT_FREE(joiner);
+    return 1;
+}
@@ -1,19 +1,691 @@
 #include "../../include/module.h"
 
 
+static module_t _modules[MODULE_CACHE_SIZE];
+static int _modules_count = 0;
+
+// Results cache allocated with first deterministic call
+static module_memo_t* _memo = NULL;
+static module_memo_stats_t _memo_stats = { .capacity = MODULE_MEMO_SIZE / sizeof(module_memo_t) };
+
+
+static module_t* _get_module(char* module_name) {
+    module_t* module = NULL;
+    #pragma omp critical (module_load)
+    {
+        for (int i = 0; i < _modules_count; i++) {
+            if (strncmp(_modules[i].name, module_name, MODULE_NAME_SIZE) == 0) {
+                module = &_modules[i];
+                break;
+            }
+        }
+
+        if (!module && _modules_count < MODULE_CACHE_SIZE) {
+            module = &_modules[_modules_count++];
+            memset(module, 0, sizeof(module_t));
+            strncpy(module->name, module_name, MODULE_NAME_SIZE);
+
+#ifndef NO_SHARED_MODULES
+            char module_path[DEFAULT_PATH_SIZE] = { 0 };
+            char shared_path[DEFAULT_PATH_SIZE + 2] = { 0 };
+            get_load_path(module_name, MODULE_NAME_SIZE, module_path, MODULE_BASE_PATH, MODULE_SHARED_EXTENSION);
+            snprintf(shared_path, sizeof(shared_path), "./%s", module_path);
+
+            if (file_exists(shared_path, NULL, NULL)) {
+                void* handle = dlopen(shared_path, RTLD_NOW | RTLD_LOCAL);
+                if (!handle) { print_warn("Shared module [%s] can't be loaded: %s", shared_path, dlerror()); }
+                else {
+                    module_init_t init = (module_init_t)dlsym(handle, MODULE_INIT);
+                    module->invoke = (module_invoke_t)dlsym(handle, MODULE_INVOKE);
+                    module->invoke_batch = (module_batch_t)dlsym(handle, MODULE_BATCH);
+                    module->free   = (module_free_t)dlsym(handle, MODULE_FREE);
+                    module_flags_t flags = (module_flags_t)dlsym(handle, MODULE_FLAGS);
+                    module->flags  = flags ? (unsigned char)flags() : 0;
+                    if (!module->invoke || (init && init() != MODULE_SUCCESS)) {
+                        print_warn("Shared module [%s] has wrong entry points", shared_path);
+                        module->invoke = NULL;
+                        module->invoke_batch = NULL;
+                        module->free   = NULL;
+                        module->flags  = 0;
+                        dlclose(handle);
+                    }
+                    else {
+                        print_log("Shared module [%s] loaded with flags [%i]", shared_path, module->flags);
+                        module->handle = handle;
+                    }
+                }
+            }
+#endif
+        }
+    }
+
+    return module;
+}
+
+static int _get_launch_path(char* __restrict module_name, char* __restrict launch_path, size_t path_size) {
+    // Module checked by same path, that will be launched
+    char module_path[DEFAULT_PATH_SIZE] = { 0 };
+    get_load_path(module_name, MODULE_NAME_SIZE, module_path, MODULE_BASE_PATH, MODULE_EXTENSION);
+    snprintf(launch_path, path_size, "./%s", module_path);
+    return file_exists(launch_path, NULL, NULL);
+}
+
+static int _place_answer(char* __restrict result, unsigned char* __restrict buffer, size_t buffer_size) {
+    size_t result_len = strlen(result);
+    size_t offset = buffer_size > result_len ? buffer_size - result_len : 0;
+    memcpy(buffer + offset, result, MIN(buffer_size, result_len));
+    return 1;
+}
+
+#ifndef NO_SHARED_MODULES
+
+#pragma region [Memo]
+
+    static unsigned int _memo_hash(module_t* __restrict module, char* __restrict args) {
+        unsigned int hash = 2166136261U;
+        for (unsigned char* name = (unsigned char*)module->name; *name; name++) hash = (hash ^ *name) * 16777619U;
+        for (unsigned char* arg = (unsigned char*)args; *arg; arg++) hash = (hash ^ *arg) * 16777619U;
+        return hash;
+    }
+
+    static int _is_memo(module_t* __restrict module, char* __restrict args) {
+        return (module->flags & MODULE_DETERMINISTIC) && _memo_stats.capacity > 0 && strlen(args) < MODULE_MEMO_ARGS;
+    }
+
+    static int _memo_get(module_t* __restrict module, char* __restrict args, unsigned int hash, char* __restrict result) {
+        int found = 0;
+        #pragma omp critical (module_memo)
+        {
+            module_memo_t* entry = _memo ? &_memo[hash % _memo_stats.capacity] : NULL;
+            if (entry && entry->module == module && entry->hash == hash && strcmp(entry->args, args) == 0) {
+                memcpy(result, entry->result, MODULE_ANSWER_SIZE);
+                _memo_stats.hits++;
+                found = 1;
+            }
+            else _memo_stats.misses++;
+        }
+
+        return found;
+    }
+
+    static int _memo_put(module_t* __restrict module, char* __restrict args, unsigned int hash, char* __restrict result) {
+        #pragma omp critical (module_memo)
+        {
+            if (!_memo) {
+                _memo = (module_memo_t*)malloc(_memo_stats.capacity * sizeof(module_memo_t));
+                if (_memo) memset(_memo, 0, _memo_stats.capacity * sizeof(module_memo_t));
+            }
+
+            if (_memo) {
+                module_memo_t* entry = &_memo[hash % _memo_stats.capacity];
+                if (!entry->module) _memo_stats.entries++;
+                entry->hash   = hash;
+                entry->module = module;
+                strncpy(entry->args, args, MODULE_MEMO_ARGS - 1);
+                memcpy(entry->result, result, MODULE_ANSWER_SIZE);
+            }
+        }
+
+        return 1;
+    }
+
+#pragma endregion
+
+#pragma region [Shared]
+
+    /*
+    Arguments splitted by spaces in same way, as shell does for executable module.
+    Line used as storage for arguments.
+    */
+    static int _split_args(module_t* __restrict module, char* __restrict args, char* __restrict line, char* argv[]) {
+        char* save_pointer = NULL;
+        int argc = 1;
+        argv[0] = module->name;
+
+        strncpy(line, args, MODULE_ARGS_SIZE - 1);
+        for (char* token = strtok_r(line, " ", &save_pointer); token && argc < MODULE_MAX_ARGS; token = strtok_r(NULL, " ", &save_pointer)) {
+            argv[argc++] = token;
+        }
+
+        return argc;
+    }
+
+    static int _launch_shared_batch(module_t* __restrict module, char* args[], int count, unsigned char* buffers[], size_t buffer_size) {
+        char lines[MODULE_BATCH_SIZE][MODULE_ARGS_SIZE];
+        char* argvs_data[MODULE_BATCH_SIZE][MODULE_MAX_ARGS + 1];
+        char** argvs[MODULE_BATCH_SIZE];
+        int argcs[MODULE_BATCH_SIZE];
+        int codes[MODULE_BATCH_SIZE];
+        int pending[MODULE_BATCH_SIZE];
+        unsigned int hashes[MODULE_BATCH_SIZE];
+        char results[MODULE_BATCH_SIZE][MODULE_ANSWER_SIZE];
+
+        for (int start = 0; start < count; start += MODULE_BATCH_SIZE) {
+            // Deterministic module answers taken from cache, other tuples invoked together
+            int pending_count = 0;
+            for (int i = start; i < MIN(count, start + MODULE_BATCH_SIZE); i++) {
+                int is_memo = _is_memo(module, args[i]);
+                unsigned int hash = is_memo ? _memo_hash(module, args[i]) : 0;
+                if (is_memo && _memo_get(module, args[i], hash, results[pending_count])) {
+                    QST_add(module_hits, 1);
+                    _place_answer(results[pending_count], buffers[i], buffer_size);
+                    continue;
+                }
+
+                memset(lines[pending_count], 0, MODULE_ARGS_SIZE);
+                memset(results[pending_count], 0, MODULE_ANSWER_SIZE);
+                argvs[pending_count]  = argvs_data[pending_count];
+                argcs[pending_count]  = _split_args(module, args[i], lines[pending_count], argvs[pending_count]);
+                hashes[pending_count] = hash;
+                pending[pending_count++] = i;
+            }
+
+            if (pending_count == 0) continue;
+            if (module->invoke_batch) module->invoke_batch(pending_count, argcs, argvs, (char*)results, MODULE_ANSWER_SIZE, codes);
+            else {
+                for (int i = 0; i < pending_count; i++) codes[i] = module->invoke(argcs[i], argvs[i], results[i], MODULE_ANSWER_SIZE);
+            }
+
+            QST_add(module_calls, pending_count);
+            for (int i = 0; i < pending_count; i++) {
+                results[i][MODULE_ANSWER_SIZE - 1] = '\0';
+                print_log("Module [%s] exit code: [%d]", module->name, codes[i]);
+                if (codes[i] != MODULE_SUCCESS) continue;
+                if (_is_memo(module, args[pending[i]])) _memo_put(module, args[pending[i]], hashes[i], results[i]);
+                _place_answer(results[i], buffers[pending[i]], buffer_size);
+            }
+        }
+
+        return 1;
+    }
+
+#pragma endregion
+
+#endif
+
+#ifndef _WIN32
+
+#pragma region [Process]
+
+    static int _read_full(int fd, void* buffer, size_t size) {
+        size_t readed = 0;
+        while (readed < size) {
+            // Hung module shouldn't block session forever
+            struct pollfd descriptor = { .fd = fd, .events = POLLIN };
+            if (poll(&descriptor, 1, MODULE_ANSWER_TIMEOUT) <= 0) return 0;
+
+            ssize_t part = read(fd, (unsigned char*)buffer + readed, size - readed);
+            if (part <= 0) return 0;
+            readed += part;
+        }
+
+        return 1;
+    }
+
+    /*
+    Create pipe, that closed in launched programs. Pipes of worker shouldn't leak to other modules,
+    otherwise worker never gets end of input.
+    */
+    static int _create_pipe(int fds[2]) {
+#ifdef __linux__
+        return pipe2(fds, O_CLOEXEC);
+#else
+        // Without pipe2 flag set after creation, and module launched by other session between calls can inherit pipe
+        if (pipe(fds) != 0) return -1;
+        fcntl(fds[0], F_SETFD, FD_CLOEXEC);
+        fcntl(fds[1], F_SETFD, FD_CLOEXEC);
+        return 0;
+#endif
+    }
+
+    /*
+    Start executable module with MODULE_BATCH_FLAG. Module reads requests from input and writes answers to output.
+    */
+    static pid_t _start_process(char* __restrict launch_path, int* __restrict input, int* __restrict output) {
+        int requests[2], answers[2];
+        if (_create_pipe(requests) != 0) return -1;
+        if (_create_pipe(answers) != 0) {
+            close(requests[0]);
+            close(requests[1]);
+            return -1;
+        }
+
+        pid_t pid = fork();
+        if (pid < 0) {
+            close(requests[0]); close(requests[1]);
+            close(answers[0]); close(answers[1]);
+            return -1;
+        }
+
+        if (pid == 0) {
+            dup2(requests[0], STDIN_FILENO);
+            dup2(answers[1], STDOUT_FILENO);
+            execl(launch_path, launch_path, MODULE_BATCH_FLAG, (char*)NULL);
+            _exit(127);
+        }
+
+        close(requests[0]);
+        close(answers[1]);
+        *input = requests[1];
+        *output = answers[0];
+        return pid;
+    }
+
+    /*
+    Send tuples to module process and read answers.
+    Return count of answered tuples.
+    */
+    static int _exchange(
+        int input, int output, char* args[], int count, int codes[], char results[][MODULE_ANSWER_SIZE], int close_input
+    ) {
+        // Requests and answers of one batch fit into pipe buffers, that's why we write all before reading
+        int is_written = 1;
+        for (int i = 0; i < count && is_written; i++) {
+            unsigned int length = strlen(args[i]);
+            is_written = write(input, &length, sizeof(length)) == sizeof(length) && write(input, args[i], length) == (ssize_t)length;
+        }
+
+        if (close_input) close(input);
+        if (!is_written) return 0;
+
+        int answered = 0;
+        for (; answered < count; answered++) {
+            unsigned int length = 0;
+            if (!_read_full(output, &codes[answered], sizeof(int)) || !_read_full(output, &length, sizeof(length))) break;
+            if (length >= MODULE_ANSWER_SIZE || !_read_full(output, results[answered], length)) break;
+        }
+
+        QST_add(module_calls, 1);
+        return answered;
+    }
+
+    static int _stop_process(pid_t pid, int input, int output, int force) {
+        if (input >= 0) close(input);
+        if (output >= 0) close(output);
+        if (force) kill(pid, SIGKILL);
+
+        int status = 0;
+        waitpid(pid, &status, 0);
+        return WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+    }
+
+    /*
+    Launch executable module once for tuples with framed protocol.
+    Answers placed only if module served all tuples and exited with success code.
+    */
+    static int _launch_process_batch(char* launch_path, char* args[], int count, unsigned char* buffers[], size_t buffer_size) {
+        int input = -1, output = -1;
+        pid_t pid = _start_process(launch_path, &input, &output);
+        if (pid < 0) return -1;
+
+        int codes[MODULE_BATCH_SIZE] = { 0 };
+        char results[MODULE_BATCH_SIZE][MODULE_ANSWER_SIZE];
+        memset(results, 0, sizeof(results));
+
+        int answered = _exchange(input, output, args, count, codes, results, 1);
+        if (_stop_process(pid, -1, output, answered != count) != MODULE_SUCCESS || answered != count) return -1;
+
+        for (int i = 0; i < count; i++) {
+            if (codes[i] == MODULE_SUCCESS) _place_answer(results[i], buffers[i], buffer_size);
+        }
+
+        return 1;
+    }
+
+#if MODULE_WORKERS > 0
+    /*
+    Take free worker of module. Worker process started, if it isn't alive.
+    Return NULL if all workers busy.
+    */
+    static module_worker_t* _acquire_worker(module_t* __restrict module, char* __restrict launch_path) {
+        module_worker_t* worker = NULL;
+        #pragma omp critical (module_workers)
+        {
+            for (int i = 0; i < MODULE_WORKERS; i++) {
+                if (!module->workers[i].busy) {
+                    worker = &module->workers[i];
+                    worker->busy = 1;
+                    break;
+                }
+            }
+        }
+
+        if (worker && !worker->pid) {
+            pid_t pid = _start_process(launch_path, &worker->input, &worker->output);
+            if (pid < 0) {
+                worker->busy = 0;
+                return NULL;
+            }
+
+            print_log("Worker [%i] of module [%s] started", pid, module->name);
+            worker->pid = pid;
+        }
+
+        return worker;
+    }
+
+    static int _release_worker(module_worker_t* worker, int is_broken) {
+        if (is_broken) {
+            _stop_process(worker->pid, worker->input, worker->output, 1);
+            worker->pid = 0;
+            worker->served = 0;
+        }
+
+        #pragma omp critical (module_workers)
+        worker->busy = 0;
+        return 1;
+    }
+
+    /*
+    Exchange tuples with persistent worker of module.
+    Return -1 if worker can't serve tuples. Broken worker will be started again with next call.
+    */
+    static int _launch_worker_batch(
+        module_t* __restrict module, char* __restrict launch_path, char* args[], int count, unsigned char* buffers[], size_t buffer_size
+    ) {
+        if (module->flags & (MODULE_NO_BATCH | MODULE_NO_WORKER)) return -1;
+        module_worker_t* worker = _acquire_worker(module, launch_path);
+        if (!worker) return -1;
+
+        int codes[MODULE_BATCH_SIZE] = { 0 };
+        char results[MODULE_BATCH_SIZE][MODULE_ANSWER_SIZE];
+        memset(results, 0, sizeof(results));
+
+        int answered = _exchange(worker->input, worker->output, args, count, codes, results, 0);
+        if (answered != count) {
+            // New worker, that answered nothing, can't be kept alive (old module or module without answer flush)
+            if (answered == 0 && !worker->served) module->flags |= MODULE_NO_WORKER;
+            print_warn("Worker [%i] of module [%s] answered %i of %i tuples and restarted", worker->pid, module->name, answered, count);
+            _release_worker(worker, 1);
+            return -1;
+        }
+
+        worker->served = 1;
+        _release_worker(worker, 0);
+        for (int i = 0; i < count; i++) {
+            if (codes[i] == MODULE_SUCCESS) _place_answer(results[i], buffers[i], buffer_size);
+        }
+
+        return 1;
+    }
+
+    static int _stop_workers(module_t* module) {
+        for (int i = 0; i < MODULE_WORKERS; i++) {
+            module_worker_t* worker = &module->workers[i];
+            if (!worker->pid) continue;
+
+            // Worker exits, when input closed
+            close(worker->input);
+            _stop_process(worker->pid, -1, worker->output, 0);
+            memset(worker, 0, sizeof(module_worker_t));
+        }
+
+        return 1;
+    }
+#endif
+
+#pragma endregion
+
+#endif
+
+#pragma region [Program]
+
+    static int _get_precedence(char operation) {
+        if (operation == '+' || operation == '-') return 9;
+        if (operation == '*' || operation == '/' || operation == '%') return 10;
+        if (operation == '^') return 11;
+        return 0;
+    }
+
+    static int _emit(module_program_t* __restrict program, int* __restrict depth, unsigned char opcode) {
+        if (program->count >= MODULE_PROGRAM_SIZE) return -1;
+        if (opcode == MODULE_OP_CONST || opcode == MODULE_OP_COLUMN) {
+            if (++(*depth) > MODULE_STACK_SIZE) return -1;
+        }
+        else if (--(*depth) < 1) return -1;
+
+        program->code[program->count].opcode = opcode;
+        return program->count++;
+    }
+
+    static int _emit_operation(module_program_t* __restrict program, int* __restrict depth, char operation) {
+        switch (operation) {
+            case '+': return _emit(program, depth, MODULE_OP_ADD);
+            case '-': return _emit(program, depth, MODULE_OP_SUB);
+            case '*': return _emit(program, depth, MODULE_OP_MUL);
+            case '/': return _emit(program, depth, MODULE_OP_DIV);
+            case '%': return _emit(program, depth, MODULE_OP_MOD);
+            case '^': return _emit(program, depth, MODULE_OP_POW);
+        }
+
+        return -1;
+    }
+
+    static int _load_operand(module_instruction_t* __restrict instruction, unsigned char* __restrict row, long long* __restrict value) {
+        unsigned char* data = row + instruction->offset;
+        if (instruction->type == MODULE_OPERAND_I32) {
+            int value32 = 0;
+            memcpy(&value32, data, sizeof(int));
+            *value = value32;
+            return 1;
+        }
+
+        if (instruction->type == MODULE_OPERAND_I64) {
+            memcpy(value, data, sizeof(long long));
+            return 1;
+        }
+
+        // Text value accepted only as number, same as in substituted query of launched module
+        unsigned long long number = 0;
+        int digits = 0;
+        for (; digits < instruction->size && data[digits] != '\0'; digits++) {
+            if (!isdigit(data[digits])) return -1;
+            number = number * 10 + (data[digits] - '0');
+        }
+
+        *value = (long long)number;
+        return digits > 0 ? 1 : -1;
+    }
+
+    static int _power(long long base, long long exponent, long long* __restrict result) {
+        if (exponent < 0) {
+            if (base == 0) return -1;
+            *result = base == 1 ? 1 : (base == -1 ? (exponent % 2 ? -1 : 1) : 0);
+            return 1;
+        }
+
+        unsigned long long value = 1;
+        unsigned long long factor = (unsigned long long)base;
+        while (exponent > 0) {
+            if (exponent & 1) value *= factor;
+            factor *= factor;
+            exponent >>= 1;
+        }
+
+        *result = (long long)value;
+        return 1;
+    }
+
+    module_program_t* MDL_compile_program(
+        char* __restrict module_name, char* __restrict query, size_t query_size, module_operand_t* __restrict operands, int operands_count
+    ) {
+        if (strncmp(module_name, MODULE_INLINE_CALC, MODULE_NAME_SIZE) != 0) return NULL;
+        module_program_t* program = (module_program_t*)malloc(sizeof(module_program_t));
+        if (!program) return NULL;
+        memset(program, 0, sizeof(module_program_t));
+
+        // Shunting-yard. Operators stack keeps '(' as marker.
+        char operations[MODULE_PROGRAM_SIZE] = { 0 };
+        int operations_count = 0;
+        int depth = 0;
+        int expect_operand = 1;
+        int failed = 0;
+
+        size_t index = 0;
+        while (index < query_size && query[index] != '\0') {
+            char symbol = query[index];
+            if (symbol == ' ' || symbol == '\t') {
+                index++;
+                continue;
+            }
+
+            if (symbol == '(') {
+                if (!expect_operand || operations_count >= MODULE_PROGRAM_SIZE) break;
+                operations[operations_count++] = symbol;
+                index++;
+                continue;
+            }
+
+            if (symbol == ')') {
+                if (expect_operand) break;
+                while (!failed && operations_count > 0 && operations[operations_count - 1] != '(') {
+                    if (_emit_operation(program, &depth, operations[--operations_count]) < 0) failed = 1;
+                }
+
+                if (failed || operations_count == 0 || operations[operations_count - 1] != '(') break;
+                operations_count--;
+                index++;
+                continue;
+            }
+
+            if (_get_precedence(symbol)) {
+                if (expect_operand) break;
+                while (!failed && operations_count > 0 && operations[operations_count - 1] != '(') {
+                    char top = operations[operations_count - 1];
+                    if (_get_precedence(top) < _get_precedence(symbol)) break;
+                    if (_get_precedence(top) == _get_precedence(symbol) && symbol == '^') break;
+                    if (_emit_operation(program, &depth, top) < 0) failed = 1;
+                    operations_count--;
+                }
+
+                if (failed || operations_count >= MODULE_PROGRAM_SIZE) break;
+                operations[operations_count++] = symbol;
+                expect_operand = 1;
+                index++;
+                continue;
+            }
+
+            // Operand is number or column name, that ends with space, operator or parenthesis
+            if (!expect_operand) break;
+            size_t start = index;
+            int is_number = 1;
+            while (
+                index < query_size && query[index] != '\0' && query[index] != ' ' && query[index] != '\t' &&
+                query[index] != '(' && query[index] != ')' && !_get_precedence(query[index])
+            ) {
+                if (!isdigit(query[index])) is_number = 0;
+                index++;
+            }
+
+            size_t length = index - start;
+            int position = -1;
+            if (is_number) {
+                position = _emit(program, &depth, MODULE_OP_CONST);
+                if (position < 0) break;
+                unsigned long long number = 0;
+                for (size_t i = start; i < index; i++) number = number * 10 + (query[i] - '0');
+                program->code[position].value = (long long)number;
+            }
+            else {
+                for (int i = 0; i < operands_count; i++) {
+                    if (
+                        length > operands[i].name_size || strncmp(operands[i].name, query + start, length) != 0 ||
+                        (length < operands[i].name_size && operands[i].name[length] != '\0')
+                    ) continue;
+
+                    position = _emit(program, &depth, MODULE_OP_COLUMN);
+                    if (position < 0) break;
+                    program->code[position].type   = operands[i].type;
+                    program->code[position].size   = operands[i].size;
+                    program->code[position].offset = operands[i].offset;
+                    break;
+                }
+
+                if (position < 0) break;
+            }
+
+            expect_operand = 0;
+        }
+
+        int compiled = !failed && !expect_operand && (index >= query_size || query[index] == '\0');
+        while (compiled && operations_count > 0) {
+            char operation = operations[--operations_count];
+            if (operation == '(' || _emit_operation(program, &depth, operation) < 0) compiled = 0;
+        }
+
+        if (!compiled || depth != 1) {
+            free(program);
+            return NULL;
+        }
+
+        return program;
+    }
+
+    int MDL_execute_program(module_program_t* __restrict program, unsigned char* __restrict row, unsigned char* __restrict buffer, size_t buffer_size) {
+        long long stack[MODULE_STACK_SIZE] = { 0 };
+        int top = 0;
+
+        for (int i = 0; i < program->count; i++) {
+            module_instruction_t* instruction = &program->code[i];
+            if (instruction->opcode == MODULE_OP_CONST) {
+                stack[top++] = instruction->value;
+                continue;
+            }
+
+            if (instruction->opcode == MODULE_OP_COLUMN) {
+                if (_load_operand(instruction, row, &stack[top++]) < 0) return -1;
+                continue;
+            }
+
+            // Stack depth checked in compilation, that's why here always two operands
+            unsigned long long right = (unsigned long long)stack[--top];
+            unsigned long long left  = (unsigned long long)stack[top - 1];
+            switch (instruction->opcode) {
+                case MODULE_OP_ADD: stack[top - 1] = (long long)(left + right); break;
+                case MODULE_OP_SUB: stack[top - 1] = (long long)(left - right); break;
+                case MODULE_OP_MUL: stack[top - 1] = (long long)(left * right); break;
+                case MODULE_OP_DIV:
+                case MODULE_OP_MOD:
+                    if (right == 0 || ((long long)right == -1 && (long long)left == LLONG_MIN)) return -1;
+                    if (instruction->opcode == MODULE_OP_DIV) stack[top - 1] = (long long)left / (long long)right;
+                    else stack[top - 1] = (long long)left % (long long)right;
+                    break;
+                case MODULE_OP_POW:
+                    if (_power((long long)left, (long long)right, &stack[top - 1]) < 0) return -1;
+                    break;
+            }
+        }
+
+        char result[MODULE_ANSWER_SIZE] = { 0 };
+        snprintf(result, sizeof(result), "%lld", stack[0]);
+        memset(buffer, ' ', buffer_size);
+        _place_answer(result, buffer, buffer_size);
+        return 1;
+    }
+
+#pragma endregion
+
 int MDL_launch_module(char* module_name, char* args, unsigned char* buffer, size_t buffer_size) {
     memset(buffer, ' ', buffer_size);
-    char module_path[DEFAULT_PATH_SIZE] = { 0 };
-    char command[256] = { 0 };
-    char result[128] = { 0 };
+    char command[MODULE_ARGS_SIZE + DEFAULT_PATH_SIZE] = { 0 };
+    char result[MODULE_ANSWER_SIZE] = { 0 };
 
-    get_load_path(module_name, MODULE_NAME_SIZE, module_path, MODULE_BASE_PATH, MODULE_EXTENSION);
-    if (!file_exists(module_path, NULL, NULL)) {
+    module_t* module = _get_module(module_name);
+#ifndef NO_SHARED_MODULES
+    if (module && module->handle) return _launch_shared_batch(module, &args, 1, &buffer, buffer_size);
+#endif
+
+    char launch_path[DEFAULT_PATH_SIZE + 2] = { 0 };
+    if (!_get_launch_path(module_name, launch_path, sizeof(launch_path))) {
         print_warn("Module not found");
         return -1;
     }
 
-    snprintf(command, sizeof(command), "./%s %s", module_path, args);
+#if !defined(_WIN32) && MODULE_WORKERS > 0
+    if (module && _launch_worker_batch(module, launch_path, &args, 1, &buffer, buffer_size) == 1) return 1;
+#endif
+
+    snprintf(command, sizeof(command), "%s %s", launch_path, args);
     FILE* fp = popen(command, "r");
     if (fp == NULL) {
         print_error("Error executing command");
@@ -21,17 +693,94 @@ int MDL_launch_module(char* module_name, char* args, unsigned char* buffer, size
     }
 
     fgets(result, sizeof(result), fp);
+    QST_add(module_calls, 1);
 
     int status = pclose(fp);
     if (status == -1) print_error("Error closing pipe");
     else {
         int exit_code = WEXITSTATUS(status);
         print_log("Module [%s] exit code: [%d]", module_name, exit_code);
-        if (exit_code == 100) {
-            size_t result_len = strlen(result);
-            size_t offset = buffer_size > result_len ? buffer_size - result_len : 0;
-            memcpy(buffer + offset, result, MIN(buffer_size, result_len));
+        if (exit_code == MODULE_SUCCESS) _place_answer(result, buffer, buffer_size);
+    }
+
+    return 1;
+}
+
+int MDL_launch_batch(char* module_name, char* args[], int count, unsigned char* buffers[], size_t buffer_size) {
+    for (int i = 0; i < count; i++) memset(buffers[i], ' ', buffer_size);
+    module_t* module = _get_module(module_name);
+
+#ifndef NO_SHARED_MODULES
+    if (module && module->handle) return _launch_shared_batch(module, args, count, buffers, buffer_size);
+#endif
+
+    char launch_path[DEFAULT_PATH_SIZE + 2] = { 0 };
+    if (!_get_launch_path(module_name, launch_path, sizeof(launch_path))) {
+        print_warn("Module not found");
+        return -1;
+    }
+
+    int processed = 0;
+#ifndef _WIN32
+    while (module && !(module->flags & MODULE_NO_BATCH) && processed < count) {
+        int batch_size = MIN(count - processed, MODULE_BATCH_SIZE);
+#if MODULE_WORKERS > 0
+        if (_launch_worker_batch(module, launch_path, args + processed, batch_size, buffers + processed, buffer_size) == 1) {
+            processed += batch_size;
+            continue;
+        }
+#endif
+
+        if (_launch_process_batch(launch_path, args + processed, batch_size, buffers + processed, buffer_size) != 1) {
+            print_warn("Module [%s] don't support batch protocol", module->name);
+            module->flags |= MODULE_NO_BATCH;
+            break;
+        }
+
+        processed += batch_size;
+    }
+#endif
+
+    for (int i = processed; i < count; i++) MDL_launch_module(module_name, args[i], buffers[i], buffer_size);
+    return 1;
+}
+
+int MDL_get_memo_stats(module_memo_stats_t* stats) {
+    #pragma omp critical (module_memo)
+    memcpy(stats, &_memo_stats, sizeof(module_memo_stats_t));
+    return 1;
+}
+
+int MDL_init() {
+#ifndef _WIN32
+    signal(SIGPIPE, SIG_IGN);
+#endif
+    return 1;
+}
+
+int MDL_unload_modules() {
+    #pragma omp critical (module_memo)
+    {
+        SOFT_FREE(_memo);
+        _memo_stats.entries = 0;
+    }
+
+    #pragma omp critical (module_load)
+    {
+        for (int i = 0; i < _modules_count; i++) {
+#if !defined(_WIN32) && MODULE_WORKERS > 0
+            _stop_workers(&_modules[i]);
+#endif
+#ifndef NO_SHARED_MODULES
+            if (_modules[i].handle) {
+                if (_modules[i].free) _modules[i].free();
+                dlclose(_modules[i].handle);
+            }
+#endif
+            memset(&_modules[i], 0, sizeof(module_t));
         }
+
+        _modules_count = 0;
     }
 
     return 1;
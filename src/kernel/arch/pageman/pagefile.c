@@ -63,10 +63,28 @@ int PGM_save_page(page_t* page) {
                 // Write data to disk
                 status = 1;
                 page->header->checksum = page_cheksum;
+
+                // Content saved compressed only if codec gives gain
+                unsigned char* content = page->content;
+                unsigned char compressed[PAGE_CONTENT_SIZE];
+                page->header->codec = CDC_NONE;
+                page->header->content_size = PAGE_CONTENT_SIZE;
+                if (page->codec != CDC_NONE) {
+                    int compressed_size = CDC_compress(page->content, PAGE_CONTENT_SIZE, compressed, PAGE_CONTENT_SIZE - 1);
+                    if (compressed_size > 0) {
+                        content = compressed;
+                        page->header->codec = page->codec;
+                        page->header->content_size = compressed_size;
+                    }
+                }
+
                 if (pwrite(fd, page->header, sizeof(page_header_t), 0) != sizeof(page_header_t)) status = -2;
-                if (pwrite(fd, page->content, PAGE_CONTENT_SIZE, sizeof(page_header_t)) != PAGE_CONTENT_SIZE) status = -3;
+                if (pwrite(fd, content, page->header->content_size, sizeof(page_header_t)) != page->header->content_size) status = -3;
                 fsync(fd);
                 close(fd);
+
+                MTR_add(MTR_PAGE_SAVES, 1);
+                MTR_add(MTR_FSYNCS, 1);
             }
         }
     }
@@ -84,9 +102,11 @@ page_t* PGM_load_page(char* base_path, char* name) {
     page_t* loaded_page = (page_t*)CHC_find_entry(name, base_path, PAGE_CACHE);
     if (loaded_page != NULL) {
         print_io("Loading page [%s] from GCT", load_path);
+        QST_add(page_hits, 1);
         return loaded_page;
     }
 
+    unsigned long long load_start = QST_time();
     #pragma omp critical (page_load)
     {
         // Open file page
@@ -108,26 +128,52 @@ page_t* PGM_load_page(char* base_path, char* name) {
                 } else {
                     // Allocate memory for page structure
                     page_t* page = (page_t*)malloc(sizeof(page_t));
-                    if (!page) free(header);
+                    if (!page) {
+                        free(header);
+                        close(fd);
+                    }
                     else {
                         memset(page->content, PAGE_EMPTY, PAGE_CONTENT_SIZE);
-                        pread(fd, page->content, PAGE_CONTENT_SIZE, sizeof(page_header_t));
-                        close(fd);
+                        int content_size = -1;
+                        if (header->codec == CDC_NONE) content_size = pread(fd, page->content, PAGE_CONTENT_SIZE, sizeof(page_header_t));
+                        else if (header->content_size <= PAGE_CONTENT_SIZE) {
+                            unsigned char compressed[PAGE_CONTENT_SIZE];
+                            int compressed_size = pread(fd, compressed, header->content_size, sizeof(page_header_t));
+                            if (compressed_size == (int)header->content_size) {
+                                content_size = CDC_decompress(compressed, compressed_size, page->content, PAGE_CONTENT_SIZE);
+                            }
+                        }
 
-                        page->lock   = THR_create_lock();
-                        page->header = header;
-                        loaded_page  = page;
-                        page->append_offset = -1;
+                        close(fd);
 
-                        CHC_add_entry(
-                            loaded_page, loaded_page->header->name, base_path, PAGE_CACHE, (void*)PGM_free_page, (void*)PGM_save_page
-                        );
+                        // Partly loaded page can't be used, because it will be saved over original
+                        if (content_size != PAGE_CONTENT_SIZE) {
+                            print_error("Page [%s] content can't be loaded", load_path);
+                            free(page);
+                            free(header);
+                        }
+                        else {
+                            page->lock   = THR_create_lock();
+                            page->header = header;
+                            page->layout = NULL;
+                            page->codec  = header->codec;
+                            loaded_page  = page;
+                            page->append_offset = -1;
+
+                            CHC_add_entry(
+                                loaded_page, loaded_page->header->name, base_path, PAGE_CACHE, (void*)PGM_free_page, (void*)PGM_save_page
+                            );
+                        }
                     }
                 }
             }
         }
     }
 
+    if (!loaded_page) return NULL;
+    QST_add(page_loads, 1);
+    QST_add(load_time, QST_time() - load_start);
+    MTR_add(MTR_PAGE_LOADS, 1);
     loaded_page->base_path = (char*)malloc(strlen(base_path) + 1);
     if (!loaded_page->base_path) {
         PGM_free_page(loaded_page);
@@ -155,14 +201,14 @@ int PGM_free_page(page_t* page) {
 
 unsigned int PGM_get_checksum(page_t* page) {
     if (!page) return 0;
-    unsigned int prev_checksum = page->header->checksum;
-    page->header->checksum = 0;
-
-    unsigned int checksum = 0;
-    if (page->header != NULL)
-        checksum = crc32(checksum, (const unsigned char*)page->header, sizeof(page_header_t));
-
-    page->header->checksum = prev_checksum;
+    // Codec fields set during save, that's why they don't take part in checksum
+    page_header_t header;
+    memcpy(&header, page->header, sizeof(page_header_t));
+    header.checksum = 0;
+    header.codec = CDC_NONE;
+    header.content_size = 0;
+
+    unsigned int checksum = crc32(0, (const unsigned char*)&header, sizeof(page_header_t));
     checksum = crc32(checksum, (const unsigned char*)page->content, sizeof(page->content));
     return checksum;
 }
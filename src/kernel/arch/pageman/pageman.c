@@ -1,24 +1,69 @@
 #include "../../include/pageman.h"
 
 
+#pragma region [Layout]
+
+    /*
+    Get place of content part in page. Return size of part, that placed in content without breaks.
+    In PAX page every column value of row is separate part. Space after last row slot placed as is.
+    */
+    static int _get_part(page_layout_t* layout, int offset, int* physical) {
+        *physical = offset;
+        if (layout == NULL || layout->type != PAGE_LAYOUT_PAX || layout->row_size == 0) return PAGE_CONTENT_SIZE - offset;
+
+        int rows_per_page = PAGE_CONTENT_SIZE / layout->row_size;
+        int slot = offset / layout->row_size;
+        if (slot >= rows_per_page) return PAGE_CONTENT_SIZE - offset;
+
+        // Last column, that starts before offset in row
+        int row_offset = offset % layout->row_size;
+        int low = 0, high = layout->column_count - 1;
+        while (low < high) {
+            int middle = (low + high + 1) / 2;
+            if (layout->offsets[middle] <= row_offset) low = middle;
+            else high = middle - 1;
+        }
+
+        int column_offset = row_offset - layout->offsets[low];
+        *physical = layout->offsets[low] * rows_per_page + slot * layout->sizes[low] + column_offset;
+        return layout->sizes[low] - column_offset;
+    }
+
+#pragma endregion
+
 #pragma region [CRUD]
 
 int PGM_get_content(page_t* __restrict page, int offset, unsigned char* __restrict buffer, size_t data_length) {
     int end_index = MIN(PAGE_CONTENT_SIZE, (int)data_length + offset);
-    for (int i = offset, j = 0; i < end_index && j < (int)data_length; i++, j++) buffer[j] = page->content[i];
+    for (int i = offset, physical = 0; i < end_index;) {
+        int part_size = MIN(_get_part(page->layout, i, &physical), end_index - i);
+        memcpy(buffer + (i - offset), page->content + physical, part_size);
+        i += part_size;
+    }
+
     return end_index - offset;
 }
 
 int PGM_insert_content(page_t* __restrict page, int offset, unsigned char* __restrict data, size_t data_length) {
     int end_index = MIN(PAGE_CONTENT_SIZE, (int)data_length + offset);
-    for (int i = offset, j = 0; i < end_index && j < (int)data_length; i++, j++) page->content[i] = data[j];
+    for (int i = offset, physical = 0; i < end_index;) {
+        int part_size = MIN(_get_part(page->layout, i, &physical), end_index - i);
+        memcpy(page->content + physical, data + (i - offset), part_size);
+        i += part_size;
+    }
+
     return end_index - offset;
 }
 
 int PGM_delete_content(page_t* page, int offset, size_t length) {
 #ifndef NO_DELETE_COMMAND
     int end_index = MIN(PAGE_CONTENT_SIZE, offset + (int)length);
-    for (int i = offset; i < end_index; i++) page->content[i] = PAGE_EMPTY;
+    for (int i = offset, physical = 0; i < end_index;) {
+        int part_size = MIN(_get_part(page->layout, i, &physical), end_index - i);
+        memset(page->content + physical, PAGE_EMPTY, part_size);
+        i += part_size;
+    }
+
     return end_index - offset;
 #endif
     return 1;
@@ -32,7 +77,7 @@ int PGM_find_content(page_t* __restrict page, int offset, unsigned char* __restr
     int data_index = 0;
     for (int i = offset; i < PAGE_CONTENT_SIZE - (int)data_size; i++) {
         if (data_index >= data_size) return i - data_size;
-        if (data[data_index] == page->content[i]) data_index++;
+        if (data[data_index] == page->content[PGM_get_physical_offset(page, i)]) data_index++;
         else data_index = 0;
     }
 
@@ -51,6 +96,19 @@ int PGM_get_free_space(page_t* page, int offset) {
 
 int PGM_get_fit_free_space(page_t* page, int offset, int size) {
     if (!page) return -1;
+    if (page->layout != NULL && page->layout->type == PAGE_LAYOUT_PAX) {
+        // In PAX page free space is sequence of empty row slots. Slot is empty, if first byte of row is empty.
+        int row_size = page->layout->row_size;
+        int rows_per_page = PAGE_CONTENT_SIZE / row_size;
+        int slots_count = size <= 0 ? 1 : (size + row_size - 1) / row_size;
+        for (int slot = (MAX(offset, 0) + row_size - 1) / row_size, free_slots = 0; slot < rows_per_page; slot++) {
+            if (page->content[PGM_get_physical_offset(page, slot * row_size)] != PAGE_EMPTY) free_slots = 0;
+            else if (++free_slots >= slots_count) return (slot - slots_count + 1) * row_size;
+        }
+
+        return offset == -1 ? -1 : -2;
+    }
+
     unsigned char* first_empty = (unsigned char*)memchr(page->content, PAGE_EMPTY, PAGE_CONTENT_SIZE);
     if (!first_empty) return -1;
 
@@ -72,3 +130,30 @@ int PGM_get_fit_free_space(page_t* page, int offset, int size) {
 
     return -2;
 }
+
+int PGM_get_physical_offset(page_t* page, int offset) {
+    int physical = 0;
+    _get_part(page->layout, offset, &physical);
+    return physical;
+}
+
+int PGM_get_columns(page_t* __restrict page, unsigned char* __restrict columns, unsigned char* __restrict buffer) {
+    page_layout_t* layout = page->layout;
+    if (layout == NULL || layout->type != PAGE_LAYOUT_PAX || columns == NULL) {
+        PGM_get_content(page, 0, buffer, PAGE_CONTENT_SIZE);
+        return 1;
+    }
+
+    // Every minipage readed one after another, that's why scan touches only needed columns
+    int rows_per_page = PAGE_CONTENT_SIZE / layout->row_size;
+    for (int i = 0; i < layout->column_count; i++) {
+        if (i != 0 && !columns[i]) continue;
+
+        unsigned char* minipage = page->content + layout->offsets[i] * rows_per_page;
+        for (int slot = 0; slot < rows_per_page; slot++) {
+            memcpy(buffer + slot * layout->row_size + layout->offsets[i], minipage + slot * layout->sizes[i], layout->sizes[i]);
+        }
+    }
+
+    return 1;
+}
@@ -0,0 +1,327 @@
+#include "../../include/sortman.h"
+
+
+#pragma region [Compare]
+
+    static long long _get_binary(unsigned char* data, size_t data_size) {
+        if (data_size == sizeof(int32_t)) {
+            int32_t value = 0;
+            memcpy(&value, data, sizeof(int32_t));
+            return value;
+        }
+
+        long long value = 0;
+        memcpy(&value, data, sizeof(long long));
+        return value;
+    }
+
+    static int _compare_rows(sorter_t* sorter, unsigned char* first, unsigned char* second) {
+        int result = 0;
+        if (sorter->flags & SORT_NUMERIC_KEY) {
+            long long first_value  = strntoll((char*)first + sorter->key_offset, sorter->key_size);
+            long long second_value = strntoll((char*)second + sorter->key_offset, sorter->key_size);
+            result = (first_value > second_value) - (first_value < second_value);
+        }
+        else if (sorter->flags & SORT_BINARY_KEY) {
+            long long first_value  = _get_binary(first + sorter->key_offset, sorter->key_size);
+            long long second_value = _get_binary(second + sorter->key_offset, sorter->key_size);
+            result = (first_value > second_value) - (first_value < second_value);
+        }
+        else if (sorter->flags & SORT_REAL_KEY) {
+            double first_value = 0, second_value = 0;
+            memcpy(&first_value, first + sorter->key_offset, sizeof(double));
+            memcpy(&second_value, second + sorter->key_offset, sizeof(double));
+            result = (first_value > second_value) - (first_value < second_value);
+        }
+        else {
+            result = memcmp(first + sorter->key_offset, second + sorter->key_offset, sorter->key_size);
+        }
+
+        return (sorter->flags & SORT_DESCENDING) ? -result : result;
+    }
+
+#pragma endregion
+
+#pragma region [Heap]
+
+    static void _sift_down(sorter_t* sorter, unsigned char** rows, size_t root, size_t count) {
+        while (root * 2 + 1 < count) {
+            size_t child = root * 2 + 1;
+            if (child + 1 < count && _compare_rows(sorter, rows[child], rows[child + 1]) < 0) child++;
+            if (_compare_rows(sorter, rows[root], rows[child]) >= 0) return;
+
+            unsigned char* temp = rows[root];
+            rows[root]  = rows[child];
+            rows[child] = temp;
+            root = child;
+        }
+    }
+
+    static void _sift_up(sorter_t* sorter, unsigned char** rows, size_t index) {
+        while (index > 0) {
+            size_t parent = (index - 1) / 2;
+            if (_compare_rows(sorter, rows[parent], rows[index]) >= 0) return;
+
+            unsigned char* temp = rows[parent];
+            rows[parent] = rows[index];
+            rows[index]  = temp;
+            index = parent;
+        }
+    }
+
+    static void _sort_rows(sorter_t* sorter) {
+        // Rows in heap mode already placed in max-heap order
+        if (!sorter->is_heap) {
+            for (size_t i = sorter->rows_count / 2; i-- > 0;) _sift_down(sorter, sorter->rows, i, sorter->rows_count);
+        }
+
+        for (size_t end = sorter->rows_count; end > 1; end--) {
+            unsigned char* temp = sorter->rows[0];
+            sorter->rows[0] = sorter->rows[end - 1];
+            sorter->rows[end - 1] = temp;
+            _sift_down(sorter, sorter->rows, 0, end - 1);
+        }
+    }
+
+#pragma endregion
+
+#pragma region [Runs]
+
+    static int _spill_rows(sorter_t* sorter) {
+        sort_run_t* runs = (sort_run_t*)realloc(sorter->runs, (sorter->run_count + 1) * sizeof(sort_run_t));
+        if (!runs) return -1;
+
+        sorter->runs = runs;
+        sort_run_t* run = &sorter->runs[sorter->run_count++];
+        memset(run, 0, sizeof(sort_run_t));
+
+        _sort_rows(sorter);
+
+        page_t* page = NULL;
+        for (size_t i = 0; i < sorter->rows_count; i++) {
+            if (SRT_append_run_row(run, &page, sorter->rows[i], sorter->row_size) != 1) {
+                SRT_close_run_page(&page);
+                return -1;
+            }
+        }
+
+        print_debug("Sort run [%i] spilled with [%i] rows", sorter->run_count - 1, (int)sorter->rows_count);
+        sorter->rows_count = 0;
+        return SRT_close_run_page(&page);
+    }
+
+    /*
+    Merge provided runs. If output run provided, result will be written to run. In other case
+    every row will be sent to output function.
+    */
+    static int _merge_runs(
+        sorter_t* sorter, sort_run_t* runs, int run_count, sort_run_t* output_run,
+        int (*output)(void*, unsigned char*, size_t), void* ctx
+    ) {
+        int status = 1;
+        int rows_per_page = PAGE_CONTENT_SIZE / sorter->row_size;
+        unsigned char* buffers = (unsigned char*)malloc(run_count * PAGE_CONTENT_SIZE);
+        size_t* positions = (size_t*)calloc(run_count, sizeof(size_t));
+        if (!buffers || !positions) status = -1;
+
+        page_t* page = NULL;
+        size_t emitted = 0;
+        while (status == 1) {
+            if (output_run == NULL && sorter->limit > 0 && emitted >= sorter->limit) break;
+
+            int current = -1;
+            unsigned char* current_row = NULL;
+            for (int i = 0; i < run_count && status == 1; i++) {
+                if (positions[i] >= runs[i].rows_count) continue;
+
+                int slot = positions[i] % rows_per_page;
+                unsigned char* buffer = buffers + i * PAGE_CONTENT_SIZE;
+                if (slot == 0 && runs[i].next_page <= (int)(positions[i] / rows_per_page)) {
+                    if (SRT_read_run_page(&runs[i], buffer) != 1) status = -1;
+                }
+
+                unsigned char* row = buffer + slot * sorter->row_size;
+                if (current == -1 || _compare_rows(sorter, row, current_row) < 0) {
+                    current = i;
+                    current_row = row;
+                }
+            }
+
+            if (current == -1 || status != 1) break;
+            positions[current]++;
+
+            if (output_run != NULL) status = SRT_append_run_row(output_run, &page, current_row, sorter->row_size);
+            else if (output(ctx, current_row, sorter->row_size) != 1) break;
+            emitted++;
+        }
+
+        if (SRT_close_run_page(&page) != 1) status = -1;
+        for (int i = 0; i < run_count; i++) SRT_free_run(&runs[i]);
+
+        SOFT_FREE(buffers);
+        SOFT_FREE(positions);
+        return status;
+    }
+
+#pragma endregion
+
+
+sorter_t* SRT_create_sorter(size_t row_size, int key_offset, int key_size, unsigned char flags, size_t limit) {
+    if (row_size == 0 || row_size > PAGE_CONTENT_SIZE) return NULL;
+
+    sorter_t* sorter = (sorter_t*)malloc(sizeof(sorter_t));
+    if (!sorter) return NULL;
+    memset(sorter, 0, sizeof(sorter_t));
+
+    sorter->row_size   = row_size;
+    sorter->key_offset = key_offset;
+    sorter->key_size   = key_size;
+    sorter->flags      = flags;
+    sorter->limit      = limit;
+
+    // Bounded heap used only if all K rows fit into memory budget
+    sorter->is_heap = limit > 0 && limit * row_size <= SORT_BUFFER_SIZE;
+    sorter->rows_capacity = sorter->is_heap ? limit : MAX(SORT_BUFFER_SIZE / row_size, 1);
+
+    sorter->buffer = (unsigned char*)malloc(sorter->rows_capacity * row_size);
+    sorter->rows = (unsigned char**)malloc(sorter->rows_capacity * sizeof(unsigned char*));
+    if (!sorter->buffer || !sorter->rows) {
+        SRT_free_sorter(sorter);
+        return NULL;
+    }
+
+    return sorter;
+}
+
+int SRT_add_row(sorter_t* __restrict sorter, unsigned char* __restrict row) {
+    if (sorter->is_heap) {
+        // Heap root is the worst row from K kept rows
+        if (sorter->rows_count < sorter->rows_capacity) {
+            sorter->rows[sorter->rows_count] = sorter->buffer + sorter->rows_count * sorter->row_size;
+            memcpy(sorter->rows[sorter->rows_count], row, sorter->row_size);
+            _sift_up(sorter, sorter->rows, sorter->rows_count++);
+        }
+        else if (_compare_rows(sorter, row, sorter->rows[0]) < 0) {
+            memcpy(sorter->rows[0], row, sorter->row_size);
+            _sift_down(sorter, sorter->rows, 0, sorter->rows_count);
+        }
+
+        return 1;
+    }
+
+    if (sorter->rows_count >= sorter->rows_capacity) {
+        if (_spill_rows(sorter) != 1) return -1;
+    }
+
+    sorter->rows[sorter->rows_count] = sorter->buffer + sorter->rows_count * sorter->row_size;
+    memcpy(sorter->rows[sorter->rows_count++], row, sorter->row_size);
+    return 1;
+}
+
+int SRT_finish(sorter_t* sorter, int (*output)(void*, unsigned char*, size_t), void* ctx) {
+    if (sorter->run_count == 0) {
+        _sort_rows(sorter);
+        for (size_t i = 0; i < sorter->rows_count; i++) {
+            if (sorter->limit > 0 && i >= sorter->limit) break;
+            if (output(ctx, sorter->rows[i], sorter->row_size) != 1) break;
+        }
+
+        return 1;
+    }
+
+    if (sorter->rows_count > 0 && _spill_rows(sorter) != 1) return -1;
+
+    // Row buffer not needed anymore. Merge will use same memory budget for run pages.
+    SOFT_FREE(sorter->buffer);
+    SOFT_FREE(sorter->rows);
+
+    int fan_in = MAX(SORT_BUFFER_PAGES - 1, 2);
+    while (sorter->run_count > fan_in) {
+        sort_run_t merged_run;
+        memset(&merged_run, 0, sizeof(sort_run_t));
+        if (_merge_runs(sorter, sorter->runs, fan_in, &merged_run, NULL, NULL) != 1) {
+            SRT_free_run(&merged_run);
+            return -1;
+        }
+
+        memmove(sorter->runs, sorter->runs + fan_in, (sorter->run_count - fan_in) * sizeof(sort_run_t));
+        sorter->run_count -= fan_in;
+        sorter->runs[sorter->run_count++] = merged_run;
+    }
+
+    int result = _merge_runs(sorter, sorter->runs, sorter->run_count, NULL, output, ctx);
+    sorter->run_count = 0;
+    return result;
+}
+
+int SRT_free_sorter(sorter_t* sorter) {
+    if (!sorter) return -1;
+    for (int i = 0; i < sorter->run_count; i++) SRT_free_run(&sorter->runs[i]);
+
+    SOFT_FREE(sorter->runs);
+    SOFT_FREE(sorter->buffer);
+    SOFT_FREE(sorter->rows);
+    SOFT_FREE(sorter);
+    return 1;
+}
+
+int SRT_close_run_page(page_t** page) {
+    if (*page == NULL) return 1;
+
+    int result = PGM_save_page(*page);
+    PGM_free_page(*page);
+    *page = NULL;
+    return result;
+}
+
+int SRT_append_run_row(sort_run_t* __restrict run, page_t** page, unsigned char* __restrict row, size_t row_size) {
+    int rows_per_page = PAGE_CONTENT_SIZE / row_size;
+    if (*page == NULL) {
+        char (*page_names)[PAGE_NAME_SIZE] = realloc(run->page_names, (run->page_count + 1) * PAGE_NAME_SIZE);
+        if (!page_names) return -1;
+        run->page_names = page_names;
+
+        // Page names generated by files on disk. We save empty page at once for reserving name,
+        // because few runs can be opened at same time.
+        *page = PGM_create_empty_page(SORT_BASE_PATH);
+        if (*page == NULL) return -1;
+        PGM_save_page(*page);
+
+        memcpy(run->page_names[run->page_count++], (*page)->header->name, PAGE_NAME_SIZE);
+    }
+
+    int slot = run->rows_count % rows_per_page;
+    PGM_insert_content(*page, slot * row_size, row, row_size);
+    run->rows_count++;
+
+    if (slot + 1 == rows_per_page) return SRT_close_run_page(page);
+    return 1;
+}
+
+int SRT_read_run_page(sort_run_t* __restrict run, unsigned char* __restrict buffer) {
+    char* page_name = run->page_names[run->next_page++];
+    page_t* page = PGM_load_page(SORT_BASE_PATH, page_name);
+    if (!page) return -1;
+
+    memcpy(buffer, page->content, PAGE_CONTENT_SIZE);
+
+    // Temporary page readed only once, that's why we delete it right now
+    char page_path[DEFAULT_PATH_SIZE] = { 0 };
+    get_load_path(page_name, PAGE_NAME_SIZE, page_path, SORT_BASE_PATH, PAGE_EXTENSION);
+    if (CHC_flush_entry(page, PAGE_CACHE) == -2) PGM_free_page(page);
+    remove(page_path);
+    return 1;
+}
+
+int SRT_free_run(sort_run_t* run) {
+    for (; run->next_page < run->page_count; run->next_page++) {
+        char page_path[DEFAULT_PATH_SIZE] = { 0 };
+        get_load_path(run->page_names[run->next_page], PAGE_NAME_SIZE, page_path, SORT_BASE_PATH, PAGE_EXTENSION);
+        remove(page_path);
+    }
+
+    SOFT_FREE(run->page_names);
+    run->page_count = 0;
+    run->rows_count = 0;
+    return 1;
+}
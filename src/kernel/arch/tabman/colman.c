@@ -28,6 +28,7 @@ int TBM_get_column_info(table_t* table, char* column_name, table_columns_info_t*
         else {
             info->offset = offset;
             info->size = table->columns[i]->size;
+            info->type = table->columns[i]->type;
             return 1;
         }
     }
@@ -37,20 +38,29 @@ int TBM_get_column_info(table_t* table, char* column_name, table_columns_info_t*
 
 int TBM_check_signature(table_t* __restrict table, unsigned char* __restrict data) {
 #ifndef DISABLE_CHECK_SIGNATURE
+    // Data provided in text format, that's why binary columns have text size here
     unsigned char* data_pointer = data;
     for (int i = 0; i < table->header->column_count; i++) {
-        unsigned char data_type = GET_COLUMN_DATA_TYPE(table->columns[i]->type);
+        unsigned char type = table->columns[i]->type;
+        unsigned char data_type = GET_COLUMN_DATA_TYPE(type);
+        int size = TBM_get_text_size(type, table->columns[i]->size);
+        data_pointer += size;
         if (data_type == COLUMN_TYPE_ANY || data_type == COLUMN_TYPE_MODULE) continue;
 
         char value[COLUMN_MAX_SIZE] = { 0 };
-        strncpy(value, (char*)data_pointer, table->columns[i]->size);
-        data_pointer += table->columns[i]->size;
+        strncpy(value, (char*)data_pointer - size, size);
 
+        long long number = 0;
+        double real = 0;
         switch (data_type) {
             case COLUMN_TYPE_INT:
                 if (!is_integer(value)) return -2;
                 break;
 
+            case COLUMN_TYPE_BINARY:
+                if (TBM_parse_binary(type, value, size, &number, &real) != 1) return -2;
+                break;
+
             case COLUMN_TYPE_STRING: break;
             default: return -4;
         }
@@ -58,3 +68,163 @@ int TBM_check_signature(table_t* __restrict table, unsigned char* __restrict dat
 #endif
     return 1;
 }
+
+int TBM_get_text_size(unsigned char type, unsigned short size) {
+    if (!GET_COLUMN_BINARY(type)) return size;
+    switch (GET_COLUMN_BINARY_TYPE(type)) {
+        case COLUMN_BINARY_I32: return I32_TEXT_SIZE;
+        case COLUMN_BINARY_I64: return I64_TEXT_SIZE;
+        case COLUMN_BINARY_F64: return F64_TEXT_SIZE;
+        default: return DECIMAL_TEXT_SIZE;
+    }
+}
+
+int TBM_parse_binary(unsigned char type, char* __restrict text, size_t size, long long* __restrict value, double* __restrict real) {
+    char buffer[DECIMAL_TEXT_SIZE + F64_TEXT_SIZE] = { 0 };
+    strncpy(buffer, text, MIN(size, sizeof(buffer) - 1));
+
+    char* end = buffer;
+    unsigned char kind = GET_COLUMN_BINARY_TYPE(type);
+    if (kind == COLUMN_BINARY_DECIMAL) {
+        // Decimal parsed without double for keeping exact value
+        char* pointer = buffer;
+        while (*pointer == ' ') pointer++;
+        int sign = *pointer == '-' ? -1 : 1;
+        if (*pointer == '-' || *pointer == '+') pointer++;
+        if (!isdigit(*pointer) && !(*pointer == '.' && isdigit(pointer[1]))) return -2;
+
+        // Value, that doesn't fit into i64, rejected like out of range i32 value
+        long long number = 0;
+        for (; isdigit(*pointer); pointer++) {
+            if (__builtin_mul_overflow(number, 10, &number) || __builtin_add_overflow(number, *pointer - '0', &number)) return -2;
+        }
+
+        long long fraction = 0;
+        int digits = 0;
+        if (*pointer == '.') {
+            for (pointer++; isdigit(*pointer); pointer++) {
+                if (digits < DECIMAL_SCALE) {
+                    fraction = fraction * 10 + (*pointer - '0');
+                    digits++;
+                }
+            }
+        }
+
+        for (; digits < DECIMAL_SCALE; digits++) fraction *= 10;
+        if (__builtin_mul_overflow(number, DECIMAL_FACTOR, &number) || __builtin_add_overflow(number, fraction, &number)) return -2;
+        *value = sign * number;
+        *real  = (double)*value / DECIMAL_FACTOR;
+        end = pointer;
+    }
+    else if (kind == COLUMN_BINARY_F64) {
+        *real = strtod(buffer, &end);
+        if (!isfinite(*real)) return -2;
+        if (*real >= (double)LLONG_MAX) *value = LLONG_MAX;
+        else if (*real <= (double)LLONG_MIN) *value = LLONG_MIN;
+        else *value = (long long)*real;
+    }
+    else {
+        errno = 0;
+        *value = strtoll(buffer, &end, 10);
+        *real  = (double)*value;
+        if (errno == ERANGE) return -2;
+        if (kind == COLUMN_BINARY_I32 && (*value > INT_MAX || *value < INT_MIN)) return -2;
+    }
+
+    if (end == buffer) return -2;
+    while (*end == ' ') end++;
+    return *end == '\0' ? 1 : -2;
+}
+
+int TBM_encode_row(table_t* __restrict table, unsigned char* __restrict text, unsigned char* __restrict buffer) {
+    for (int i = 0; i < table->header->column_count; i++) {
+        table_column_t* column = table->columns[i];
+        int text_size = TBM_get_text_size(column->type, column->size);
+        if (!GET_COLUMN_BINARY(column->type)) memcpy(buffer, text, column->size);
+        else {
+            long long value = 0;
+            double real = 0;
+            if (TBM_parse_binary(column->type, (char*)text, text_size, &value, &real) != 1) return -2;
+
+            int32_t value32 = (int32_t)value;
+            switch (GET_COLUMN_BINARY_TYPE(column->type)) {
+                case COLUMN_BINARY_I32: memcpy(buffer, &value32, sizeof(int32_t)); break;
+                case COLUMN_BINARY_F64: memcpy(buffer, &real, sizeof(double)); break;
+                default: memcpy(buffer, &value, sizeof(long long)); break;
+            }
+        }
+
+        text += text_size;
+        buffer += column->size;
+    }
+
+    return 1;
+}
+
+int TBM_decode_value(unsigned char type, unsigned short size, unsigned char* __restrict data, unsigned char* __restrict buffer) {
+    if (!GET_COLUMN_BINARY(type)) {
+        memcpy(buffer, data, size);
+        return size;
+    }
+
+    char text[DECIMAL_TEXT_SIZE + F64_TEXT_SIZE] = { 0 };
+    int text_size = TBM_get_text_size(type, size);
+    long long value = TBM_get_binary_int(type, data);
+    switch (GET_COLUMN_BINARY_TYPE(type)) {
+        case COLUMN_BINARY_F64: 
+            snprintf(text, sizeof(text), "%*.17g", text_size, TBM_get_binary_real(type, data)); 
+            break;
+        case COLUMN_BINARY_DECIMAL: {
+            char number[DECIMAL_TEXT_SIZE + 1] = { 0 };
+            unsigned long long absolute = value < 0 ? -(unsigned long long)value : (unsigned long long)value;
+            snprintf(number, sizeof(number), "%s%llu.%0*llu", value < 0 ? "-" : "", absolute / DECIMAL_FACTOR, DECIMAL_SCALE, absolute % DECIMAL_FACTOR);
+            snprintf(text, sizeof(text), "%*s", text_size, number);
+            break;
+        }
+        default: 
+            snprintf(text, sizeof(text), "%*lld", text_size, value); 
+            break;
+    }
+
+    memcpy(buffer, text, text_size);
+    return text_size;
+}
+
+int TBM_decode_row(table_t* __restrict table, unsigned char* __restrict data, unsigned char* __restrict buffer) {
+    for (int i = 0; i < table->header->column_count; i++) {
+        buffer += TBM_decode_value(table->columns[i]->type, table->columns[i]->size, data, buffer);
+        data += table->columns[i]->size;
+    }
+
+    return table->text_row_size;
+}
+
+long long TBM_get_binary_int(unsigned char type, unsigned char* data) {
+    int32_t value32 = 0;
+    long long value = 0;
+    double real = 0;
+    switch (GET_COLUMN_BINARY_TYPE(type)) {
+        case COLUMN_BINARY_I32: 
+            memcpy(&value32, data, sizeof(int32_t)); 
+            return value32;
+        case COLUMN_BINARY_F64: 
+            memcpy(&real, data, sizeof(double)); 
+            return (long long)real;
+        default: 
+            memcpy(&value, data, sizeof(long long)); 
+            return value;
+    }
+}
+
+double TBM_get_binary_real(unsigned char type, unsigned char* data) {
+    double real = 0;
+    switch (GET_COLUMN_BINARY_TYPE(type)) {
+        case COLUMN_BINARY_F64: 
+            memcpy(&real, data, sizeof(double)); 
+            return real;
+        case COLUMN_BINARY_DECIMAL: 
+            return (double)TBM_get_binary_int(type, data) / DECIMAL_FACTOR;
+        default: 
+            return (double)TBM_get_binary_int(type, data);
+    }
+}
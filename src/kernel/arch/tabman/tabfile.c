@@ -1,6 +1,55 @@
 #include "../../include/tabman.h"
 
 
+/*
+Compile queries of module columns. Columns, that can't be compiled, launch modules as before.
+*/
+static int _compile_modules(table_t* table) {
+#ifndef NO_INLINE_MODULES
+    module_operand_t operands[table->header->column_count];
+    int operands_count = 0;
+    int has_modules = 0;
+
+    unsigned short offset = 0;
+    for (int i = 0; i < table->header->column_count; i++) {
+        table_column_t* column = table->columns[i];
+        if (GET_COLUMN_DATA_TYPE(column->type) == COLUMN_TYPE_MODULE) has_modules = 1;
+
+        unsigned char type = MODULE_OPERAND_TEXT;
+        if (GET_COLUMN_BINARY(column->type)) {
+            if (GET_COLUMN_BINARY_TYPE(column->type) == COLUMN_BINARY_I32) type = MODULE_OPERAND_I32;
+            else if (GET_COLUMN_BINARY_TYPE(column->type) == COLUMN_BINARY_I64) type = MODULE_OPERAND_I64;
+            else type = 0xFF;
+        }
+
+        if (type != 0xFF) {
+            operands[operands_count].name      = column->name;
+            operands[operands_count].name_size = COLUMN_NAME_SIZE;
+            operands[operands_count].offset    = offset;
+            operands[operands_count].size      = column->size;
+            operands[operands_count++].type    = type;
+        }
+
+        offset += column->size;
+    }
+
+    if (!has_modules) return 0;
+    table->programs = (module_program_t**)malloc(table->header->column_count * sizeof(module_program_t*));
+    if (!table->programs) return -1;
+
+    for (int i = 0; i < table->header->column_count; i++) {
+        table_column_t* column = table->columns[i];
+        table->programs[i] = NULL;
+        if (GET_COLUMN_DATA_TYPE(column->type) != COLUMN_TYPE_MODULE) continue;
+        table->programs[i] = MDL_compile_program(column->module_name, column->module_querry, COLUMN_MODULE_SIZE, operands, operands_count);
+        if (table->programs[i]) print_log("Module query of column [%.*s] compiled", COLUMN_NAME_SIZE, column->name);
+    }
+
+    return 1;
+#endif
+    return 0;
+}
+
 table_t* TBM_create_table(char* __restrict name, table_column_t** __restrict columns, int col_count, unsigned char access) {
 #ifndef NO_CREATE_COMMAND
     int row_size = 0;
@@ -30,9 +79,12 @@ table_t* TBM_create_table(char* __restrict name, table_column_t** __restrict col
 
     table->columns  = columns;
     table->row_size = row_size;
+    for (int i = 0; i < col_count; i++)
+        table->text_row_size += TBM_get_text_size(columns[i]->type, columns[i]->size);
     
     table->lock = THR_create_lock();
     table->header = header;
+    _compile_modules(table);
     return table;
 #endif
     return NULL;
@@ -74,6 +126,7 @@ int TBM_save_table(table_t* table) {
 
                 fsync(fd);
                 close(fd);
+                MTR_add(MTR_FSYNCS, 1);
             }
         }
     }
@@ -92,9 +145,11 @@ table_t* TBM_load_table(char* name) {
     table_t* loaded_table = (table_t*)CHC_find_entry(name, TABLE_BASE_PATH, TABLE_CACHE);
     if (loaded_table != NULL) {
         print_io("Loading table [%s] from GCT", load_path);
+        QST_add(table_hits, 1);
         return loaded_table;
     }
 
+    unsigned long long load_start = QST_time();
     int table_load_break = 0;
     #pragma omp critical (table_load)
     {
@@ -135,8 +190,10 @@ table_t* TBM_load_table(char* name) {
                             pread(fd, columns[i], sizeof(table_column_t), sizeof(table_header_t) + sizeof(table_column_t) * i);
                         }
 
-                        for (int i = 0; i < header->column_count; i++)
+                        for (int i = 0; i < header->column_count; i++) {
                             table->row_size += columns[i]->size;
+                            table->text_row_size += TBM_get_text_size(columns[i]->type, columns[i]->size);
+                        }
 
                         // Read directory names from file, that linked to this directory.
                         for (int i = 0; i < header->dir_count; i++) {
@@ -151,6 +208,7 @@ table_t* TBM_load_table(char* name) {
                         table->lock = THR_create_lock();
 
                         table->header = header;
+                        if (!table_load_break) _compile_modules(table);
                         CHC_add_entry(table, table->header->name, TABLE_BASE_PATH, TABLE_CACHE, (void*)TBM_free_table, (void*)TBM_save_table);
                         loaded_table = table;
                     }
@@ -166,6 +224,8 @@ table_t* TBM_load_table(char* name) {
         return NULL;
     }
 
+    QST_add(table_loads, 1);
+    QST_add(load_time, QST_time() - load_start);
     return loaded_table;
 }
 
@@ -201,6 +261,7 @@ int TBM_flush_table(table_t* table) {
 
 int TBM_free_table(table_t* table) {
     if (!table) return -1;
+    ARRAY_SOFT_FREE(table->programs, table->header->column_count);
     ARRAY_SOFT_FREE(table->columns, table->header->column_count);
     SOFT_FREE(table->header);
     SOFT_FREE(table);
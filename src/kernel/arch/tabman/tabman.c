@@ -28,6 +28,65 @@ static int _unlink_dir_from_table(table_t* table, const char* dir_name) {
     return status;
 }
 
+/*
+Page layout pushed to directory before every access to pages, because pageman translates row offsets
+to place in PAX page by column sizes.
+*/
+static int _set_page_layout(table_t* __restrict table, directory_t* __restrict directory) {
+    page_layout_t layout;
+    memset(&layout, 0, sizeof(page_layout_t));
+    layout.type = table->header->layout;
+    layout.row_size = table->row_size;
+    layout.column_count = table->header->column_count;
+    layout.codec = table->header->codec;
+
+    int offset = 0;
+    for (int i = 0; i < table->header->column_count; i++) {
+        layout.offsets[i] = offset;
+        layout.sizes[i] = table->columns[i]->size;
+        offset += table->columns[i]->size;
+    }
+
+    return DRM_set_page_layout(directory, &layout);
+}
+
+/*
+Zone maps keep summary for first ZONE_COLUMNS int columns of table (not wider then ZONE_VALUE_SIZE) and Bloom filters for first
+BLOOM_COLUMNS columns with Bloom flag.
+Layout set before every write, that's why old directories get zone maps with first rewrite of page.
+*/
+static int _set_zone_layout(table_t* __restrict table, directory_t* __restrict directory) {
+    zone_layout_t layout;
+    memset(&layout, 0, sizeof(zone_layout_t));
+    layout.row_size = table->row_size;
+    _set_page_layout(table, directory);
+
+    int offset = 0;
+    for (int i = 0; i < table->header->column_count; i++) {
+        int is_short_int = GET_COLUMN_DATA_TYPE(table->columns[i]->type) == COLUMN_TYPE_INT && table->columns[i]->size <= ZONE_VALUE_SIZE;
+        if (is_short_int && layout.column_count < ZONE_COLUMNS) {
+            layout.offsets[layout.column_count] = offset;
+            layout.sizes[layout.column_count++] = table->columns[i]->size;
+        }
+
+        // Module columns changed by postload modules, that's why their stored values can't be used in filters.
+        // Binary columns don't have text keys, that used by filters. Wide int columns don't have numeric keys.
+        unsigned char data_type = GET_COLUMN_DATA_TYPE(table->columns[i]->type);
+        if (
+            GET_COLUMN_BLOOM(table->columns[i]->type) == COLUMN_BLOOM && data_type != COLUMN_TYPE_MODULE && 
+            data_type != COLUMN_TYPE_BINARY && (data_type != COLUMN_TYPE_INT || is_short_int) && layout.bloom_count < BLOOM_COLUMNS
+        ) {
+            layout.bloom_offsets[layout.bloom_count] = offset;
+            layout.bloom_sizes[layout.bloom_count]   = table->columns[i]->size;
+            layout.bloom_numeric[layout.bloom_count++] = data_type == COLUMN_TYPE_INT;
+        }
+
+        offset += table->columns[i]->size;
+    }
+
+    return DRM_set_zone_layout(directory, &layout);
+}
+
 #pragma region [CRUD]
 
 int TBM_append_content(table_t* __restrict table, unsigned char* __restrict data, size_t data_size) {
@@ -40,6 +99,7 @@ int TBM_append_content(table_t* __restrict table, unsigned char* __restrict data
         directory_t* directory = DRM_load_directory(table->dir_names[i]);
         if (!directory) continue;
         if (THR_require_lock(&directory->lock, omp_get_thread_num()) == 1) {
+            _set_zone_layout(table, directory);
             int result = DRM_append_content(directory, data_pointer, size4append);
             THR_release_lock(&directory->lock, omp_get_thread_num());
             DRM_flush_directory(directory);
@@ -61,6 +121,7 @@ int TBM_append_content(table_t* __restrict table, unsigned char* __restrict data
     if (new_directory == NULL) return -1;
 
     table->append_offset = table->header->dir_count;
+    _set_zone_layout(table, new_directory);
     int append_result = DRM_append_content(new_directory, data_pointer, size4append);
     if (append_result < 0) {
         DRM_free_directory(new_directory);
@@ -79,6 +140,50 @@ int TBM_append_content(table_t* __restrict table, unsigned char* __restrict data
     return 1;
 }
 
+int TBM_append_rows(table_t* __restrict table, unsigned char* __restrict data, size_t rows_count) {
+    size_t row_size = table->row_size;
+    int appended = 0;
+
+    // Fill free space in existed directories
+    for (int i = table->append_offset; i < table->header->dir_count && appended < (int)rows_count; i++) {
+        directory_t* directory = DRM_load_directory(table->dir_names[i]);
+        if (!directory) continue;
+        if (THR_require_lock(&directory->lock, omp_get_thread_num()) == 1) {
+            _set_zone_layout(table, directory);
+            int result = DRM_append_rows(directory, data + appended * row_size, row_size, rows_count - appended);
+            THR_release_lock(&directory->lock, omp_get_thread_num());
+            if (result > 0) appended += result;
+        }
+
+        DRM_flush_directory(directory);
+    }
+
+    // Rest of rows goes to new directories.
+    // Every new directory saved once, when it filled.
+    while (appended < (int)rows_count) {
+        if (table->header->dir_count + 1 > DIRECTORIES_PER_TABLE) return -1;
+
+        directory_t* new_directory = DRM_create_empty_directory();
+        if (new_directory == NULL) return -1;
+
+        _set_zone_layout(table, new_directory);
+        int result = DRM_append_rows(new_directory, data + appended * row_size, row_size, rows_count - appended);
+        if (result <= 0) {
+            DRM_free_directory(new_directory);
+            return result < 0 ? result - 10 : -1;
+        }
+
+        appended += result;
+        table->append_offset = table->header->dir_count;
+        _link_dir2table(table, new_directory);
+
+        DRM_save_directory(new_directory);
+        DRM_free_directory(new_directory);
+    }
+
+    return 1;
+}
+
 int TBM_get_content(table_t* __restrict table, int offset,  unsigned char* __restrict buffer, size_t size) {
     int status = 0;
     int content2get_size = (int)size;
@@ -92,6 +197,8 @@ int TBM_get_content(table_t* __restrict table, int offset,  unsigned char* __res
         directory_t* directory = DRM_load_directory(table->dir_names[i]);
         if (!directory) continue;
         if (THR_require_lock(&directory->lock, omp_get_thread_num()) == 1) {
+            _set_page_layout(table, directory);
+
             // Get data from directory
             // After getting data, copy it to allocated output
             int current_size = MIN(directory->header->page_count * PAGE_CONTENT_SIZE, content2get_size);
@@ -129,6 +236,7 @@ int TBM_insert_content(table_t* __restrict table, int offset, unsigned char* __r
         directory_t* directory = DRM_load_directory(table->dir_names[i]);
         if (!directory) return -1;
         if (THR_require_lock(&directory->lock, omp_get_thread_num()) == 1) {
+            _set_zone_layout(table, directory);
             int result = DRM_insert_content(directory, page_offset, data_pointer, size4insert);
             THR_release_lock(&directory->lock, omp_get_thread_num());
 
@@ -162,6 +270,7 @@ int TBM_delete_content(table_t* table, int offset, size_t size) {
         directory_t* directory = DRM_load_directory(table->dir_names[i]);
         if (!directory) return -1;
         if (THR_require_lock(&directory->lock, omp_get_thread_num()) == 1) {
+            _set_zone_layout(table, directory);
             int result = DRM_delete_content(directory, page_offset, size4delete);
             table->append_offset = MIN(table->append_offset, i);
 
@@ -180,6 +289,93 @@ int TBM_delete_content(table_t* table, int offset, size_t size) {
     return -2;
 }
 
+int TBM_get_page_zone(
+    table_t* __restrict table, int page, page_zone_t* __restrict page_zone,
+    page_zone_t* __restrict directory_zone, zone_layout_t* __restrict layout, unsigned char* __restrict bloom
+) {
+    int pages_left = 0;
+
+    // Pages addressed in same way, as in TBM_get_content
+    int start_directory = page / PAGES_PER_DIRECTORY;
+    int directory_page  = page % PAGES_PER_DIRECTORY;
+    for (int i = start_directory; i < table->header->dir_count && pages_left == 0; i++) {
+        directory_t* directory = DRM_load_directory(table->dir_names[i]);
+        if (!directory) continue;
+        if (THR_require_lock(&directory->lock, omp_get_thread_num()) == 1) {
+            if (directory_page < directory->header->page_count) {
+                memcpy(page_zone, &directory->zones[directory_page], sizeof(page_zone_t));
+                memcpy(directory_zone, &directory->zone, sizeof(page_zone_t));
+                memcpy(layout, &directory->zone_layout, sizeof(zone_layout_t));
+                if (bloom != NULL) memcpy(bloom, directory->blooms[directory_page], PAGE_BLOOM_SIZE);
+                pages_left = directory->header->page_count - directory_page;
+            }
+            else {
+                directory_page -= directory->header->page_count;
+            }
+
+            THR_release_lock(&directory->lock, omp_get_thread_num());
+        }
+
+        DRM_flush_directory(directory);
+    }
+
+    return pages_left;
+}
+
+int TBM_get_page_columns(table_t* __restrict table, int page, unsigned char* __restrict columns, unsigned char* __restrict buffer) {
+    int result = -1;
+
+    // Pages addressed in same way, as in TBM_get_content
+    int directory_page = page % PAGES_PER_DIRECTORY;
+    for (int i = page / PAGES_PER_DIRECTORY; i < table->header->dir_count && result == -1; i++) {
+        directory_t* directory = DRM_load_directory(table->dir_names[i]);
+        if (!directory) return -1;
+        if (THR_require_lock(&directory->lock, omp_get_thread_num()) == 1) {
+            if (directory_page < directory->header->page_count) {
+                _set_page_layout(table, directory);
+                result = DRM_get_page_columns(directory, directory_page, columns, buffer);
+                if (result != 1) result = -2;
+            }
+            else {
+                directory_page -= directory->header->page_count;
+            }
+
+            THR_release_lock(&directory->lock, omp_get_thread_num());
+        }
+
+        DRM_flush_directory(directory);
+    }
+
+    return result == 1 ? 1 : 0;
+}
+
+int TBM_mutate_page(table_t* __restrict table, int page, unsigned char* __restrict mask, unsigned char* __restrict data) {
+    int result = -1;
+
+    // Pages addressed in same way, as in TBM_get_content
+    int directory_page = page % PAGES_PER_DIRECTORY;
+    for (int i = page / PAGES_PER_DIRECTORY; i < table->header->dir_count && result == -1; i++) {
+        directory_t* directory = DRM_load_directory(table->dir_names[i]);
+        if (!directory) return -1;
+        if (THR_require_lock(&directory->lock, omp_get_thread_num()) == 1) {
+            if (directory_page < directory->header->page_count) {
+                _set_zone_layout(table, directory);
+                result = DRM_mutate_page(directory, directory_page, mask, table->row_size, data);
+                if (data == NULL && result > 0) table->append_offset = MIN(table->append_offset, i);
+            }
+            else {
+                directory_page -= directory->header->page_count;
+            }
+
+            THR_release_lock(&directory->lock, omp_get_thread_num());
+        }
+
+        DRM_flush_directory(directory);
+    }
+
+    return result;
+}
+
 #pragma endregion
 
 int TBM_cleanup_dirs(table_t* table) {
@@ -233,6 +429,7 @@ int TBM_find_content(table_t* __restrict table, int offset, unsigned char* __res
         // We search part of data in this directory, save index and unload directory.
         int current_size = MIN((directory->header->page_count * PAGE_CONTENT_SIZE) - directory_offset, (int)temp_data_size);
         if (THR_require_lock(&directory->lock, omp_get_thread_num()) == 1) {
+            _set_page_layout(table, directory);
             int result = DRM_find_content(directory, directory_offset, data_pointer, current_size);
             THR_release_lock(&directory->lock, omp_get_thread_num());
 
@@ -311,42 +508,96 @@ int TBM_migrate_table(table_t* __restrict src, table_t* __restrict dst, char* __
     return 1;
 }
 
-int TBM_invoke_modules(table_t* __restrict table, unsigned char* __restrict data, unsigned char type) {
+/*
+Build module query of column for row. Column names in query replaced by row values.
+Return allocated query or NULL.
+*/
+static char* _get_module_query(table_t* __restrict table, unsigned char* __restrict data, int column) {
+    char* output_querry = (char*)malloc(COLUMN_MODULE_SIZE + 1);
+    if (!output_querry) return NULL;
+    strncpy(output_querry, table->columns[column]->module_querry, COLUMN_MODULE_SIZE);
+    output_querry[COLUMN_MODULE_SIZE] = '\0';
+
+    int content_offset = 0;
+    for (int j = 0; j < table->header->column_count; j++) {
+        unsigned char* content_pointer = data + content_offset;
+        content_offset += table->columns[j]->size;
+
+        // Query built for every row, that's why columns without reference skipped without allocation
+        if (!strstr(output_querry, table->columns[j]->name)) continue;
+
+        char content_part[COLUMN_MAX_SIZE + 1];
+        size_t content_size = MIN(table->columns[j]->size, COLUMN_MAX_SIZE);
+        strncpy(content_part, (char*)content_pointer, content_size);
+        content_part[content_size] = '\0';
+
+        char* next_output_querry = strrep(output_querry, table->columns[j]->name, content_part);
+        if (!next_output_querry) continue;
+        free(output_querry);
+
+        output_querry = (char*)next_output_querry;
+    }
+
+    return output_querry;
+}
+
+int TBM_invoke_modules(table_t* __restrict table, unsigned char* __restrict data, unsigned char type, unsigned char* __restrict columns) {
+    return TBM_invoke_modules_batch(table, data, 1, type, columns);
+}
+
+int TBM_invoke_modules_batch(
+    table_t* __restrict table, unsigned char* __restrict rows, int rows_count, unsigned char type, unsigned char* __restrict columns
+) {
+    char** queries = NULL;
+    unsigned char** buffers = NULL;
+    int result = 1;
+
     int module_offset = 0;
     for (int i = 0; i < table->header->column_count; i++) {
-        if (GET_COLUMN_DATA_TYPE(table->columns[i]->type) == COLUMN_TYPE_MODULE) {
+        if (GET_COLUMN_DATA_TYPE(table->columns[i]->type) == COLUMN_TYPE_MODULE && (columns == NULL || columns[i])) {
             if (table->columns[i]->module_params == type || table->columns[i]->module_params == COLUMN_MODULE_BOTH) {
-                char* formula = table->columns[i]->module_querry;
-                char* output_querry = (char*)malloc(COLUMN_MODULE_SIZE);
-                if (!output_querry) return -1;
-                strncpy(output_querry, formula, COLUMN_MODULE_SIZE);
-
-                int content_offset = 0;
-                for (int j = 0; j < table->header->column_count; j++) {
-                    unsigned char* content_pointer = data + content_offset;
-                    char* content_part = (char*)malloc(table->columns[j]->size + 1);
-                    if (!content_part) {
-                        free(output_querry);
-                        return -2;
+                if (!queries) {
+                    queries = (char**)malloc(rows_count * sizeof(char*));
+                    buffers = (unsigned char**)malloc(rows_count * sizeof(unsigned char*));
+                    if (!queries || !buffers) {
+                        result = -1;
+                        break;
                     }
+                }
 
-                    strncpy(content_part, (char*)content_pointer, table->columns[j]->size);
-                    char* next_output_querry = strrep(output_querry, table->columns[j]->name, content_part);
+                // Queries of all rows collected first, because module can be invoked for all rows by one call
+                int count = 0;
+                module_program_t* program = table->programs ? table->programs[i] : NULL;
+                for (int row = 0; row < rows_count; row++) {
+                    unsigned char* row_data = rows + row * table->row_size;
+                    if (rows_count > 1 && *row_data == PAGE_EMPTY) continue;
+
+                    // Compiled query evaluated in place. Row, that can't be evaluated (not number), launches module.
+                    if (program && MDL_execute_program(program, row_data, row_data + module_offset, table->columns[i]->size) == 1) {
+                        QST_add(module_inline, 1);
+                        continue;
+                    }
 
-                    free(content_part);
-                    if (!next_output_querry) continue;
-                    free(output_querry);
+                    char* query = _get_module_query(table, row_data, i);
+                    if (!query) {
+                        result = -2;
+                        continue;
+                    }
 
-                    output_querry = (char*)next_output_querry;
-                    content_offset += table->columns[j]->size;
+                    queries[count] = query;
+                    buffers[count++] = row_data + module_offset;
                 }
 
-                MDL_launch_module(table->columns[i]->module_name, output_querry, data + module_offset, table->columns[i]->size);
+                if (count == 1) MDL_launch_module(table->columns[i]->module_name, queries[0], buffers[0], table->columns[i]->size);
+                else if (count > 1) MDL_launch_batch(table->columns[i]->module_name, queries, count, buffers, table->columns[i]->size);
+                for (int j = 0; j < count; j++) free(queries[j]);
             }
         }
 
         module_offset += table->columns[i]->size;
     }
 
-    return 1;
-}
\ No newline at end of file
+    SOFT_FREE(queries);
+    SOFT_FREE(buffers);
+    return result;
+}
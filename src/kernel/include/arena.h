@@ -0,0 +1,101 @@
+/*
+ *  License:
+ *  Copyright (C) 2024 Nikolaj Fot
+ *
+ *  This program is free software: you can redistribute it and/or modify it under the terms of
+ *  the GNU General Public License as published by the Free Software Foundation, version 3.
+ *  This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License along with this program.
+ *  If not, see https://www.gnu.org/licenses/.
+ *
+ *  Description:
+ *  This file is bump allocator for memory, that lives only while command processed. Every session
+ *  has own arena, that's why arena don't use locks. Allocation is pointer increment. Memory returned
+ *  by release to mark, that taken before allocations, so scoped buffers (page buffers, nested answers)
+ *  reused by next scope without system allocator. Release to start of arena (after answer sent)
+ *  returns all blocks except first to system.
+ *
+ *  CordellDBMS source code: https://github.com/j1sk1ss/CordellDBMS.EXMPL
+ *  Credits: j1sk1ss
+ */
+
+#ifndef ARENA_H_
+#define ARENA_H_
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "logging.h"
+
+
+#ifndef ARENA_BLOCK_SIZE
+    #define ARENA_BLOCK_SIZE 0x10000
+#endif
+
+#define ARENA_ALIGNMENT     16
+#define ARENA_ALIGN(size)   (((size) + ARENA_ALIGNMENT - 1) & ~((size_t)ARENA_ALIGNMENT - 1))
+
+
+typedef struct arena_block {
+    struct arena_block* next;
+    size_t size;
+    size_t offset;
+} arena_block_t;
+
+typedef struct {
+    arena_block_t* head;
+    arena_block_t* current;
+} arena_t;
+
+typedef struct {
+    arena_block_t* block;
+    size_t offset;
+} arena_mark_t;
+
+
+/*
+Allocate memory in arena. Memory don't zeroed.
+
+Params:
+- arena - Arena pointer.
+- size - Size of memory.
+
+Return NULL or pointer to memory, that valid until release to earlier mark.
+*/
+void* ARN_alloc(arena_t* arena, size_t size);
+
+/*
+Get current position of arena.
+
+Params:
+- arena - Arena pointer.
+
+Return mark for ARN_release.
+*/
+arena_mark_t ARN_mark(arena_t* arena);
+
+/*
+Release all memory, that allocated after mark. Release to start of arena also frees
+all blocks except first one.
+
+Params:
+- arena - Arena pointer.
+- mark - Mark from ARN_mark.
+
+Return 1.
+*/
+int ARN_release(arena_t* arena, arena_mark_t mark);
+
+/*
+Free all blocks of arena.
+
+Params:
+- arena - Arena pointer.
+
+Return 1.
+*/
+int ARN_free(arena_t* arena);
+
+#endif
@@ -25,6 +25,7 @@
 #include <stdlib.h>
 
 #include "common.h"
+#include "metrics.h"
 #include "threading.h"
 
 
@@ -0,0 +1,70 @@
+/*
+ *  License:
+ *  Copyright (C) 2024 Nikolaj Fot
+ *
+ *  This program is free software: you can redistribute it and/or modify it under the terms of
+ *  the GNU General Public License as published by the Free Software Foundation, version 3.
+ *  This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License along with this program.
+ *  If not, see https://www.gnu.org/licenses/.
+ *
+ *  Description:
+ *  This file is codec for page content on disk. Codec is LZ77 like: stream of literal runs and
+ *  back references. Reference with distance 1 is run of one byte, that's why space and empty padding
+ *  of rows packed to 3 bytes per CDC_MAX_MATCH bytes. Codec don't allocate memory.
+ *
+ *  Token format:
+ *  0b0LLLLLLL - literal run with L + 1 bytes after token.
+ *  0b1LLLLLLL DDDDDDDD DDDDDDDD - copy L + CDC_MIN_MATCH bytes from D + 1 bytes back.
+ *
+ *  CordellDBMS source code: https://github.com/j1sk1ss/CordellDBMS.EXMPL
+ *  Credits: j1sk1ss
+ */
+
+#ifndef CODEC_H_
+#define CODEC_H_
+
+#include <string.h>
+
+
+#define CDC_NONE        0x00
+#define CDC_LZ          0x01
+
+#define CDC_MIN_MATCH   3
+#define CDC_MAX_MATCH   (0x7F + CDC_MIN_MATCH)
+#define CDC_MAX_LITERAL 0x80
+#define CDC_MAX_DISTANCE 0xFFFF
+#define CDC_HASH_BITS   12
+
+
+/*
+Compress data with LZ codec.
+
+Params:
+- source - Data for compression.
+- source_size - Data size.
+- destination - Destination buffer.
+- capacity - Destination buffer size.
+
+Return -1 if compressed data don't fit into capacity.
+Return size of compressed data.
+*/
+int CDC_compress(const unsigned char* __restrict source, int source_size, unsigned char* __restrict destination, int capacity);
+
+/*
+Decompress data, that was compressed by CDC_compress.
+
+Params:
+- source - Compressed data.
+- source_size - Compressed data size.
+- destination - Destination buffer.
+- capacity - Destination buffer size.
+
+Return -1 if data broken or don't fit into capacity.
+Return size of decompressed data.
+*/
+int CDC_decompress(const unsigned char* __restrict source, int source_size, unsigned char* __restrict destination, int capacity);
+
+#endif
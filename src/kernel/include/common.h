@@ -93,6 +93,18 @@ Return 0 is not integer.
 */
 int is_integer(const char* str);
 
+/*
+Convert text of fixed size column to integer, like atoll. Text can be not null-terminated.
+Leading spaces and sign allowed, conversion stops on first non digit.
+
+Params:
+- str - Pointer to text.
+- size - Size of text.
+
+Return integer value.
+*/
+long long strntoll(const char* str, size_t size);
+
 /*
 Get current time from time.h libraryю
 !! Note: Output should be freed after usage. !!
@@ -101,6 +113,19 @@ Return char* of current time in format: "%Y-%m-%d %H:%M:%S".
 */
 char* get_current_time();
 
+/*
+Format time to buffer in format: "%Y-%m-%d %H:%M:%S".
+Note: Unlike get_current_time, can be used from many threads.
+
+Params:
+- seconds - Time for format.
+- buffer - Destination buffer.
+- buffer_size - Size of buffer.
+
+Return buffer.
+*/
+char* format_time(time_t seconds, char* buffer, size_t buffer_size);
+
 /*
 Get load path by name or path.
 
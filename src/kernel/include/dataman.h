@@ -98,6 +98,7 @@ we use cache in pages (lowest level) and table cache at the highest level.
     - access - User access level.
     - buffer - Destination place for data from table.
     - size - Size of content.
+    - columns - Columns mask for post-load modules (Check TBM_invoke_modules). Provide NULL for all columns.
 
     Return -3 if access denied.
     Return -2 if table nfound.
@@ -106,7 +107,53 @@ we use cache in pages (lowest level) and table cache at the highest level.
     */
     int DB_get_row(
         database_t* __restrict database, char* __restrict table_name, int row, unsigned char access, 
-        unsigned char* buffer, size_t buffer_size
+        unsigned char* buffer, size_t buffer_size, unsigned char* columns
+    );
+
+    /*
+    Get all rows from one page of table. Used by full table scans, instead getting rows one by one.
+    Note: Buffer should have PAGE_CONTENT_SIZE size. Empty slots in buffer marked by PAGE_EMPTY in first byte.
+    Note 2: Row with index i in page placed in buffer + i * row_size. Global row index is page * rows_count + i.
+
+    Params:
+    - database - Pointer to database. (If NULL, we don`t use database table cache).
+    - table_name - Current table name.
+    - page - Index of page in table.
+    - access - User access level.
+    - buffer - Destination place for page content.
+    - columns - Columns mask for post-load modules (Check TBM_invoke_modules). Provide NULL for all columns.
+                In table with PAX layout only these columns (and first column) readed from page.
+
+    Return -1 if access denied or table not found.
+    Return 0 if page not exists.
+    Return count of row slots in page.
+    */
+    int DB_get_page_rows(
+        database_t* __restrict database, char* __restrict table_name, int page, 
+        unsigned char access, unsigned char* buffer, unsigned char* columns
+    );
+
+    /*
+    Get zone maps of table page (Check TBM_get_page_zone). Used by scans for skipping pages without page I/O.
+
+    Params:
+    - database - Pointer to database. (If NULL, we don`t use database table cache).
+    - table_name - Current table name.
+    - page - Index of page in table.
+    - access - User access level.
+    - page_zone - Destination for page zone.
+    - directory_zone - Destination for zone of page directory.
+    - layout - Destination for zone layout.
+    - bloom - Destination for page Bloom filter with PAGE_BLOOM_SIZE size. Can be NULL.
+
+    Return -1 if access denied or table not found.
+    Return 0 if page not exists.
+    Return count of pages from this page to end of directory.
+    */
+    int DB_get_page_zone(
+        database_t* __restrict database, char* __restrict table_name, int page, unsigned char access,
+        page_zone_t* __restrict page_zone, page_zone_t* __restrict directory_zone, 
+        zone_layout_t* __restrict layout, unsigned char* __restrict bloom
     );
 
     /*
@@ -143,6 +190,34 @@ we use cache in pages (lowest level) and table cache at the highest level.
     */
     int DB_append_row(database_t* __restrict database, char* __restrict table_name, unsigned char* __restrict data, size_t data_size, unsigned char access);
 
+    /*
+    Append rows function is a bulk version of append row function. All rows validated before
+    any disk operation, auto increment values calculated once, and uniqueness of primary column
+    checked in one pass over table. Then rows placed to pages, that was build in memory.
+    Note: If any row in batch is wrong, nothing will be appended.
+    Note 2: Pointers shouldn't overlap each other!
+
+    Params:
+    - database - Pointer to database. (If NULL, we don`t use database table cache).
+    - table_name - Current table name.
+    - data - Array of rows for append.
+    - data_size - Array of row sizes.
+    - rows_count - Count of rows.
+    - access - User access level.
+
+    Return -20 if primary row check failed (In table or in batch).
+    Return -5 if data size != row size.
+    Return -4 if table not found in database.
+    Return -3 if rows write failed. Part of rows can be already written.
+    Return -1x if signature is wrong (Check TBM_check_signature function).
+    Return -1 if something goes wrong.
+    Return 1 if rows append was success.
+    */
+    int DB_append_rows(
+        database_t* __restrict database, char* __restrict table_name, 
+        unsigned char* data[], size_t data_size[], size_t rows_count, unsigned char access
+    );
+
     /*
     Insert row function works different with row_append function. Main difference in disabling auto-creation of pages and directories.
     Like in append_row, this function will check data signature, end return error code if it wrong.
@@ -194,6 +269,48 @@ we use cache in pages (lowest level) and table cache at the highest level.
     */
     int DB_delete_row(database_t* __restrict database, char* __restrict table_name, int row, unsigned char access);
 
+    /*
+    Check row data for update and invoke pre-load modules. Used by set-based update, where same data
+    written to many rows: data prepared once and then provided to DB_mutate_page for every page.
+    Note: Data changed in place.
+
+    Params:
+    - database - Pointer to database. (If NULL, we don`t use database table cache).
+    - table_name - Current table name.
+    - data - Row data.
+    - data_size - Size of row data.
+    - access - User access level.
+
+    Return -1 if access denied or table not found.
+    Return -5 if data smaller then table row.
+    Return -1x if signature is wrong (Check DB_insert_row).
+    Return 1 if data ready for write.
+    */
+    int DB_prepare_row(
+        database_t* __restrict database, char* __restrict table_name, unsigned char* __restrict data, size_t data_size, unsigned char access
+    );
+
+    /*
+    Set-based update / delete of rows in one page. Table resolved, locked and page loaded only once,
+    row count of table updated once per page.
+    Note: Data should be prepared by DB_prepare_row.
+
+    Params:
+    - database - Pointer to database. (If NULL, we don`t use database table cache).
+    - table_name - Current table name.
+    - page - Index of page in table.
+    - mask - Array with flag for every row slot in page (PAGE_CONTENT_SIZE / row_size).
+    - data - New row data, or NULL for delete.
+    - access - User access level.
+
+    Return -1 if access denied, table or page not found.
+    Return count of changed rows.
+    */
+    int DB_mutate_page(
+        database_t* __restrict database, char* __restrict table_name, int page, 
+        unsigned char* __restrict mask, unsigned char* __restrict data, unsigned char access
+    );
+
     /*
     Init cascade cleanup of empty directories and empty pages in all table in database.
     Note: This function, also, call sync fuinction like init_transaction method.
@@ -34,6 +34,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <limits.h>
 
 #ifndef _WIN32
     #include <unistd.h>
@@ -59,10 +60,25 @@
 #define PAGES_PER_DIRECTORY 128
 #define DIRECTORY_OFFSET    PAGES_PER_DIRECTORY * PAGE_CONTENT_SIZE
 
+// Count of int columns, that have min / max summary in zone maps.
+#define ZONE_COLUMNS        4
+
+// Max size of int column with zone summary or numeric Bloom key. Wider values can't be parsed from key buffer,
+// and filter will see other value then zone.
+#define ZONE_VALUE_SIZE     31
+
+// Count of columns, that can have Bloom filter, and size of one page filter in bytes.
+// One filter shared between all Bloom columns of page.
+#define BLOOM_COLUMNS       4
+#define PAGE_BLOOM_SIZE     256
+#define BLOOM_HASHES        3
+#define BLOOM_KEY_SIZE      256
+
 
 // We have *.dr bin file, where at start placed header
 //====================================================================================================================
-// HEADER (MAGIC | NAME | PAGE_COUNT | COLUMN_COUNT) -> | COLUMNS (TYPE | NAME, ... ) | PAGE_NAMES -> 8 * 256 -> end |
+// HEADER (MAGIC | NAME | PAGE_COUNT | COLUMN_COUNT) -> | COLUMNS (TYPE | NAME, ... ) | PAGE_NAMES -> 8 * 256 -> ...
+// ... | ZONE_LAYOUT | DIRECTORY_ZONE | PAGE_ZONES -> 128 * zone | PAGE_BLOOMS -> end |
 //====================================================================================================================
 
     typedef struct {
@@ -80,6 +96,35 @@
         unsigned int checksum;
     } directory_header_t;
 
+    typedef struct {
+        // Row size of table. 0 if directory don't have zone maps.
+        unsigned short row_size;
+
+        // Int columns in row, that have min / max summary
+        unsigned char column_count;
+        unsigned short offsets[ZONE_COLUMNS];
+        unsigned char sizes[ZONE_COLUMNS];
+
+        // Columns with Bloom filter. Int columns hashed by value, other columns by string.
+        unsigned char bloom_count;
+        unsigned short bloom_offsets[BLOOM_COLUMNS];
+        unsigned short bloom_sizes[BLOOM_COLUMNS];
+        unsigned char bloom_numeric[BLOOM_COLUMNS];
+    } zone_layout_t;
+
+    typedef struct {
+        // Zone invalid until page will be rewritten with known layout.
+        // Invalid zone can match anything.
+        unsigned char is_valid;
+
+        // Count of rows and empty row slots
+        unsigned short rows_count;
+        unsigned short empty_count;
+
+        int min[ZONE_COLUMNS];
+        int max[ZONE_COLUMNS];
+    } page_zone_t;
+
     typedef struct {
         // Lock directory flag
         unsigned short lock;
@@ -91,6 +136,19 @@
 
         // Page file names
         char page_names[PAGES_PER_DIRECTORY][PAGE_NAME_SIZE];
+
+        // Zone maps of pages and summary of whole directory.
+        // Placed in file after page names.
+        zone_layout_t zone_layout;
+        page_zone_t zones[PAGES_PER_DIRECTORY];
+        page_zone_t zone;
+
+        // Bloom filters of pages. Valid only with valid page zone.
+        // Deleted rows stay in filter until next write to page.
+        unsigned char blooms[PAGES_PER_DIRECTORY][PAGE_BLOOM_SIZE];
+
+        // Layout and codec of pages. Don't saved to file, because table set it before every access.
+        page_layout_t page_layout;
     } directory_t;
 
 
@@ -135,6 +193,76 @@
     */
     int DRM_cleanup_pages(directory_t* directory);
 
+    /*
+    Set zone layout of directory. If layout changed, all page zones will be invalid until
+    next write to page.
+    Note: Zones of written pages recomputed from page content on every append / insert / delete.
+
+    Params:
+    - directory - Pointer to directory.
+    - layout - Zone layout with table row size and int columns.
+
+    Return 1 if layout changed.
+    Return 0 if layout same.
+    */
+    int DRM_set_zone_layout(directory_t* __restrict directory, zone_layout_t* __restrict layout);
+
+    /*
+    Set layout of directory pages. Layout passed to every page, that loaded by directory.
+
+    Params:
+    - directory - Pointer to directory.
+    - layout - Page layout of table.
+
+    Return 1 if layout changed.
+    Return 0 if layout same.
+    */
+    int DRM_set_page_layout(directory_t* __restrict directory, page_layout_t* __restrict layout);
+
+    /*
+    Get row slots of page. In PAX directory only provided columns will be readed (Check PGM_get_columns).
+
+    Params:
+    - directory - Pointer to directory.
+    - index - Page index in directory.
+    - columns - Mask of columns or NULL for all columns.
+    - buffer - Destination with PAGE_CONTENT_SIZE size.
+
+    Return -1 if page not found.
+    Return 1 if read success.
+    */
+    int DRM_get_page_columns(
+        directory_t* __restrict directory, int index, unsigned char* __restrict columns, unsigned char* __restrict buffer
+    );
+
+    /*
+    Get Bloom key of value. String key is value without leading spaces, int key is value after atoi.
+    Note: Key generated in same way, as kernel compare values in expressions (eq for strings, = for ints).
+
+    Params:
+    - data - Value data.
+    - data_size - Value size. Value can be not NULL terminated.
+    - is_numeric - 1 for int key.
+    - key - Destination with BLOOM_KEY_SIZE size.
+
+    Return key size.
+    */
+    int DRM_get_bloom_key(unsigned char* __restrict data, size_t data_size, int is_numeric, unsigned char* __restrict key);
+
+    /*
+    Check Bloom filter of page.
+
+    Params:
+    - bloom - Page Bloom filter.
+    - column - Index of Bloom column in zone layout.
+    - key - Key from DRM_get_bloom_key.
+    - key_size - Key size.
+
+    Return 0 if page don't contain this value.
+    Return 1 if page may contain this value.
+    */
+    int DRM_bloom_may_contain(unsigned char* __restrict bloom, int column, unsigned char* __restrict key, int key_size);
+
     /*
     Append content to directory. This function move page_end symbol to new location.
     Note: If it can't append to existed pages, it creates new one.
@@ -155,6 +283,42 @@
     */
     int DRM_append_content(directory_t* __restrict directory, unsigned char* __restrict data, size_t data_lenght);
 
+    /*
+    Append a set of rows to directory. In difference with DRM_append_content, this function
+    fills empty row slots in linked pages, then builds new pages in memory and saves each of them once.
+    Note: Rows should be placed in data one by one without any separators.
+    Note 2: New pages don't go to GCT.
+
+    Params:
+    - directory - Pointer to directory.
+    - data - Rows for append.
+    - row_size - Size of one row.
+    - rows_count - Count of rows in data.
+
+    Return -2 if we can't create uniqe name for page.
+    Return count of rows, that was appended to this directory.
+    */
+    int DRM_append_rows(directory_t* __restrict directory, unsigned char* __restrict data, size_t row_size, size_t rows_count);
+
+    /*
+    Apply one change to set of rows in page. Page loaded and locked once, then all marked slots
+    rewritten by data (or marked as empty, if data is NULL). Page zone and free space updated once.
+    Note: Empty slots are ignored even if they marked.
+
+    Params:
+    - directory - Pointer to directory.
+    - index - Page index in directory.
+    - mask - Array with flag for every row slot in page (PAGE_CONTENT_SIZE / row_size).
+    - row_size - Size of one row.
+    - data - New row data with row_size size, or NULL for delete.
+
+    Return -1 if page not found.
+    Return count of changed rows.
+    */
+    int DRM_mutate_page(
+        directory_t* __restrict directory, int index, unsigned char* __restrict mask, size_t row_size, unsigned char* __restrict data
+    );
+
     /*
     Insert content to directory. This function don't move page_end in first empty page symbol to new location.
     Note: This function don't give ability for creation new pages. If content too large - it will trunc.
@@ -300,7 +464,7 @@
 
     /*
     Generate directory checksum. Checksum is sum of all bytes of directory name,
-    all bytes of page names.
+    all bytes of page names and zone maps.
 
     Params:
     - directory - directory pointer.
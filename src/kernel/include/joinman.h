@@ -0,0 +1,160 @@
+/*
+ *  License:
+ *  Copyright (C) 2024 Nikolaj Fot
+ *
+ *  This program is free software: you can redistribute it and/or modify it under the terms of
+ *  the GNU General Public License as published by the Free Software Foundation, version 3.
+ *  This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License along with this program.
+ *  If not, see https://www.gnu.org/licenses/.
+ *
+ *  Description:
+ *  Joinman - list of functions for hash join of two row sets.
+ *  We can:
+ *      - Build hash table from rows of smaller table
+ *      - Probe hash table with rows of larger table
+ *      - Partition both sides to temporary pages, if build side don't fit into memory budget
+ *
+ *  Joinman use sortman runs for temporary pages. Every partition readed only once and deleted
+ *  after reading.
+ *
+ *  CordellDBMS source code: https://github.com/j1sk1ss/CordellDBMS.EXMPL
+ *  Credits: j1sk1ss
+*/
+
+#ifndef JOINMAN_H_
+#define JOINMAN_H_
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "common.h"
+#include "logging.h"
+#include "pageman.h"
+#include "sortman.h"
+
+
+// Memory budget of build side in pages. Bigger build side will be partitioned.
+#ifndef JOIN_BUFFER_PAGES
+    #define JOIN_BUFFER_PAGES 16
+#endif
+
+#define JOIN_BUFFER_SIZE    (JOIN_BUFFER_PAGES * PAGE_CONTENT_SIZE)
+#define JOIN_PARTITIONS     16
+#define JOIN_KEY_SIZE       256
+#define JOIN_NUMERIC_KEY    1
+// Keys are native little-endian values of binary columns. Integer keys of 4 bytes extended to 8 bytes.
+#define JOIN_BINARY_KEY     2
+
+
+    typedef struct {
+        // Entry index equals to row index in build buffer
+        unsigned int hash;
+        int next;
+    } join_entry_t;
+
+    typedef struct {
+        int offset;
+        int size;
+        size_t row_size;
+    } join_side_t;
+
+    typedef struct {
+        join_side_t build;
+        join_side_t probe;
+        unsigned char flags;
+
+        // In-memory hash table of build rows
+        unsigned char* buffer;
+        join_entry_t* entries;
+        int* buckets;
+        size_t rows_count;
+        size_t rows_capacity;
+        size_t bucket_count;
+
+        // Partitions on disk. Used only when build side don't fit into memory budget.
+        unsigned char is_partitioned;
+        sort_run_t build_partitions[JOIN_PARTITIONS];
+        sort_run_t probe_partitions[JOIN_PARTITIONS];
+        page_t* build_pages[JOIN_PARTITIONS];
+        page_t* probe_pages[JOIN_PARTITIONS];
+    } joiner_t;
+
+
+/*
+Create joiner. Keys compared as trimmed strings or as ints, if JOIN_NUMERIC_KEY provided.
+
+Params:
+- build_row_size - Row size of build side (smaller table).
+- build_key_offset - Join key offset in build row.
+- build_key_size - Join key size in build row.
+- probe_row_size - Row size of probe side (larger table).
+- probe_key_offset - Join key offset in probe row.
+- probe_key_size - Join key size in probe row.
+- flags - JOIN_NUMERIC_KEY for int keys, JOIN_BINARY_KEY for binary keys.
+
+Return NULL if something goes wrong.
+Return pointer to joiner.
+*/
+joiner_t* JNM_create_joiner(
+    size_t build_row_size, int build_key_offset, int build_key_size,
+    size_t probe_row_size, int probe_key_offset, int probe_key_size, unsigned char flags
+);
+
+/*
+Add row to build side. Row will be copied.
+Note: If memory budget exceeded, all build rows will be moved to partitions on disk.
+
+Params:
+- joiner - Pointer to joiner.
+- row - Build row.
+
+Return -1 if something goes wrong.
+Return 1 if row added.
+*/
+int JNM_add_build_row(joiner_t* __restrict joiner, unsigned char* __restrict row);
+
+/*
+Probe build side with row. If build side in memory, matches will be sent to output immediately.
+In other case row will be saved to probe partition and joined in JNM_finish.
+
+Params:
+- joiner - Pointer to joiner.
+- row - Probe row.
+- output - Output function. Takes context, build row and probe row.
+           If output function return not 1, join will stop.
+- ctx - Context for output function.
+
+Return -1 if something goes wrong.
+Return 0 if output stopped join.
+Return 1 if row processed.
+*/
+int JNM_probe_row(joiner_t* joiner, unsigned char* row, int (*output)(void*, unsigned char*, unsigned char*), void* ctx);
+
+/*
+Join partitions on disk. If joiner not partitioned, do nothing.
+
+Params:
+- joiner - Pointer to joiner.
+- output - Output function (Check JNM_probe_row).
+- ctx - Context for output function.
+
+Return -1 if something goes wrong.
+Return 1 if join complete.
+*/
+int JNM_finish(joiner_t* joiner, int (*output)(void*, unsigned char*, unsigned char*), void* ctx);
+
+/*
+Free joiner and delete all temporary partitions.
+
+Params:
+- joiner - Pointer to joiner.
+
+Return 1 if free success.
+*/
+int JNM_free_joiner(joiner_t* joiner);
+
+#endif
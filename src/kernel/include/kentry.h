@@ -33,11 +33,17 @@
 
 #include <string.h>
 #include <stdio.h>
+#include <stdarg.h>
+#include <limits.h>
 
 #include "common.h"
 #include "sighandler.h"
 #include "dataman.h"
+#include "sortman.h"
+#include "joinman.h"
 #include "cache.h"
+#include "arena.h"
+#include "metrics.h"
 
 
 #define SAFE_GET_VALUE(argv, max, index)            index >= max ? NULL : argv[index]
@@ -51,6 +57,25 @@
 #define MAX_COMMANDS    100
 #define MAX_STATEMENTS  20
 #define MAX_CONNECTIONS 5
+#define MAX_PROJECTIONS 32
+#define MAX_COLUMNS     0xFF
+#define MAX_PREPARED    8
+#define MAX_BATCH_STATEMENTS 0x4000
+
+#define STATEMENT_NAME_SIZE 16
+
+// Answer size limit. Bigger results should be readed with cursor.
+#define MAX_ANSWER_SIZE     0x1000000
+// Maximum size of one cursor fetch answer.
+#define CURSOR_FETCH_SIZE   0x8000
+
+// Widest aggregate value is average of i64 values: 20 symbols, point and 4 digits
+#define AGGREGATE_VALUE_SIZE 25
+#define AGGREGATE_COUNT      0
+#define AGGREGATE_SUM        1
+#define AGGREGATE_MIN        2
+#define AGGREGATE_MAX        3
+#define AGGREGATE_AVG        4
 
 #pragma region [Commands]
 
@@ -63,21 +88,50 @@
     #define APPEND          "append"
     #define UPDATE          "update"
     #define GET             "get"
+    #define OPEN            "open"
+    #define FETCH           "fetch"
+    #define CLOSE           "close"
+    #define CURSOR          "cursor"
+    #define PREPARE         "prepare"
+    #define EXECUTE         "execute"
+    #define STATEMENT       "statement"
+    #define PARAMETER       "?"
+    #define EXPLAIN         "explain"
+    #define ANALYZE         "analyze"
+    #define BATCH           "batch"
+    #define ATOMIC          "atomic"
+    #define END             "end"
+    #define BATCH_SEPARATOR ";"
 
     #define TABLE           "table"
     #define DATABASE        "database"
     #define VERSION         "version"
+    #define STATS           "stats"
 
     #define NAV             "nav"
     #define COLUMNS         "columns"
+    #define BLOOM           "bloom"
+    #define LAYOUT          "layout"
+    #define LAYOUT_PAX      "pax"
+    #define COMPRESS        "compress"
+    #define CODEC_LZ        "lz"
     #define COLUMN          "column"
     #define VALUES          "values"
     #define VALUE           "value"
     #define EXPRESSION      "exp"
     #define ROW             "row"
+    #define ROWS            "rows"
     #define OFFSET          "offset"
     #define LIMIT           "limit"
 
+    #define JOIN            "join"
+    #define ON              "on"
+    #define GROUP           "group"
+    #define ORDER           "order"
+    #define BY              "by"
+    #define ASCENDING       "asc"
+    #define DESCENDING      "desc"
+
     #define BY_INDEX        "by_index"
     #define BY_EXPRESSION   "by_exp"
 
@@ -92,6 +146,10 @@
         #define TYPE_MODULE "mod"
         #define TYPE_STRING "str"
         #define TYPE_ANY    "any"
+        #define TYPE_I32    "i32"
+        #define TYPE_I64    "i64"
+        #define TYPE_F64    "f64"
+        #define TYPE_DEC    "decimal"
 
         #define MODULE_PRELOAD   "mpre"
         #define MODULE_POSTLOAD  "mpost"
@@ -113,6 +171,16 @@
 
     #pragma endregion
 
+    #pragma region [Aggregates]
+
+        #define COUNT   "count"
+        #define SUM     "sum"
+        #define MINIMUM "min"
+        #define MAXIMUM "max"
+        #define AVERAGE "avg"
+
+    #pragma endregion
+
     #define PRIMARY         "p"
     #define NPRIMART        "np"
     #define AUTO_INC        "a"
@@ -125,8 +193,15 @@
 
 typedef struct {
     signed char answer_code;
-    unsigned short answer_size;
+    unsigned int answer_size;
     unsigned char* answer_body;
+
+    // Allocated size of answer body
+    unsigned int answer_capacity;
+
+    // Session arena and position before answer. Free of answer releases all command memory.
+    arena_t* arena;
+    arena_mark_t mark;
 } kernel_answer_t;
 
 typedef struct {
@@ -135,6 +210,54 @@ typedef struct {
     char* value;
 } condition_t;
 
+typedef struct {
+    table_columns_info_t columns[MAX_PROJECTIONS];
+    int column_count;
+
+    // Size of projected row in answer
+    int size;
+
+    // Mask of table columns, that will be read by query
+    unsigned char mask[MAX_COLUMNS];
+} projection_t;
+
+typedef struct {
+    unsigned char* key;
+    long long count;
+    long long sum;
+    long long min;
+    long long max;
+
+    // F64 values aggregated without conversion to fixed point
+    double real_sum;
+    double real_min;
+    double real_max;
+} aggregate_group_t;
+
+typedef struct {
+    aggregate_group_t* groups;
+    int group_count;
+    int capacity;
+} aggregate_state_t;
+
+typedef struct {
+    unsigned char function;
+    table_columns_info_t column;
+
+    // Group column. If size is 0, all rows aggregated in one group
+    table_columns_info_t group;
+
+    // Mask of table columns, that will be read by query
+    unsigned char mask[MAX_COLUMNS];
+} aggregate_t;
+
+typedef struct {
+    kernel_answer_t* answer;
+    table_t* table;
+    projection_t* projection;
+} sort_output_t;
+
+
 typedef struct {
     condition_t conditions[MAX_STATEMENTS];
     int condition_count;
@@ -144,6 +267,56 @@ typedef struct {
     int limit;
 } expression_t;
 
+typedef struct {
+    // Copy of open command. Expression values point to these strings.
+    char* commands[MAX_COMMANDS];
+    int argc;
+
+    char table_name[TABLE_NAME_SIZE + 1];
+    expression_t exp;
+    projection_t projection;
+
+    // Scan state. Page buffer is only memory, that cursor holds between fetches (page re-readed by next fetch).
+    int page;
+    int slot;
+    int rows_count;
+    int processed_rows;
+    unsigned char is_done;
+    unsigned char* page_buffer;
+} cursor_t;
+
+typedef struct {
+    char name[STATEMENT_NAME_SIZE + 1];
+
+    // Copy of prepared command. Parameters marked by PARAMETER token.
+    char* commands[MAX_COMMANDS];
+    int argc;
+    int param_count;
+
+    // Cached plan for get row by_exp. Statement without plan executed as regular command
+    // with parameters placed into command.
+    unsigned char has_plan;
+    char table_name[TABLE_NAME_SIZE + 1];
+    int row_size;
+    expression_t exp;
+    projection_t projection;
+
+    // Parameter index for every condition value. -1 if value is constant.
+    int params[MAX_STATEMENTS];
+} statement_t;
+
+typedef struct {
+    kernel_answer_t* answer;
+    expression_t* exp;
+    table_t* first;
+    table_t* second;
+    unsigned char* row;
+    size_t first_size;
+    size_t second_size;
+    int build_is_first;
+    int count;
+} join_output_t;
+
 
 /*
 Process commands and return answer structure.
@@ -20,11 +20,33 @@
  #include <stdio.h>
  #include <stdarg.h>
  #include <time.h>
+ #include <limits.h>
+ #ifndef _WIN32
+     #include <unistd.h>
+     #include <sched.h>
+ #endif
  
  #include "threading.h"
  #include "common.h"
  
  
+ /*
+ Log records placed by producers to ring without locks (slot with sequence number, that shows state of slot).
+ Writer thread formats records and writes them in batches, and sleeps on condition, when ring is empty.
+ Without threads record written by thread, that logged it.
+ If ring is full, record dropped (and counted), or producer waits for free slot with LOG_BLOCK_ON_OVERFLOW.
+ */
+ #ifndef LOG_RING_SIZE
+     #define LOG_RING_SIZE   256
+ #endif
+ 
+ #if (LOG_RING_SIZE & (LOG_RING_SIZE - 1)) != 0
+     #error "LOG_RING_SIZE should be power of two"
+ #endif
+ 
+ #define LOG_MESSAGE_SIZE    512
+ #define LOG_BATCH_SIZE      0x4000
+ 
  // Note: LOG_TO_FILE option very heavy function. Prefere console logging, if your host machine can do this.
  // If you use micro controller, use LOG_TO_FILE with disabled DEBUG, LOGGING, INFORMING and SPECIAL.
  // #define LOG_TO_FILE
@@ -83,8 +105,20 @@
  #endif
  
  
+ typedef struct {
+     // Position of ring, that slot ready for. Stored relative to slot index, that's why zeroed ring is ready.
+     size_t sequence;
+     const char* level;
+     const char* file;
+     int line;
+     time_t time;
+     char message[LOG_MESSAGE_SIZE];
+ } log_record_t;
+ 
+ 
  /*
- Write log to file descriptor.
+ Put log record to ring. Message formatted by producer, prefix and time formatted by writer.
+ Level and file saved as pointers, that's why they should be string literals.
  
  Params:
  - level - Log level.
@@ -105,4 +139,9 @@
  */
  void log_message(const char* level, const char* file, int line, const char* message, ...);
  
+ /*
+ Write all records from ring. Called at exit, because writer thread can have unwritten records.
+ */
+ void log_flush();
+ 
  #endif
\ No newline at end of file
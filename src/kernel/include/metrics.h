@@ -0,0 +1,120 @@
+/*
+ *  License:
+ *  Copyright (C) 2024 Nikolaj Fot
+ *
+ *  This program is free software: you can redistribute it and/or modify it under the terms of
+ *  the GNU General Public License as published by the Free Software Foundation, version 3.
+ *  This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License along with this program.
+ *  If not, see https://www.gnu.org/licenses/.
+ *
+ *  Description:
+ *  This file is server metrics registry. Unlike qstats, metrics are global for all sessions and
+ *  never reset. Counters and histograms updated with atomic operations, so hot paths don't take locks.
+ *  Command slot registered on first use by compare-and-swap of command name.
+ *
+ *  Latency histogram is HDR-like: values below 2^MTR_SUB_BITS have own bucket, every next power of two
+ *  splitted to 2^MTR_SUB_BITS buckets. That's why relative error of percentile is below 1 / 2^MTR_SUB_BITS.
+ *
+ *  CordellDBMS source code: https://github.com/j1sk1ss/CordellDBMS.EXMPL
+ *  Credits: j1sk1ss
+ */
+
+#ifndef METRICS_H_
+#define METRICS_H_
+
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+
+
+#define MTR_CACHE_HITS      0
+#define MTR_CACHE_MISSES    1
+#define MTR_PAGE_LOADS      2
+#define MTR_PAGE_SAVES      3
+#define MTR_FSYNCS          4
+#define MTR_LOCK_ACQUIRES   5
+#define MTR_LOCK_WAITS      6
+#define MTR_LOCK_TIMEOUTS   7
+#define MTR_COUNTERS        8
+
+#define MTR_MAX_COMMANDS    32
+#define MTR_OTHER_COMMAND   "other"
+#define MTR_SUB_BITS        3
+// Latency values in microseconds. Bigger values placed to last bucket.
+#define MTR_MAX_MAGNITUDE   40
+#define MTR_BUCKETS         ((MTR_MAX_MAGNITUDE - MTR_SUB_BITS + 2) << MTR_SUB_BITS)
+
+// Size of buffer, that enough for text of all metrics
+#define MTR_TEXT_SIZE       0x8000
+
+
+typedef struct {
+    const char* name;
+    unsigned long long count;
+    unsigned long long errors;
+    unsigned long long sum;
+    unsigned long long max;
+    unsigned long long buckets[MTR_BUCKETS];
+} metric_command_t;
+
+
+/*
+Increment counter.
+
+Params:
+- counter - Counter index (MTR_CACHE_HITS, etc).
+- value - Increment.
+
+Return 1.
+*/
+int MTR_add(int counter, unsigned long long value);
+
+/*
+Record processed command.
+
+Params:
+- name - Command name. Name should live until program end (string literal).
+- time - Processing time in microseconds.
+- is_error - 1 if command failed.
+
+Return -1 if no free command slot, or 1.
+*/
+int MTR_command(const char* name, unsigned long long time, int is_error);
+
+/*
+Get percentile of command latency.
+
+Params:
+- command - Command slot.
+- percentile - Percentile (0.0 - 1.0).
+
+Return upper bound of bucket with percentile in microseconds.
+*/
+unsigned long long MTR_get_percentile(metric_command_t* command, double percentile);
+
+/*
+Write all metrics in human readable format.
+
+Params:
+- buffer - Destination.
+- buffer_size - Size of destination.
+
+Return size of text.
+*/
+int MTR_get_text(char* buffer, size_t buffer_size);
+
+/*
+Write all metrics in Prometheus text exposition format.
+
+Params:
+- buffer - Destination.
+- buffer_size - Size of destination.
+
+Return size of text.
+*/
+int MTR_get_prometheus(char* buffer, size_t buffer_size);
+
+#endif
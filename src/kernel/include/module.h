@@ -14,8 +14,16 @@
 #ifndef MODULE_H_
 #define MODULE_H_
 
+// Linux has pipe2, that creates worker pipes with close-on-exec flag
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+    #define _GNU_SOURCE
+#endif
+
+#include <limits.h>
+
 #include "logging.h"
 #include "common.h"
+#include "qstats.h"
 
 #ifdef _WIN32
     #define popen   _popen
@@ -24,20 +32,174 @@
     #define WEXITSTATUS(status) (((status) & 0xFF00) >> 8)
     #define WIFEXITED(status) (((status) & 0xFF) == 0)
 
+    // Shared modules loaded by LoadLibrary in future. Now windows build uses only executable modules.
+    #define NO_SHARED_MODULES
 #else
     #include <sys/wait.h>
+    #include <unistd.h>
+    #include <signal.h>
+    #include <fcntl.h>
+    #include <poll.h>
+    #ifndef NO_SHARED_MODULES
+        #include <dlfcn.h>
+    #endif
 #endif
 
 
 #define MODULE_NAME_SIZE    8
 #define MODULE_EXTENSION    ENV_GET("MODULE_EXTENSION", "mdl")
+#define MODULE_SHARED_EXTENSION ENV_GET("MODULE_SHARED_EXTENSION", "so")
 #define MODULE_BASE_PATH    ENV_GET("MODULE_BASE_PATH", "")
 
+// Maximum count of modules, that kernel keeps loaded.
+#define MODULE_CACHE_SIZE   16
+#define MODULE_MAX_ARGS     16
+#define MODULE_ANSWER_SIZE  128
+#define MODULE_SUCCESS      100
+#define MODULE_DETERMINISTIC 0x01
+// Kernel flag of executable module, that don't support batch protocol
+#define MODULE_NO_BATCH     0x80
+// Kernel flag of executable module, that can't be kept alive (don't flush answers)
+#define MODULE_NO_WORKER    0x40
+
+// Max tuples in one batch call. Requests and answers of batch should fit into pipe buffers.
+#define MODULE_BATCH_SIZE   64
+#define MODULE_BATCH_FLAG   "--batch"
+#define MODULE_ARGS_SIZE    256
+
+// Count of persistent processes of every executable module. 0 - launch module for every batch.
+#ifndef MODULE_WORKERS
+    #define MODULE_WORKERS 4
+#endif
+
+// Time in milliseconds, that kernel waits answer from module process
+#define MODULE_ANSWER_TIMEOUT 5000
+
+// Memory budget of module results cache in bytes. 0 - disable cache.
+#ifndef MODULE_MEMO_SIZE
+    #define MODULE_MEMO_SIZE 65536
+#endif
+
+// Longer arguments don't cached
+#define MODULE_MEMO_ARGS    128
+
+
+// Module, that kernel evaluates by itself, if column query can be compiled (see MDL_compile_program)
+#define MODULE_INLINE_CALC  "calc"
+#define MODULE_PROGRAM_SIZE 32
+#define MODULE_STACK_SIZE   32
+
+#define MODULE_OP_CONST     0x00
+#define MODULE_OP_COLUMN    0x01
+#define MODULE_OP_ADD       0x02
+#define MODULE_OP_SUB       0x03
+#define MODULE_OP_MUL       0x04
+#define MODULE_OP_DIV       0x05
+#define MODULE_OP_MOD       0x06
+#define MODULE_OP_POW       0x07
+
+// Kind of column value, that loaded by MODULE_OP_COLUMN
+#define MODULE_OPERAND_TEXT 0x00
+#define MODULE_OPERAND_I32  0x01
+#define MODULE_OPERAND_I64  0x02
+
+
+#define MODULE_INIT     "mdl_init"
+#define MODULE_INVOKE   "mdl_invoke"
+#define MODULE_FREE     "mdl_free"
+#define MODULE_FLAGS    "mdl_flags"
+#define MODULE_BATCH    "mdl_invoke_batch"
+
+typedef int (*module_init_t)();
+typedef int (*module_invoke_t)(int, char**, char*, size_t);
+typedef void (*module_free_t)();
+typedef int (*module_flags_t)();
+typedef int (*module_batch_t)(int, int*, char***, char*, size_t, int*);
+
+/*
+Persistent process of executable module. Process serves batch protocol until input closed.
+*/
+typedef struct {
+    int pid;
+    int input;
+    int output;
+    unsigned char busy;
+    unsigned char served;
+} module_worker_t;
+
+typedef struct {
+    char name[MODULE_NAME_SIZE + 1];
+
+    // Handle of shared object. If NULL, module launched as executable.
+    void* handle;
+    module_invoke_t invoke;
+    module_batch_t invoke_batch;
+    module_free_t free;
+
+    // Flags from mdl_flags. Executable modules have only kernel flags.
+    unsigned char flags;
+
+#if MODULE_WORKERS > 0
+    // Started processes of executable module. Worker with pid 0 will be started with next call.
+    module_worker_t workers[MODULE_WORKERS];
+#endif
+} module_t;
+
+/*
+Results cache entry. Cache is direct-mapped: new result replaces entry with same slot.
+*/
+typedef struct {
+    unsigned int hash;
+    module_t* module;
+    char args[MODULE_MEMO_ARGS];
+    char result[MODULE_ANSWER_SIZE];
+} module_memo_t;
+
+/*
+Column of row, that can be used in compiled query.
+*/
+typedef struct {
+    char* name;
+    size_t name_size;
+    unsigned short offset;
+    unsigned short size;
+    unsigned char type;
+} module_operand_t;
+
+typedef struct {
+    unsigned char opcode;
+    unsigned char type;
+    unsigned short size;
+    unsigned short offset;
+    long long value;
+} module_instruction_t;
+
+/*
+Compiled column query. Instructions executed by stack machine in kernel process.
+*/
+typedef struct {
+    unsigned char count;
+    module_instruction_t code[MODULE_PROGRAM_SIZE];
+} module_program_t;
+
+typedef struct {
+    unsigned long long hits;
+    unsigned long long misses;
+    unsigned int entries;
+    unsigned int capacity;
+} module_memo_stats_t;
+
 
 /*
 Launch module by provided name.
+Module with shared object (<name>.so with mdl_init, mdl_invoke and mdl_free, see modules/mdl.h) loaded once
+and invoked in kernel process. Otherwise executable module (<name>.mdl) launched for every call.
 Note: Module should return 100 exit code. If it don't,
 dbms will ignore result.
+Note 2: Kind of module resolved with first call. New shared object will be used after restart.
+Note 3: Answers of deterministic shared modules (mdl_flags returns MDL_DETERMINISTIC) cached by module name and args.
+Note 4: Executable module with batch protocol started once and kept alive (MODULE_WORKERS processes for concurrent
+        sessions). Crashed or hung worker killed and started again with next call.
 
 Params:
 - module_name - Module name.
@@ -53,4 +215,82 @@ Return 1 if launch and answer was success.
 */
 int MDL_launch_module(char* module_name, char* args, unsigned char* buffer, size_t buffer_size);
 
+/*
+Launch module for many argument tuples at once. Shared module invoked with mdl_invoke_batch (or mdl_invoke
+for every tuple). Executable module receives MODULE_BATCH_SIZE tuples per exchange with framed protocol on
+stdin / stdout (see modules/mdl.h). Exchange goes to free worker of module, or to new process, that launched
+with MODULE_BATCH_FLAG argument only for this exchange. If executable module don't support protocol,
+it will be launched for every tuple.
+
+Params:
+- module_name - Module name.
+- args - Arguments for every tuple.
+- count - Tuples count.
+- buffers - Places for answers of every tuple.
+- buffer_size - Size of one answer.
+
+Return -1 if module not found.
+Return 1 if launch was success.
+*/
+int MDL_launch_batch(char* module_name, char* args[], int count, unsigned char* buffers[], size_t buffer_size);
+
+/*
+Compile column query of module to bytecode. Only arithmetic queries of MODULE_INLINE_CALC module
+(numbers, column names, + - * / % ^ and parentheses) can be compiled. Column names resolved to row offsets here,
+that's why row values don't substituted to query text at invoke.
+
+Params:
+- module_name - Module name.
+- query - Column query. Can be not null-terminated.
+- query_size - Max size of query.
+- operands - Columns of row.
+- operands_count - Columns count.
+
+Return NULL if query can't be compiled. In this case module should be launched.
+Return allocated program.
+*/
+module_program_t* MDL_compile_program(
+    char* __restrict module_name, char* __restrict query, size_t query_size, module_operand_t* __restrict operands, int operands_count
+);
+
+/*
+Execute compiled program for row. Answer placed to buffer in same way, as answer of launched module.
+
+Params:
+- program - Compiled program.
+- row - Row data with columns from MDL_compile_program.
+- buffer - Place for answer.
+- buffer_size - Size of answer.
+
+Return -1 if row value isn't number, or if result can't be calculated (division by zero). Buffer don't changed.
+Return 1 if answer placed.
+*/
+int MDL_execute_program(module_program_t* __restrict program, unsigned char* __restrict row, unsigned char* __restrict buffer, size_t buffer_size);
+
+/*
+Get statistics of module results cache.
+
+Params:
+- stats - Destination for statistics.
+
+Return 1.
+*/
+int MDL_get_memo_stats(module_memo_stats_t* stats);
+
+/*
+Prepare module launcher. Should be called once at kernel start, before any session.
+Note: SIGPIPE ignored here, because module can exit before all requests written. Write error is better then kernel termination.
+
+Return 1.
+*/
+int MDL_init();
+
+/*
+Unload all shared modules. mdl_free will be invoked for every module.
+Workers of executable modules stopped, results cache will be released too.
+
+Return 1.
+*/
+int MDL_unload_modules();
+
 #endif
@@ -47,6 +47,8 @@
 #include "logging.h"
 #include "common.h"
 #include "cache.h"
+#include "qstats.h"
+#include "codec.h"
 
 
 #define PAGE_EXTENSION  ENV_GET("PAGE_EXTENSION", "pg")
@@ -65,6 +67,31 @@
 
 #pragma endregion
 
+#pragma region [Page layout]
+
+    // Rows placed one after another
+    #define PAGE_LAYOUT_ROWS    0x00
+    // Values of every column placed together (minipages). Column minipage starts at column offset * rows per page.
+    #define PAGE_LAYOUT_PAX     0x01
+    #define PAGE_LAYOUT_COLUMNS 0xFF
+
+    /*
+    Page layout provided by table. Higher levels always address page content as rows one after another,
+    and pageman translates this offsets to place in PAX page.
+    */
+    typedef struct {
+        unsigned char type;
+        unsigned short row_size;
+        unsigned char column_count;
+
+        // Codec of page content on disk (CDC_NONE or CDC_LZ).
+        unsigned char codec;
+        unsigned short offsets[PAGE_LAYOUT_COLUMNS];
+        unsigned short sizes[PAGE_LAYOUT_COLUMNS];
+    } page_layout_t;
+
+#pragma endregion
+
 #define PAGE_MAGIC 0xCA
 // 64^6 = 56.800.235.584 - unique page names.
 // 64^6 * PAGE_CONTENT_SIZE = 211 TB
@@ -84,6 +111,11 @@
         // With this name we can save pages / compare pages
         char name[PAGE_NAME_SIZE];
 
+        // Codec of content in file and size of content in file.
+        // Placed in header padding, that's why old pages have CDC_NONE codec.
+        unsigned char codec;
+        unsigned short content_size;
+
         // Table checksum
         unsigned int checksum;
     } page_header_t;
@@ -97,6 +129,12 @@
         page_header_t* header;
         short append_offset;
 
+        // Layout of directory, that owns page. Set by dirman before every access, NULL for row pages.
+        page_layout_t* layout;
+
+        // Codec, that will be used for next save. Set by dirman from table. Cache keeps page uncompressed.
+        unsigned char codec;
+
         // Page content
         unsigned char content[PAGE_CONTENT_SIZE];
         char* base_path;
@@ -199,6 +237,30 @@
     */
     int PGM_get_fit_free_space(page_t* page, int offset, int size);
 
+    /*
+    Get place of byte in page content. Offset provided as in page with rows layout.
+
+    Params:
+    - page - pointer to page
+    - offset - offset in page
+
+    Return index in page content.
+    */
+    int PGM_get_physical_offset(page_t* page, int offset);
+
+    /*
+    Copy row slots of page to buffer with rows layout. In PAX page only minipages of provided columns 
+    (and first column, that marks empty rows) will be readed. Other columns in buffer stay untouched.
+
+    Params:
+    - page - pointer to page
+    - columns - Mask of columns for read. Provide NULL for reading of all columns.
+    - buffer - Destination with PAGE_CONTENT_SIZE size.
+
+    Return 1.
+    */
+    int PGM_get_columns(page_t* __restrict page, unsigned char* __restrict columns, unsigned char* __restrict buffer);
+
 #pragma endregion
 
 #pragma region [Page]
@@ -233,7 +295,7 @@
     page_t* PGM_create_empty_page(char* base_path);
 
     /*
-    Save page on disk.
+    Save page on disk. If page has codec and compressed content smaller, compressed content will be saved.
 
     Params:
     - page - pointer to page.
@@ -247,7 +309,7 @@
     int PGM_save_page(page_t* page);
 
     /*
-    Open file, load page, close file
+    Open file, load page, close file. Compressed content will be decompressed.
 
     Params:
     - base_path - Base path of page.
@@ -0,0 +1,114 @@
+/*
+ *  License:
+ *  Copyright (C) 2024 Nikolaj Fot
+ *
+ *  This program is free software: you can redistribute it and/or modify it under the terms of 
+ *  the GNU General Public License as published by the Free Software Foundation, version 3.
+ *  This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; 
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. 
+ *  See the GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License along with this program. 
+ *  If not, see https://www.gnu.org/licenses/.
+ * 
+ *  Description:
+ *  This file is query statistics collector. Every thread has own counters of loads, cache hits
+ *  and operators work, that's why counters don't require locks. Explain analyze reset counters
+ *  of session thread before query and read them after.
+ * 
+ *  CordellDBMS source code: https://github.com/j1sk1ss/CordellDBMS.EXMPL
+ *  Credits: j1sk1ss
+ */
+
+#ifndef QSTATS_H_
+#define QSTATS_H_
+
+#include <string.h>
+#include <time.h>
+
+#include "common.h"
+#include "threading.h"
+
+
+#define QST_SCAN        0
+#define QST_FILTER      1
+#define QST_SORT        2
+#define QST_JOIN        3
+#define QST_AGGREGATE   4
+#define QST_MUTATION    5
+#define QST_OPERATORS   6
+
+#define QST_add(field, value)   (QST_get()->field += (value))
+#define QST_operator(op)        (&QST_get()->operators[op])
+
+
+typedef struct {
+    unsigned int calls;
+    unsigned long long rows_in;
+    unsigned long long rows_out;
+
+    // Time in microseconds. Time of operator includes time of nested operators.
+    unsigned long long time;
+} operator_stats_t;
+
+typedef struct {
+    unsigned int table_loads;
+    unsigned int table_hits;
+    unsigned int directory_loads;
+    unsigned int directory_hits;
+    unsigned int page_loads;
+    unsigned int page_hits;
+    unsigned int pages_skipped;
+    unsigned int module_calls;
+    unsigned int module_hits;
+    unsigned int module_inline;
+
+    // Rows placed to answer (result rows, groups of aggregate)
+    unsigned long long rows_returned;
+
+    // Time of disk loads in microseconds
+    unsigned long long load_time;
+    operator_stats_t operators[QST_OPERATORS];
+} query_stats_t;
+
+
+/*
+Get statistics of current thread.
+
+Return pointer to thread statistics.
+*/
+query_stats_t* QST_get();
+
+/*
+Reset statistics of current thread.
+*/
+void QST_reset();
+
+/*
+Add counters, that was collected by current thread after start snapshot, to destination.
+Used by OpenMP workers for returning counters to session thread.
+
+Params:
+- destination - Statistics of session thread.
+- start - Snapshot of current thread statistics at work start.
+*/
+void QST_merge(query_stats_t* __restrict destination, query_stats_t* __restrict start);
+
+/*
+Get monotonic time in microseconds.
+
+Return time in microseconds.
+*/
+unsigned long long QST_time();
+
+/*
+Add operator work to statistics.
+
+Params:
+- op - Operator index (QST_SCAN, QST_SORT, ...).
+- start - Operator start time from QST_time.
+- rows_in - Count of rows, that operator took.
+- rows_out - Count of rows, that operator produced.
+*/
+void QST_end(int op, unsigned long long start, unsigned long long rows_in, unsigned long long rows_out);
+
+#endif
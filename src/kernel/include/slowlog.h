@@ -0,0 +1,89 @@
+/*
+ *  License:
+ *  Copyright (C) 2024 Nikolaj Fot
+ *
+ *  This program is free software: you can redistribute it and/or modify it under the terms of
+ *  the GNU General Public License as published by the Free Software Foundation, version 3.
+ *  This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License along with this program.
+ *  If not, see https://www.gnu.org/licenses/.
+ *
+ *  Description:
+ *  This file is slow query log. Command, that processed longer then CDBMS_SLOW_QUERY_US microseconds,
+ *  recorded with duration, rows and pages counters of session thread (qstats) and size of answer.
+ *  Session only formats record and puts it to queue. Records written to file by writer thread, and file
+ *  rotated after SLW_FILE_SIZE bytes (<name> -> <name>.1 -> ... -> <name>.<SLW_FILES - 1>).
+ *  Without threads records written by session after answer sent. If queue full, record dropped and counted.
+ *
+ *  CordellDBMS source code: https://github.com/j1sk1ss/CordellDBMS.EXMPL
+ *  Credits: j1sk1ss
+ */
+
+#ifndef SLOWLOG_H_
+#define SLOWLOG_H_
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "common.h"
+#include "qstats.h"
+#include "threading.h"
+#include "logging.h"
+
+
+// Threshold in microseconds. Slow query log disabled, if threshold not set.
+#define SLW_THRESHOLD       ENV_GET("CDBMS_SLOW_QUERY_US", "-1")
+#define SLW_PATH            ENV_GET("CDBMS_SLOW_QUERY_LOG", "slow_queries.log")
+
+#ifndef SLW_FILE_SIZE
+    #define SLW_FILE_SIZE   0x100000
+#endif
+
+#define SLW_FILES           4
+#define SLW_QUEUE_SIZE      64
+#define SLW_RECORD_SIZE     512
+#define SLW_COMMAND_SIZE    256
+
+
+typedef struct {
+    int session;
+    unsigned long long start;
+    char command[SLW_COMMAND_SIZE + 1];
+} slow_query_t;
+
+
+/*
+Read slow query log settings and start writer thread.
+
+Return 0 if slow query log disabled, or 1.
+*/
+int SLW_init();
+
+/*
+Start accounting of command. Statistics of session thread reset here.
+
+Params:
+- query - Query accounting.
+- session - Session index.
+- command - Command text. Copied, because command parsed in place.
+- command_size - Size of command text.
+
+Return 0 if slow query log disabled, or 1.
+*/
+int SLW_begin(slow_query_t* query, int session, unsigned char* command, size_t command_size);
+
+/*
+Finish accounting of command. Record placed to queue, if command was slow.
+
+Params:
+- query - Query accounting from SLW_begin.
+- bytes_sent - Size of answer.
+
+Return 0 if command not slow, -1 if record dropped, or 1.
+*/
+int SLW_end(slow_query_t* query, size_t bytes_sent);
+
+#endif
@@ -0,0 +1,193 @@
+/*
+ *  License:
+ *  Copyright (C) 2024 Nikolaj Fot
+ *
+ *  This program is free software: you can redistribute it and/or modify it under the terms of
+ *  the GNU General Public License as published by the Free Software Foundation, version 3.
+ *  This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License along with this program.
+ *  If not, see https://www.gnu.org/licenses/.
+ *
+ *  Description:
+ *  Sortman - list of functions for sorting rows, that don't fit into RAM.
+ *  We can:
+ *      - Keep only first K rows in bounded heap (for queries with limit)
+ *      - Sort rows in memory, while they fit into memory budget
+ *      - Spill sorted runs to temporary pages and merge them
+ *
+ *  Sortman works with pageman directly. Temporary pages placed in SORT_BASE_PATH and
+ *  deleted right after reading, that's why sorter don't leave any files after work.
+ *
+ *  CordellDBMS source code: https://github.com/j1sk1ss/CordellDBMS.EXMPL
+ *  Credits: j1sk1ss
+*/
+
+#ifndef SORTMAN_H_
+#define SORTMAN_H_
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "cache.h"
+#include "common.h"
+#include "logging.h"
+#include "pageman.h"
+
+
+// Set here default path for temporary pages.
+#define SORT_BASE_PATH ENV_GET("SORT_BASE_PATH", "sort")
+
+// Memory budget of one sort in pages. Lower - less RAM. Higher - less I/O.
+#ifndef SORT_BUFFER_PAGES
+    #define SORT_BUFFER_PAGES 16
+#endif
+
+#define SORT_BUFFER_SIZE    (SORT_BUFFER_PAGES * PAGE_CONTENT_SIZE)
+#define SORT_NUMERIC_KEY    1
+#define SORT_DESCENDING     2
+// Key is native little-endian integer (4 or 8 bytes)
+#define SORT_BINARY_KEY     4
+// Key is native double
+#define SORT_REAL_KEY       8
+
+
+    typedef struct {
+        // Names of temporary pages in run order
+        char (*page_names)[PAGE_NAME_SIZE];
+        int page_count;
+        size_t rows_count;
+
+        // Pages before this index already readed and deleted
+        int next_page;
+    } sort_run_t;
+
+    typedef struct {
+        // Sort key location in row
+        int key_offset;
+        int key_size;
+        unsigned char flags;
+        size_t row_size;
+
+        // Maximum count of rows in output. 0 for all rows.
+        size_t limit;
+        unsigned char is_heap;
+
+        // Rows in RAM. In heap mode order is heap order.
+        unsigned char* buffer;
+        unsigned char** rows;
+        size_t rows_count;
+        size_t rows_capacity;
+
+        // Spilled sorted runs
+        sort_run_t* runs;
+        int run_count;
+    } sorter_t;
+
+
+/*
+Create sorter. If limit provided and limit rows fit into memory budget, sorter will use bounded heap.
+In other case sorter will use external merge sort.
+
+Params:
+- row_size - Size of one row.
+- key_offset - Offset of sort key in row.
+- key_size - Size of sort key.
+- flags - SORT_NUMERIC_KEY for int compare (instead raw bytes compare), SORT_BINARY_KEY / SORT_REAL_KEY for binary columns,
+SORT_DESCENDING for descending order.
+- limit - Maximum count of rows in output. Provide 0 for all rows.
+
+Return NULL if something goes wrong.
+Return pointer to sorter.
+*/
+sorter_t* SRT_create_sorter(size_t row_size, int key_offset, int key_size, unsigned char flags, size_t limit);
+
+/*
+Add row to sorter. Row will be copied.
+Note: If memory budget exceeded, sorter will sort rows in RAM and spill them to temporary pages.
+
+Params:
+- sorter - Pointer to sorter.
+- row - Row data with sorter row size.
+
+Return -1 if something goes wrong.
+Return 1 if row added.
+*/
+int SRT_add_row(sorter_t* __restrict sorter, unsigned char* __restrict row);
+
+/*
+Finish sort and send sorted rows to output function.
+Note: Spilled runs merged with fan-in, that fit into memory budget. If runs count bigger,
+      sorter will merge them in few passes.
+
+Params:
+- sorter - Pointer to sorter.
+- output - Output function. Will be invoked for every row in sorted order.
+           If output function return not 1, sort will stop.
+- ctx - Context for output function.
+
+Return -1 if something goes wrong.
+Return 1 if sort complete.
+*/
+int SRT_finish(sorter_t* sorter, int (*output)(void*, unsigned char*, size_t), void* ctx);
+
+/*
+Append row to temporary run. If current run page full, it will be saved and closed.
+Note: Run rows placed in pages with same slot layout as in table pages.
+
+Params:
+- run - Pointer to run.
+- page - Pointer to current run page. Should be NULL before first append.
+- row - Row data.
+- row_size - Row size.
+
+Return -1 if something goes wrong.
+Return 1 if row appended.
+*/
+int SRT_append_run_row(sort_run_t* __restrict run, page_t** page, unsigned char* __restrict row, size_t row_size);
+
+/*
+Save and free current run page, if page not closed yet.
+
+Params:
+- page - Pointer to current run page.
+
+Return 1 if page saved.
+*/
+int SRT_close_run_page(page_t** page);
+
+/*
+Read next page of run. Page will be deleted after reading.
+
+Params:
+- run - Pointer to run.
+- buffer - Destination place with PAGE_CONTENT_SIZE size.
+
+Return -1 if something goes wrong.
+Return 1 if page readed.
+*/
+int SRT_read_run_page(sort_run_t* __restrict run, unsigned char* __restrict buffer);
+
+/*
+Delete all not readed pages of run and free run page names.
+
+Params:
+- run - Pointer to run.
+
+Return 1 if free success.
+*/
+int SRT_free_run(sort_run_t* run);
+
+/*
+Free sorter and delete all temporary pages, that was not merged.
+
+Params:
+- sorter - Pointer to sorter.
+
+Return 1 if free success.
+*/
+int SRT_free_sorter(sorter_t* sorter);
+
+#endif
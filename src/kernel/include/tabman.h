@@ -34,6 +34,9 @@
 
 #include <stdlib.h>
 #include <stdio.h>
+#include <stdint.h>
+#include <errno.h>
+#include <math.h>
 
 #ifndef _WIN32
     #include <unistd.h>
@@ -134,11 +137,47 @@
     #define COLUMN_TYPE_MODULE       0x02
     // String type throw error, if user insert something, that not char*
     #define COLUMN_TYPE_STRING       0x03
+    // Binary type stored little-endian with fixed width. Kind of binary type placed in data type bits.
+    // Note: In commands and answers binary values presented as right-aligned text (Check TBM_get_text_size).
+    #define COLUMN_TYPE_BINARY       0x04
+
+    #define COLUMN_BINARY_I32        0x00
+    #define COLUMN_BINARY_I64        0x01
+    #define COLUMN_BINARY_F64        0x02
+    // Decimal stored as i64 with DECIMAL_SCALE digits after point
+    #define COLUMN_BINARY_DECIMAL    0x03
+
+    #define DECIMAL_SCALE            4
+    #define DECIMAL_FACTOR           10000
+
+    // Text width of binary values in commands and answers
+    #define I32_TEXT_SIZE            11
+    #define I64_TEXT_SIZE            20
+    #define F64_TEXT_SIZE            24
+    #define DECIMAL_TEXT_SIZE        21
+    // Text of binary value at most 3 times bigger then value (f64), that's why text row fits into 3 pages
+    #define ROW_TEXT_MAX_SIZE        (PAGE_CONTENT_SIZE * 3)
+
+    // Bloom filter status says, that every page keep Bloom filter for values of this column
+    #define COLUMN_NO_BLOOM          0x00
+    #define COLUMN_BLOOM             0x01
+
+    // Macros for getting column Bloom filter status.
+    #define GET_COLUMN_BLOOM(type)          ((type >> 6) & 0b1)
+    // Macros for setting column Bloom filter status.
+    #define SET_COLUMN_BLOOM(type)          (type | (COLUMN_BLOOM << 6))
+
+    // Macros for getting column binary status.
+    #define GET_COLUMN_BINARY(type)         ((type >> 7) & 0b1)
+    // Macros for setting column binary status.
+    #define SET_COLUMN_BINARY(type)         (type | (0b1 << 7))
+    // Macros for getting kind of binary column (i32, i64, f64, decimal).
+    #define GET_COLUMN_BINARY_TYPE(type)    ((type >> 2) & 0b11)
 
     // Macros for getting column primary status. (Unique value at every row).
     #define GET_COLUMN_PRIMARY(type)        ((type >> 4) & 0b11)
     // Macros for getting column data type. What data type is set in this column.
-    #define GET_COLUMN_DATA_TYPE(type)      ((type >> 2) & 0b11)
+    #define GET_COLUMN_DATA_TYPE(type)      (GET_COLUMN_BINARY(type) ? COLUMN_TYPE_BINARY : ((type >> 2) & 0b11))
     // Macros for getting column type. Can it autoincrement or something like that.
     #define GET_COLUMN_TYPE(type)           (type & 0b11)
 
@@ -160,6 +199,7 @@
     typedef struct {
         int size;
         int offset;
+        unsigned char type;
     } table_columns_info_t;
 
     typedef struct {
@@ -170,9 +210,11 @@
         Column type indicates what type should user insert to this column.
         Main idea, that we save type, data type and primary status in one byte.
         In summary we have next byte:
-        0x00|PP|DD|TT|
+        0x0|S|B|PP|DD|TT|
 
         Where:
+        S  - Binary storage bit. If set, DD bits keep kind of binary type.
+        B  - Bloom filter bit.
         PP - Primary bits.
         DD - Data type bits.
         TT - Column type bits.
@@ -224,6 +266,13 @@
         // How much directories in this table
         unsigned char dir_count;
 
+        // Layout of table pages (PAGE_LAYOUT_ROWS or PAGE_LAYOUT_PAX).
+        // Placed in header padding, that's why old tables have rows layout.
+        unsigned char layout;
+
+        // Codec of table pages on disk (CDC_NONE or CDC_LZ). Placed in header padding too.
+        unsigned char codec;
+
         // Table checksum
         unsigned int checksum;
     } table_header_t;
@@ -241,6 +290,12 @@
         table_column_t** columns;
         unsigned short row_size;
 
+        // Size of row in commands and answers. Differs from row_size, if table has binary columns.
+        unsigned short text_row_size;
+
+        // Compiled module queries of columns (NULL for column, that launches module).
+        module_program_t** programs;
+
         // Table directories
         char dir_names[DIRECTORIES_PER_TABLE][DIRECTORY_NAME_SIZE];
     } table_t;
@@ -262,6 +317,55 @@
     */
     int TBM_get_content(table_t* __restrict table, int offset,  unsigned char* __restrict buffer, size_t size);
 
+    /*
+    Get zone maps of page and of page directory. This function loads only directory, without page I/O.
+    Note: Zone with is_valid 0 can contain any values.
+
+    Params:
+    - table - Pointer to table.
+    - page - Global page index (offset / PAGE_CONTENT_SIZE).
+    - page_zone - Destination for page zone.
+    - directory_zone - Destination for zone of whole directory.
+    - layout - Destination for zone layout of directory.
+    - bloom - Destination for page Bloom filter with PAGE_BLOOM_SIZE size. Can be NULL.
+
+    Return 0 if page not found.
+    Return count of pages from this page to end of directory (this page included).
+    */
+    int TBM_get_page_zone(
+        table_t* __restrict table, int page, page_zone_t* __restrict page_zone,
+        page_zone_t* __restrict directory_zone, zone_layout_t* __restrict layout, unsigned char* __restrict bloom
+    );
+
+    /*
+    Get row slots of one page. In table with PAX layout only provided columns readed from page.
+    Note: Bytes of other columns in buffer stay untouched.
+
+    Params:
+    - table - Pointer to table.
+    - page - Global page index (offset / PAGE_CONTENT_SIZE).
+    - columns - Mask of table columns or NULL for all columns.
+    - buffer - Destination with PAGE_CONTENT_SIZE size.
+
+    Return 0 if page not found.
+    Return 1 if read success.
+    */
+    int TBM_get_page_columns(table_t* __restrict table, int page, unsigned char* __restrict columns, unsigned char* __restrict buffer);
+
+    /*
+    Rewrite or delete marked rows of one page. See DRM_mutate_page.
+
+    Params:
+    - table - Pointer to table.
+    - page - Global page index (offset / PAGE_CONTENT_SIZE).
+    - mask - Array with flag for every row slot in page.
+    - data - New row data with table row size, or NULL for delete.
+
+    Return -1 if page not found.
+    Return count of changed rows.
+    */
+    int TBM_mutate_page(table_t* __restrict table, int page, unsigned char* __restrict mask, unsigned char* __restrict data);
+
     /*
     Insert data row to content pages in directories. Main difference with append_content is hard part.
     This maeans, that we don't care about signature and other stuff. One thing that can cause fail, directory end.
@@ -304,6 +408,23 @@
     */
     int TBM_append_content(table_t* __restrict table, unsigned char* __restrict data, size_t data_size);
 
+    /*
+    Append set of rows to table. This is a bulk version of TBM_append_content.
+    Function fills free row slots in existed directories, then creates new pages and directories.
+    Every new page and directory will be written to disk once.
+    Note: Rows in data should have table->row_size size and placed one by one.
+
+    Params:
+    - table - Pointer to table.
+    - data - Rows for append.
+    - rows_count - Count of rows.
+
+    Return -12 if we can't create uniqe name for page.
+    Return -1 if something goes wrong.
+    Return 1 if append was success.
+    */
+    int TBM_append_rows(table_t* __restrict table, unsigned char* __restrict data, size_t rows_count);
+
     /*
     Delete content in table. All steps below:
     TABLE -> DIRECTORY -> PAGE
@@ -413,6 +534,95 @@
     */
     int TBM_check_signature(table_t* __restrict table, unsigned char* __restrict data);
 
+    /*
+    Get size of column value in commands and answers.
+
+    Params:
+    - type - Column type byte.
+    - size - Column size.
+
+    Return text size of binary type, or size for other columns.
+    */
+    int TBM_get_text_size(unsigned char type, unsigned short size);
+
+    /*
+    Convert row from command text to storage format. Binary values parsed from right-aligned text,
+    other columns copied as is.
+    Note: Text row should have table->text_row_size size, buffer table->row_size size.
+
+    Params:
+    - table - Pointer to table.
+    - text - Row in text format.
+    - buffer - Destination for row in storage format.
+
+    Return -2 if binary value is not a number.
+    Return 1 if conversion success.
+    */
+    int TBM_encode_row(table_t* __restrict table, unsigned char* __restrict text, unsigned char* __restrict buffer);
+
+    /*
+    Convert column value from storage format to text format.
+
+    Params:
+    - type - Column type byte.
+    - size - Column size.
+    - data - Value in storage format.
+    - buffer - Destination with TBM_get_text_size size.
+
+    Return size of text value.
+    */
+    int TBM_decode_value(unsigned char type, unsigned short size, unsigned char* __restrict data, unsigned char* __restrict buffer);
+
+    /*
+    Convert row from storage format to text format.
+
+    Params:
+    - table - Pointer to table.
+    - data - Row in storage format.
+    - buffer - Destination with table->text_row_size size.
+
+    Return text_row_size.
+    */
+    int TBM_decode_row(table_t* __restrict table, unsigned char* __restrict data, unsigned char* __restrict buffer);
+
+    /*
+    Get value of binary column. Integer kinds returned as is (decimal in 1 / DECIMAL_FACTOR units),
+    f64 truncated.
+
+    Params:
+    - type - Column type byte.
+    - data - Value in storage format.
+
+    Return value.
+    */
+    long long TBM_get_binary_int(unsigned char type, unsigned char* data);
+
+    /*
+    Get value of binary column as double (decimal converted to real value).
+
+    Params:
+    - type - Column type byte.
+    - data - Value in storage format.
+
+    Return value.
+    */
+    double TBM_get_binary_real(unsigned char type, unsigned char* data);
+
+    /*
+    Parse text value for binary column kind. Used for comparison of binary columns with command values.
+
+    Params:
+    - type - Column type byte.
+    - text - Value text.
+    - size - Max size of text.
+    - value - Destination for integer value (decimal in 1 / DECIMAL_FACTOR units).
+    - real - Destination for real value.
+
+    Return 1 if text is a number.
+    Return -2 if text is not a number.
+    */
+    int TBM_parse_binary(unsigned char type, char* __restrict text, size_t size, long long* __restrict value, double* __restrict real);
+
 #pragma endregion
 
 #pragma region [Table]
@@ -537,10 +747,31 @@
     - table - Pointer to table.
     - data - Pointer to data for module invoke.
     - type - Addition params.
+    - columns - Columns mask with column_count size. Modules will be invoked only in marked columns.
+                Provide NULL for invoking modules in all columns.
+
+    Return 1 if success.
+    */
+    int TBM_invoke_modules(table_t* __restrict table, unsigned char* __restrict data, unsigned char type, unsigned char* __restrict columns);
+
+    /*
+    Invoke modules for many rows. Every module invoked once for all rows (see MDL_launch_batch).
+
+    Params:
+    - table - Pointer to table.
+    - rows - Rows one after another. If rows_count more then 1, empty rows will be skipped.
+    - rows_count - Rows count.
+    - type - Addition params.
+    - columns - Columns mask with column_count size. Modules will be invoked only in marked columns.
+                Provide NULL for invoking modules in all columns.
 
+    Return -2 if module query can't be created.
+    Return -1 if allocation error.
     Return 1 if success.
     */
-    int TBM_invoke_modules(table_t* __restrict table, unsigned char* __restrict data, unsigned char type);
+    int TBM_invoke_modules_batch(
+        table_t* __restrict table, unsigned char* __restrict rows, int rows_count, unsigned char type, unsigned char* __restrict columns
+    );
 
 #pragma endregion
 
@@ -21,6 +21,7 @@
 #include <stdlib.h>
 
 #include "common.h"
+#include "metrics.h"
 
 #define LOCKED    1
 #define UNLOCKED  0
@@ -28,6 +29,7 @@
 
 #ifndef _OPENMP
   #define omp_get_thread_num() 0
+  #define omp_get_max_threads() 1
   #define omp_set_num_threads(num)
 #else
   #include <omp.h>
@@ -2,170 +2,1617 @@
 
 
 static database_t* _connections[MAX_CONNECTIONS] = { NULL };
+static cursor_t* _cursors[MAX_CONNECTIONS] = { NULL };
+static statement_t* _statements[MAX_CONNECTIONS][MAX_PREPARED] = { { NULL } };
+static arena_t _arenas[MAX_CONNECTIONS] = { { NULL } };
+
+// Arena of session, that processed by current thread
+static __thread arena_t* _arena = NULL;
 
 
 #pragma region [Private]
 
-    static inline int _flush_tables() {
-        CHC_free();
+    static inline int _flush_tables() {
+        CHC_free();
+        return 1;
+    }
+
+    static table_t* _get_table(database_t* database, char* table_name) {
+        table_t* table = DB_get_table(database, table_name);
+        if (!table) { print_error("Table [%s] not found in database [%.*s]", table_name, DATABASE_NAME_SIZE, database->header->name); }
+        return table;
+    }
+
+    /*
+    Load second table of command. First table locked during load, so cache can't replace (and free) it.
+    */
+    static table_t* _get_second_table(database_t* database, table_t* first, char* table_name) {
+        int is_locked = THR_require_lock(&first->lock, omp_get_thread_num()) == 1;
+        table_t* table = _get_table(database, table_name);
+        if (is_locked) THR_release_lock(&first->lock, omp_get_thread_num());
+        return table;
+    }
+
+    static int _compare_data(char* expression, char* fdata, size_t fdata_size, char* sdata) {
+        // Column data isn't null-terminated. Copy placed on stack, because compare invoked for every row.
+        char temp_fdata[COLUMN_MAX_SIZE + 1];
+        fdata_size = MIN(fdata_size, COLUMN_MAX_SIZE);
+        memcpy(temp_fdata, fdata, fdata_size);
+        temp_fdata[fdata_size] = '\0';
+        char* mv_fdata = temp_fdata + strspn(temp_fdata, " ");
+        char* mv_sdata = sdata + strspn(sdata, " ");
+
+        int comparison = 0;
+        if (strcmp(expression, STR_EQUALS) == 0) comparison = strcmp(mv_fdata, mv_sdata) == 0;
+        else if (strcmp(expression, STR_NEQUALS) == 0) comparison = strcmp(mv_fdata, mv_sdata) != 0;
+        else {
+            int first = atoi(mv_fdata);
+            int second = atoi(mv_sdata);
+            if (strcmp(expression, NEQUALS) == 0) comparison = first != second;
+            else if (strcmp(expression, EQUALS) == 0) comparison = first == second;
+            else if (strcmp(expression, LESS_THAN) == 0) comparison = first < second;
+            else if (strcmp(expression, MORE_THAN) == 0) comparison = first > second;
+        }
+
+        return comparison;
+    }
+
+    static int _create_expression(table_t* table, table_t* join_table, char* commands[], int current_command, int argc, expression_t* expression) {
+        expression->condition_count = 0;
+        expression->operator_count = 0;
+        expression->limit = -1;
+        expression->offset = 0;
+
+        while (1) {
+            char* operator = SAFE_GET_VALUE_PRE_INC(commands, argc, current_command);
+            if (!operator) break;
+            if (expression->condition_count >= MAX_STATEMENTS || expression->operator_count >= MAX_STATEMENTS) break;
+            if (strcmp(operator, COLUMN) == 0) {
+                // Condition without column, expression or value (cut message) ends expression
+                if (current_command + 3 >= argc) break;
+
+                // In joined row columns of second table placed after first table row
+                char* column_name = SAFE_GET_VALUE_PRE_INC(commands, argc, current_command);
+                table_columns_info_t* col_info = &expression->conditions[expression->condition_count].col_info;
+                if (TBM_get_column_info(table, column_name, col_info) != 1 && join_table != NULL) {
+                    if (TBM_get_column_info(join_table, column_name, col_info) == 1) col_info->offset += table->row_size;
+                }
+
+                expression->conditions[expression->condition_count].expression = SAFE_GET_VALUE_PRE_INC(commands, argc, current_command);
+                expression->conditions[expression->condition_count].value = SAFE_GET_VALUE_PRE_INC(commands, argc, current_command);
+                expression->condition_count++;
+            } 
+            else if (strcmp(operator, OR) == 0 || strcmp(operator, AND) == 0) {
+                expression->operators[expression->operator_count++] = operator;
+            } 
+            else if (strcmp(operator, OFFSET) == 0) {
+                expression->offset = atoi(SAFE_GET_VALUE_PRE_INC_S(commands, argc, current_command));
+            } 
+            else if (strcmp(operator, LIMIT) == 0) {
+                expression->limit = atoi(SAFE_GET_VALUE_PRE_INC_S(commands, argc, current_command));
+            }
+            else break;
+        }  
+        
+        return 1;
+    }
+
+    static char* _get_command(char* commands[], int argc, int index) {
+        // Commands array shorter then argc, if database name provided
+        if (index >= argc || index >= MAX_COMMANDS || commands[index] == NULL) return "-1";
+        return commands[index];
+    }
+
+    static int _get_column_index(table_t* table, char* column_name, table_columns_info_t* info) {
+        int offset = 0;
+        for (int i = 0; i < table->header->column_count; i++) {
+            if (strncmp(table->columns[i]->name, column_name, COLUMN_NAME_SIZE) == 0) {
+                info->offset = offset;
+                info->size = table->columns[i]->size;
+                info->type = table->columns[i]->type;
+                return i;
+            }
+
+            offset += table->columns[i]->size;
+        }
+
+        print_error("Column [%s] not found in table [%.*s]", column_name, TABLE_NAME_SIZE, table->header->name);
+        return -1;
+    }
+
+    static int _create_projection(table_t* table, char* commands[], int* current_command, int argc, projection_t* projection) {
+        projection->column_count = 0;
+        projection->size = 0;
+        memset(projection->mask, 0, MAX_COLUMNS);
+
+        if (*(SAFE_GET_VALUE_PRE_INC_S(commands, argc, *current_command)) != OPEN_BRACKET) return -1;
+        while (1) {
+            char* column_name = SAFE_GET_VALUE_PRE_INC(commands, argc, *current_command);
+            if (!column_name) return -1;
+            if (*column_name == CLOSE_BRACKET) break;
+            if (projection->column_count >= MAX_PROJECTIONS) return -1;
+
+            int column_index = _get_column_index(table, column_name, &projection->columns[projection->column_count]);
+            if (column_index == -1) return -1;
+
+            table_columns_info_t* column = &projection->columns[projection->column_count];
+            projection->size += TBM_get_text_size(column->type, column->size);
+            projection->mask[column_index] = 1;
+            projection->column_count++;
+        }
+
+        return 1;
+    }
+
+    static int _mark_expression_columns(table_t* table, expression_t* expression, unsigned char* mask) {
+        int offset = 0;
+        for (int i = 0; i < table->header->column_count; i++) {
+            for (int j = 0; j < expression->condition_count; j++) {
+                if (expression->conditions[j].col_info.offset == offset) mask[i] = 1;
+            }
+
+            offset += table->columns[i]->size;
+        }
+
+        return 1;
+    }
+
+    static int _project_row(projection_t* projection, unsigned char* row_data, unsigned char* buffer) {
+        unsigned char* buffer_pointer = buffer;
+        for (int i = 0; i < projection->column_count; i++) {
+            table_columns_info_t* column = &projection->columns[i];
+            buffer_pointer += TBM_decode_value(column->type, column->size, row_data + column->offset, buffer_pointer);
+        }
+
+        return projection->size;
+    }
+
+    /*
+    Prepare row for answer. Binary values converted to text, and if projection provided, only projected columns returned.
+    Return size of row in answer.
+    */
+    static int _output_row(table_t* table, projection_t* projection, unsigned char* row_data, unsigned char* buffer) {
+        if (projection != NULL && projection->column_count > 0) return _project_row(projection, row_data, buffer);
+        return TBM_decode_row(table, row_data, buffer);
+    }
+
+    static int _compare_binary(condition_t* condition, unsigned char* data) {
+        long long second = 0;
+        double second_real = 0;
+        if (TBM_parse_binary(condition->col_info.type, condition->value, strlen(condition->value), &second, &second_real) != 1) return 0;
+
+        // Binary values compared natively. Equality operators of strings means same, as numeric equality here.
+        int order = 0;
+        if (GET_COLUMN_BINARY_TYPE(condition->col_info.type) == COLUMN_BINARY_F64) {
+            double first = TBM_get_binary_real(condition->col_info.type, data);
+            order = (first > second_real) - (first < second_real);
+        }
+        else {
+            long long first = TBM_get_binary_int(condition->col_info.type, data);
+            order = (first > second) - (first < second);
+        }
+
+        if (strcmp(condition->expression, NEQUALS) == 0 || strcmp(condition->expression, STR_NEQUALS) == 0) return order != 0;
+        else if (strcmp(condition->expression, EQUALS) == 0 || strcmp(condition->expression, STR_EQUALS) == 0) return order == 0;
+        else if (strcmp(condition->expression, LESS_THAN) == 0) return order < 0;
+        else if (strcmp(condition->expression, MORE_THAN) == 0) return order > 0;
+        return 0;
+    }
+
+    static int _evaluate_expression(unsigned char* row_data, expression_t* expression) {
+        int results[MAX_STATEMENTS] = { 0 };
+        #pragma omp parallel for schedule(dynamic, 2)
+        for (int i = 0; i < expression->condition_count; i++) {
+            condition_t* condition = &expression->conditions[i];
+            if (GET_COLUMN_BINARY(condition->col_info.type)) {
+                results[i] = _compare_binary(condition, row_data + condition->col_info.offset);
+                continue;
+            }
+
+            results[i] = _compare_data(
+                expression->conditions[i].expression, (char*)(row_data + expression->conditions[i].col_info.offset), 
+                expression->conditions[i].col_info.size, expression->conditions[i].value
+            );
+        }
+
+        int match = results[0];
+        for (int i = 0; i < expression->operator_count; i++) {
+            if (strcmp(expression->operators[i], AND) == 0) match &= results[i + 1];
+            else if (strcmp(expression->operators[i], OR) == 0) match |= results[i + 1];
+        }
+
+        QST_operator(QST_FILTER)->rows_in++;
+        if (match) QST_operator(QST_FILTER)->rows_out++;
+        return match;
+    }
+
+#pragma region [Zones]
+
+    static int _zone_compare(condition_t* condition, page_zone_t* zone, zone_layout_t* layout, unsigned char* bloom) {
+        for (int i = 0; i < layout->column_count; i++) {
+            if (layout->offsets[i] != condition->col_info.offset || layout->sizes[i] != condition->col_info.size) continue;
+
+            int value = atoi(condition->value);
+            if (strcmp(condition->expression, EQUALS) == 0) {
+                if (zone->min[i] > value || value > zone->max[i]) return 0;
+            }
+            else if (strcmp(condition->expression, NEQUALS) == 0) return zone->min[i] != value || zone->max[i] != value;
+            else if (strcmp(condition->expression, LESS_THAN) == 0) return zone->min[i] < value;
+            else if (strcmp(condition->expression, MORE_THAN) == 0) return zone->max[i] > value;
+            break;
+        }
+
+        // Bloom filter answer only for equality with same compare type, as column filter have
+        for (int i = 0; i < layout->bloom_count && bloom != NULL; i++) {
+            if (layout->bloom_offsets[i] != condition->col_info.offset || layout->bloom_sizes[i] != condition->col_info.size) continue;
+            if (strcmp(condition->expression, layout->bloom_numeric[i] ? EQUALS : STR_EQUALS) != 0) break;
+
+            unsigned char key[BLOOM_KEY_SIZE];
+            int key_size = DRM_get_bloom_key((unsigned char*)condition->value, strlen(condition->value), layout->bloom_numeric[i], key);
+            return DRM_bloom_may_contain(bloom, i, key, key_size);
+        }
+
+        // Column without zone map (or string compare) can match anything
+        return 1;
+    }
+
+    /*
+    Check expression with zone map in same order, as _evaluate_expression do.
+    Return 0 only if no one row in zone can match expression.
+    */
+    static int _zone_may_match(expression_t* expression, page_zone_t* zone, zone_layout_t* layout, unsigned char* bloom) {
+        if (!zone->is_valid) return 1;
+        if (zone->rows_count == 0) return 0;
+        if (expression->condition_count == 0) return 1;
+
+        int match = _zone_compare(&expression->conditions[0], zone, layout, bloom);
+        for (int i = 0; i < expression->operator_count; i++) {
+            if (strcmp(expression->operators[i], AND) == 0) match &= _zone_compare(&expression->conditions[i + 1], zone, layout, bloom);
+            else if (strcmp(expression->operators[i], OR) == 0) match |= _zone_compare(&expression->conditions[i + 1], zone, layout, bloom);
+        }
+
+        return match;
+    }
+
+    /*
+    Check zone maps and Bloom filter of page and page directory without page I/O.
+    Return -1 if page not exists.
+    Return 0 if page should be readed.
+    Return count of pages, that can be skipped from this page.
+    */
+    static int _get_skipped_pages(database_t* database, table_t* table, expression_t* exp, int page, unsigned char access) {
+        page_zone_t page_zone, directory_zone;
+        zone_layout_t layout;
+        unsigned char bloom[PAGE_BLOOM_SIZE];
+        int pages_left = DB_get_page_zone(database, table->header->name, page, access, &page_zone, &directory_zone, &layout, bloom);
+        if (pages_left <= 0) return -1;
+
+        int skipped_pages = 0;
+        if (!_zone_may_match(exp, &directory_zone, &layout, NULL)) skipped_pages = pages_left;
+        else if (!_zone_may_match(exp, &page_zone, &layout, bloom)) skipped_pages = 1;
+        QST_add(pages_skipped, skipped_pages);
+        return skipped_pages;
+    }
+
+#pragma endregion
+
+    static int __get_logic(
+        database_t* database, char* table_name, int index, unsigned char* data, 
+        size_t data_size, unsigned char access, kernel_answer_t* answer
+    ) {
+        size_t answer_size = answer->answer_size + data_size;
+        if (answer_size > MAX_ANSWER_SIZE) {
+            print_warn("Answer size limit [%i] reached. Use cursor for large results", MAX_ANSWER_SIZE);
+            return 0;
+        }
+
+        // Body grows geometrically, that's why rows don't copied on every append
+        if (answer_size > answer->answer_capacity) {
+            size_t capacity = MIN(MAX(answer->answer_capacity * 2, answer_size), MAX_ANSWER_SIZE);
+            unsigned char* body = (unsigned char*)realloc(answer->answer_body, capacity);
+            if (!body) return -1;
+
+            answer->answer_body = body;
+            answer->answer_capacity = capacity;
+        }
+
+        memcpy(answer->answer_body + answer->answer_size, data, data_size);
+        answer->answer_size = answer_size;
+        return 1;
+    }
+
+    static int _process_table(
+        database_t* database, table_t* table, kernel_answer_t* answer, expression_t* exp, projection_t* projection, 
+        unsigned char access, int (*logic)(database_t*, char*, int, unsigned char*, size_t, unsigned char, kernel_answer_t*)
+    ) {
+        int processed_rows = 0;
+        unsigned char* columns = NULL;
+        if (projection != NULL && projection->column_count > 0) {
+            _mark_expression_columns(table, exp, projection->mask);
+            columns = projection->mask;
+        }
+
+        arena_mark_t mark = ARN_mark(_arena);
+        unsigned char* page_buffer = (unsigned char*)ARN_alloc(_arena, PAGE_CONTENT_SIZE);
+        if (!page_buffer) return -1;
+
+        int is_done = 0;
+        int rows_per_page = PAGE_CONTENT_SIZE / table->row_size;
+        for (int page = exp->offset / rows_per_page; !is_done;) {
+            int skipped_pages = _get_skipped_pages(database, table, exp, page, access);
+            if (skipped_pages == -1) break;
+            if (skipped_pages > 0) {
+                page += skipped_pages;
+                continue;
+            }
+
+            int rows_count = DB_get_page_rows(database, table->header->name, page, access, page_buffer, columns);
+            if (rows_count <= 0) break;
+
+            for (int i = 0; i < rows_count && !is_done; i++) {
+                int index = page * rows_per_page + i;
+                unsigned char* row_data = page_buffer + i * table->row_size;
+                if (index < exp->offset || *row_data == PAGE_EMPTY) continue;
+                if (!_evaluate_expression(row_data, exp)) continue;
+                if (exp->limit != -1 && processed_rows++ >= exp->limit) {
+                    is_done = 1;
+                    break;
+                }
+
+                unsigned char output_data[ROW_TEXT_MAX_SIZE];
+                int output_size = _output_row(table, projection, row_data, output_data);
+                if (logic(database, table->header->name, index, output_data, output_size, access, answer) != 1) is_done = 1;
+                else QST_add(rows_returned, 1);
+            }
+
+            page++;
+        }
+
+        ARN_release(_arena, mark);
+        return 1;
+    }
+
+    /*
+    Set-based update / delete. Matched rows collected per page in slots mask, then whole
+    page changed by one DB_mutate_page call. Data should be prepared by DB_prepare_row, or NULL for delete.
+    Return count of changed rows or -1.
+    */
+    static int _process_mutation(
+        database_t* database, table_t* table, expression_t* exp, unsigned char* data, unsigned char access
+    ) {
+        arena_mark_t mark = ARN_mark(_arena);
+        unsigned char* page_buffer = (unsigned char*)ARN_alloc(_arena, PAGE_CONTENT_SIZE);
+        if (!page_buffer) return -1;
+
+        int is_done = 0, processed_rows = 0, changed_rows = 0;
+        int rows_per_page = PAGE_CONTENT_SIZE / table->row_size;
+        unsigned char mask[PAGE_CONTENT_SIZE];
+        for (int page = exp->offset / rows_per_page; !is_done; page++) {
+            int skipped_pages = _get_skipped_pages(database, table, exp, page, access);
+            if (skipped_pages == -1) break;
+            if (skipped_pages > 0) {
+                page += skipped_pages - 1;
+                continue;
+            }
+
+            int rows_count = DB_get_page_rows(database, table->header->name, page, access, page_buffer, NULL);
+            if (rows_count <= 0) break;
+
+            int matched_rows = 0;
+            memset(mask, 0, rows_per_page);
+            for (int i = 0; i < rows_count; i++) {
+                int index = page * rows_per_page + i;
+                unsigned char* row_data = page_buffer + i * table->row_size;
+                if (index < exp->offset || *row_data == PAGE_EMPTY) continue;
+                if (!_evaluate_expression(row_data, exp)) continue;
+                if (exp->limit != -1 && processed_rows++ >= exp->limit) {
+                    is_done = 1;
+                    break;
+                }
+
+                mask[i] = 1;
+                matched_rows++;
+            }
+
+            if (matched_rows == 0) continue;
+            unsigned long long start = QST_time();
+            int result = DB_mutate_page(database, table->header->name, page, mask, data, access);
+            QST_end(QST_MUTATION, start, matched_rows, MAX(result, 0));
+            if (result < 0) {
+                changed_rows = -1;
+                break;
+            }
+
+            changed_rows += result;
+        }
+
+        ARN_release(_arena, mark);
+        return changed_rows;
+    }
+
+#pragma endregion
+
+#pragma region [Sort]
+
+    static int _create_sorter(table_t* table, char* commands[], int current_command, int argc, expression_t* exp, projection_t* projection, sorter_t** sorter) {
+        *sorter = NULL;
+        for (int i = current_command; i < argc && i < MAX_COMMANDS && commands[i] != NULL; i++) {
+            if (strcmp(commands[i], ORDER) != 0 || strcmp(_get_command(commands, argc, i + 1), BY) != 0) continue;
+
+            table_columns_info_t column;
+            int column_index = _get_column_index(table, _get_command(commands, argc, i + 2), &column);
+            if (column_index == -1) return -1;
+
+            unsigned char flags = 0;
+            unsigned char data_type = GET_COLUMN_DATA_TYPE(table->columns[column_index]->type);
+            if (data_type == COLUMN_TYPE_INT) flags |= SORT_NUMERIC_KEY;
+            else if (data_type == COLUMN_TYPE_BINARY) {
+                flags |= GET_COLUMN_BINARY_TYPE(column.type) == COLUMN_BINARY_F64 ? SORT_REAL_KEY : SORT_BINARY_KEY;
+            }
+
+            if (strcmp(_get_command(commands, argc, i + 3), DESCENDING) == 0) flags |= SORT_DESCENDING;
+
+            *sorter = SRT_create_sorter(table->row_size, column.offset, column.size, flags, exp->limit == -1 ? 0 : exp->limit);
+            if (*sorter == NULL) return -1;
+
+            projection->mask[column_index] = 1;
+            return 1;
+        }
+
+        return 0;
+    }
+
+    static int __sort_output(void* ctx, unsigned char* data, size_t data_size) {
+        sort_output_t* output = (sort_output_t*)ctx;
+        unsigned char output_data[ROW_TEXT_MAX_SIZE];
+        int output_size = _output_row(output->table, output->projection, data, output_data);
+        QST_add(rows_returned, 1);
+        return __get_logic(NULL, NULL, 0, output_data, output_size, 0, output->answer);
+    }
+
+    /*
+    Scan table page by page and put all rows, that equals expression, to sorter.
+    With limit sorter keep only K first rows in heap. Without limit, sorter can spill rows to temporary pages.
+    */
+    static int _process_sorted(
+        database_t* database, table_t* table, kernel_answer_t* answer, expression_t* exp, 
+        projection_t* projection, sorter_t* sorter, unsigned char access
+    ) {
+        unsigned char* columns = NULL;
+        if (projection->column_count > 0) {
+            _mark_expression_columns(table, exp, projection->mask);
+            columns = projection->mask;
+        }
+
+        arena_mark_t mark = ARN_mark(_arena);
+        unsigned char* page_buffer = (unsigned char*)ARN_alloc(_arena, PAGE_CONTENT_SIZE);
+        if (!page_buffer) return -1;
+
+        int status = 1, sorted_rows = 0;
+        unsigned long long start = QST_time();
+        int rows_per_page = PAGE_CONTENT_SIZE / table->row_size;
+        for (int page = exp->offset / rows_per_page; status == 1; page++) {
+            int skipped_pages = _get_skipped_pages(database, table, exp, page, access);
+            if (skipped_pages == -1) break;
+            if (skipped_pages > 0) {
+                page += skipped_pages - 1;
+                continue;
+            }
+
+            int rows_count = DB_get_page_rows(database, table->header->name, page, access, page_buffer, columns);
+            if (rows_count <= 0) break;
+
+            for (int i = 0; i < rows_count && status == 1; i++) {
+                unsigned char* row_data = page_buffer + i * table->row_size;
+                if (page * rows_per_page + i < exp->offset || *row_data == PAGE_EMPTY) continue;
+                if (!_evaluate_expression(row_data, exp)) continue;
+                status = SRT_add_row(sorter, row_data);
+                sorted_rows++;
+            }
+        }
+
+        ARN_release(_arena, mark);
+        if (status != 1) return status;
+
+        sort_output_t output = { .answer = answer, .table = table, .projection = projection };
+        status = SRT_finish(sorter, __sort_output, &output);
+        QST_end(QST_SORT, start, sorted_rows, answer->answer_size / (columns == NULL ? table->text_row_size : projection->size));
+        return status;
+    }
+
+#pragma endregion
+
+#pragma region [Join]
+
+    static int __join_output(void* ctx, unsigned char* build_row, unsigned char* probe_row) {
+        join_output_t* output = (join_output_t*)ctx;
+        if (output->exp->limit != -1 && output->count >= output->exp->limit) return 0;
+
+        memcpy(output->row, output->build_is_first ? build_row : probe_row, output->first_size);
+        memcpy(output->row + output->first_size, output->build_is_first ? probe_row : build_row, output->second_size);
+        if (output->exp->condition_count > 0 && !_evaluate_expression(output->row, output->exp)) return 1;
+
+        output->count++;
+        unsigned char output_data[ROW_TEXT_MAX_SIZE * 2];
+        int output_size = TBM_decode_row(output->first, output->row, output_data);
+        output_size += TBM_decode_row(output->second, output->row + output->first_size, output_data + output_size);
+        QST_add(rows_returned, 1);
+        return __get_logic(NULL, NULL, 0, output_data, output_size, 0, output->answer);
+    }
+
+    static int _scan_join_side(
+        database_t* database, table_t* table, unsigned char access, joiner_t* joiner, int is_build, join_output_t* output
+    ) {
+        arena_mark_t mark = ARN_mark(_arena);
+        unsigned char* page_buffer = (unsigned char*)ARN_alloc(_arena, PAGE_CONTENT_SIZE);
+        if (!page_buffer) return -1;
+
+        int status = 1;
+        for (int page = 0; status == 1; page++) {
+            int rows_count = DB_get_page_rows(database, table->header->name, page, access, page_buffer, NULL);
+            if (rows_count <= 0) break;
+
+            for (int i = 0; i < rows_count && status == 1; i++) {
+                unsigned char* row_data = page_buffer + i * table->row_size;
+                if (*row_data == PAGE_EMPTY) continue;
+                if (is_build) status = JNM_add_build_row(joiner, row_data);
+                else status = JNM_probe_row(joiner, row_data, __join_output, output);
+            }
+        }
+
+        ARN_release(_arena, mark);
+        return status;
+    }
+
+    /*
+    Hash join of two tables. Smaller table will be build side, larger table will be probed by page scan.
+    Every result row is first table row with second table row after it.
+    */
+    static int _process_join(
+        database_t* database, table_t* first, table_t* second, char* first_column, char* second_column,
+        expression_t* exp, unsigned char access, kernel_answer_t* answer
+    ) {
+        table_columns_info_t first_info, second_info;
+        int first_index = _get_column_index(first, first_column, &first_info);
+        int second_index = _get_column_index(second, second_column, &second_info);
+        if (first_index == -1 || second_index == -1) return -1;
+
+        unsigned char flags = 0;
+        unsigned char first_type = GET_COLUMN_DATA_TYPE(first_info.type), second_type = GET_COLUMN_DATA_TYPE(second_info.type);
+        if (first_type == COLUMN_TYPE_INT && second_type == COLUMN_TYPE_INT) flags |= JOIN_NUMERIC_KEY;
+        else if (first_type == COLUMN_TYPE_BINARY && second_type == COLUMN_TYPE_BINARY) {
+            // Integer kinds can be joined with each other, real values only with real values
+            int first_real = GET_COLUMN_BINARY_TYPE(first_info.type) == COLUMN_BINARY_F64;
+            int second_real = GET_COLUMN_BINARY_TYPE(second_info.type) == COLUMN_BINARY_F64;
+            if (first_real != second_real) return -1;
+            flags |= JOIN_BINARY_KEY;
+        }
+
+        int build_is_first = (size_t)first->header->row_count * first->row_size <= (size_t)second->header->row_count * second->row_size;
+        table_t* build = build_is_first ? first : second;
+        table_t* probe = build_is_first ? second : first;
+        table_columns_info_t* build_info = build_is_first ? &first_info : &second_info;
+        table_columns_info_t* probe_info = build_is_first ? &second_info : &first_info;
+
+        joiner_t* joiner = JNM_create_joiner(
+            build->row_size, build_info->offset, build_info->size, probe->row_size, probe_info->offset, probe_info->size, flags
+        );
+
+        join_output_t output = {
+            .answer = answer, .exp = exp, .count = 0, .build_is_first = build_is_first, .first = first, .second = second,
+            .first_size = first->row_size, .second_size = second->row_size,
+            .row = (unsigned char*)ARN_alloc(_arena, first->row_size + second->row_size)
+        };
+
+        int status = -1;
+        unsigned long long start = QST_time();
+        if (joiner && output.row) {
+            status = _scan_join_side(database, build, access, joiner, 1, &output);
+            if (status == 1) status = _scan_join_side(database, probe, access, joiner, 0, &output);
+            if (status == 1) status = JNM_finish(joiner, __join_output, &output);
+        }
+
+        QST_end(QST_JOIN, start, build->header->row_count + probe->header->row_count, output.count);
+        JNM_free_joiner(joiner);
+        return status == -1 ? -1 : 1;
+    }
+
+#pragma endregion
+
+#pragma region [Aggregates]
+
+    static int _create_aggregate(table_t* table, char* function, aggregate_t* aggregate) {
+        memset(aggregate, 0, sizeof(aggregate_t));
+
+        // Function provided in <name>(<column>) format. Count don't require column.
+        char* column_start = strchr(function, OPEN_BRACKET);
+        size_t name_size = column_start ? (size_t)(column_start - function) : strlen(function);
+        if (strncmp(function, COUNT, name_size) == 0 && name_size == strlen(COUNT)) aggregate->function = AGGREGATE_COUNT;
+        else if (strncmp(function, SUM, name_size) == 0 && name_size == strlen(SUM)) aggregate->function = AGGREGATE_SUM;
+        else if (strncmp(function, MINIMUM, name_size) == 0 && name_size == strlen(MINIMUM)) aggregate->function = AGGREGATE_MIN;
+        else if (strncmp(function, MAXIMUM, name_size) == 0 && name_size == strlen(MAXIMUM)) aggregate->function = AGGREGATE_MAX;
+        else if (strncmp(function, AVERAGE, name_size) == 0 && name_size == strlen(AVERAGE)) aggregate->function = AGGREGATE_AVG;
+        else return -1;
+
+        if (aggregate->function == AGGREGATE_COUNT) return 1;
+        if (!column_start) return -1;
+
+        char column_name[COLUMN_NAME_SIZE + 1] = { 0 };
+        char* column_end = strchr(column_start, CLOSE_BRACKET);
+        size_t column_size = column_end ? (size_t)(column_end - column_start - 1) : strlen(column_start + 1);
+        strncpy(column_name, column_start + 1, MIN(column_size, COLUMN_NAME_SIZE));
+
+        int column_index = _get_column_index(table, column_name, &aggregate->column);
+        if (column_index == -1) return -1;
+
+        aggregate->mask[column_index] = 1;
+        return 1;
+    }
+
+    static unsigned int _hash_key(unsigned char* key, size_t key_size) {
+        unsigned int hash = 2166136261u;
+        for (size_t i = 0; i < key_size; i++) {
+            hash ^= key[i];
+            hash *= 16777619u;
+        }
+
+        return hash;
+    }
+
+    static aggregate_group_t* _insert_group(aggregate_group_t* groups, int capacity, unsigned char* key, size_t key_size) {
+        unsigned int index = _hash_key(key, key_size) & (capacity - 1);
+        while (groups[index].key != NULL && memcmp(groups[index].key, key, key_size) != 0) {
+            index = (index + 1) & (capacity - 1);
+        }
+
+        return &groups[index];
+    }
+
+    static aggregate_group_t* _get_group(aggregate_state_t* state, unsigned char* key, size_t key_size) {
+        // Keep load factor lower then 0.5, that's why probing stay short
+        if ((state->group_count + 1) * 2 > state->capacity) {
+            int capacity = state->capacity ? state->capacity * 2 : 16;
+            aggregate_group_t* groups = (aggregate_group_t*)calloc(capacity, sizeof(aggregate_group_t));
+            if (!groups) return NULL;
+
+            for (int i = 0; i < state->capacity; i++) {
+                if (state->groups[i].key == NULL) continue;
+                *_insert_group(groups, capacity, state->groups[i].key, key_size) = state->groups[i];
+            }
+
+            SOFT_FREE(state->groups);
+            state->groups = groups;
+            state->capacity = capacity;
+        }
+
+        aggregate_group_t* group = _insert_group(state->groups, state->capacity, key, key_size);
+        if (group->key == NULL) {
+            group->key = (unsigned char*)malloc(MAX(key_size, 1));
+            if (!group->key) return NULL;
+
+            memcpy(group->key, key, key_size);
+            group->min = LLONG_MAX;
+            group->max = LLONG_MIN;
+            group->real_min = INFINITY;
+            group->real_max = -INFINITY;
+            state->group_count++;
+        }
+
+        return group;
+    }
+
+    // Decimal values aggregated in fixed point with DECIMAL_SCALE digits after point
+    static int _is_fixed_point(unsigned char type) {
+        return GET_COLUMN_BINARY(type) && GET_COLUMN_BINARY_TYPE(type) == COLUMN_BINARY_DECIMAL;
+    }
+
+    static int _is_real(unsigned char type) {
+        return GET_COLUMN_BINARY(type) && GET_COLUMN_BINARY_TYPE(type) == COLUMN_BINARY_F64;
+    }
+
+    static long long _get_numeric(table_columns_info_t* column, unsigned char* data) {
+        if (GET_COLUMN_BINARY(column->type)) return TBM_get_binary_int(column->type, data);
+        return strntoll((char*)data, column->size);
+    }
+
+    static void _format_fixed_point(char* buffer, size_t buffer_size, long long value) {
+        char number[AGGREGATE_VALUE_SIZE + 2] = { 0 };
+        unsigned long long absolute = value < 0 ? -(unsigned long long)value : (unsigned long long)value;
+        snprintf(number, sizeof(number), "%s%llu.%0*llu", value < 0 ? "-" : "", absolute / DECIMAL_FACTOR, DECIMAL_SCALE, absolute % DECIMAL_FACTOR);
+        snprintf(buffer, buffer_size, "%*s", AGGREGATE_VALUE_SIZE, number);
+    }
+
+    static int _uses_sum(aggregate_t* aggregate) {
+        return aggregate->function == AGGREGATE_SUM || aggregate->function == AGGREGATE_AVG;
+    }
+
+    static int _aggregate_row(aggregate_state_t* state, aggregate_t* aggregate, unsigned char* row_data) {
+        aggregate_group_t* group = _get_group(state, row_data + aggregate->group.offset, aggregate->group.size);
+        if (!group) return -1;
+
+        group->count++;
+        if (aggregate->function == AGGREGATE_COUNT) return 1;
+        if (_is_real(aggregate->column.type)) {
+            double real = TBM_get_binary_real(aggregate->column.type, row_data + aggregate->column.offset);
+            group->real_sum += real;
+            group->real_min = MIN(group->real_min, real);
+            group->real_max = MAX(group->real_max, real);
+            return 1;
+        }
+
+        // Sum overflow matters only for functions, that return sum
+        long long value = _get_numeric(&aggregate->column, row_data + aggregate->column.offset);
+        if (__builtin_add_overflow(group->sum, value, &group->sum) && _uses_sum(aggregate)) return -2;
+        group->min = MIN(group->min, value);
+        group->max = MAX(group->max, value);
+        return 1;
+    }
+
+    static int _merge_states(aggregate_state_t* destination, aggregate_state_t* source, aggregate_t* aggregate) {
+        for (int i = 0; i < source->capacity; i++) {
+            aggregate_group_t* source_group = &source->groups[i];
+            if (source_group->key == NULL) continue;
+
+            aggregate_group_t* group = _get_group(destination, source_group->key, aggregate->group.size);
+            if (!group) return -1;
+
+            group->count += source_group->count;
+            if (__builtin_add_overflow(group->sum, source_group->sum, &group->sum) && _uses_sum(aggregate)) return -2;
+            group->min = MIN(group->min, source_group->min);
+            group->max = MAX(group->max, source_group->max);
+            group->real_sum += source_group->real_sum;
+            group->real_min = MIN(group->real_min, source_group->real_min);
+            group->real_max = MAX(group->real_max, source_group->real_max);
+        }
+
+        return 1;
+    }
+
+    static void _free_state(aggregate_state_t* state) {
+        for (int i = 0; i < state->capacity; i++) SOFT_FREE(state->groups[i].key);
+        SOFT_FREE(state->groups);
+        state->group_count = 0;
+        state->capacity = 0;
+    }
+
+    static int _write_aggregate(aggregate_t* aggregate, aggregate_state_t* state, kernel_answer_t* answer) {
+        // Every result row is group column value (if group by used) and aggregate value
+        size_t group_size = TBM_get_text_size(aggregate->group.type, aggregate->group.size);
+        size_t result_size = group_size + AGGREGATE_VALUE_SIZE;
+        int is_fixed_point = _is_fixed_point(aggregate->column.type);
+        int is_real = _is_real(aggregate->column.type);
+        answer->answer_body = (unsigned char*)malloc(result_size * MAX(state->group_count, 1));
+        if (!answer->answer_body) return -1;
+
+        answer->answer_size = 0;
+        for (int i = 0; i < state->capacity; i++) {
+            aggregate_group_t* group = &state->groups[i];
+            if (group->key == NULL) continue;
+
+            // Min, max and avg of empty set not defined
+            if (group->count == 0 && aggregate->function != AGGREGATE_COUNT && aggregate->function != AGGREGATE_SUM) continue;
+
+            char value[AGGREGATE_VALUE_SIZE + 1] = { 0 };
+            switch (aggregate->function) {
+                case AGGREGATE_COUNT: snprintf(value, sizeof(value), "%*lld", AGGREGATE_VALUE_SIZE, group->count); break;
+                case AGGREGATE_SUM:   snprintf(value, sizeof(value), "%*lld", AGGREGATE_VALUE_SIZE, group->sum); break;
+                case AGGREGATE_MIN:   snprintf(value, sizeof(value), "%*lld", AGGREGATE_VALUE_SIZE, group->min); break;
+                case AGGREGATE_MAX:   snprintf(value, sizeof(value), "%*lld", AGGREGATE_VALUE_SIZE, group->max); break;
+                case AGGREGATE_AVG:   snprintf(value, sizeof(value), "%*.4f", AGGREGATE_VALUE_SIZE, (double)group->sum / group->count); break;
+            }
+
+            if (is_fixed_point) {
+                switch (aggregate->function) {
+                    case AGGREGATE_SUM: _format_fixed_point(value, sizeof(value), group->sum); break;
+                    case AGGREGATE_MIN: _format_fixed_point(value, sizeof(value), group->min); break;
+                    case AGGREGATE_MAX: _format_fixed_point(value, sizeof(value), group->max); break;
+                    case AGGREGATE_AVG: snprintf(value, sizeof(value), "%*.4f", AGGREGATE_VALUE_SIZE, (double)group->sum / group->count / DECIMAL_FACTOR); break;
+                }
+            }
+            else if (is_real) {
+                switch (aggregate->function) {
+                    case AGGREGATE_SUM: snprintf(value, sizeof(value), "%*.17g", AGGREGATE_VALUE_SIZE, group->real_sum); break;
+                    case AGGREGATE_MIN: snprintf(value, sizeof(value), "%*.17g", AGGREGATE_VALUE_SIZE, group->real_min); break;
+                    case AGGREGATE_MAX: snprintf(value, sizeof(value), "%*.17g", AGGREGATE_VALUE_SIZE, group->real_max); break;
+                    case AGGREGATE_AVG: snprintf(value, sizeof(value), "%*.17g", AGGREGATE_VALUE_SIZE, group->real_sum / group->count); break;
+                }
+            }
+
+            if (group_size > 0) TBM_decode_value(aggregate->group.type, aggregate->group.size, group->key, answer->answer_body + answer->answer_size);
+            memcpy(answer->answer_body + answer->answer_size + group_size, value, AGGREGATE_VALUE_SIZE);
+            answer->answer_size += result_size;
+            QST_add(rows_returned, 1);
+        }
+
+        // Empty result will be sent as answer code
+        if (answer->answer_size == 0) {
+            free(answer->answer_body);
+            answer->answer_body = NULL;
+        }
+
+        return 1;
+    }
+
+    /*
+    Scan table page by page. Every thread takes next page and aggregate it into own partial state.
+    After scan, partial states merged into first state, and only result rows goes to answer.
+    */
+    static int _process_aggregate(
+        database_t* database, table_t* table, kernel_answer_t* answer, 
+        expression_t* exp, aggregate_t* aggregate, unsigned char access
+    ) {
+        int threads_count = omp_get_max_threads();
+        aggregate_state_t* states = (aggregate_state_t*)calloc(threads_count, sizeof(aggregate_state_t));
+        if (!states) return -1;
+
+        _mark_expression_columns(table, exp, aggregate->mask);
+
+        int status = 1;
+        int next_page = 0;
+        unsigned long long start = QST_time();
+        query_stats_t* session_stats = QST_get();
+        #pragma omp parallel
+        {
+            // Workers have own statistics, that returned to session thread after scan
+            query_stats_t worker_stats;
+            memcpy(&worker_stats, QST_get(), sizeof(query_stats_t));
+
+            aggregate_state_t* state = &states[omp_get_thread_num()];
+            unsigned char* page_buffer = (unsigned char*)malloc(PAGE_CONTENT_SIZE);
+            while (page_buffer) {
+                int page = 0;
+                #pragma omp atomic capture
+                page = next_page++;
+
+                // Directory can't be skipped at once here, because pages shared between threads by counter
+                int skipped_pages = _get_skipped_pages(database, table, exp, page, access);
+                if (skipped_pages == -1) break;
+                if (skipped_pages > 0) continue;
+
+                int rows_count = DB_get_page_rows(database, table->header->name, page, access, page_buffer, aggregate->mask);
+                if (rows_count <= 0) break;
+
+                for (int i = 0; i < rows_count; i++) {
+                    unsigned char* row_data = page_buffer + i * table->row_size;
+                    if (*row_data == PAGE_EMPTY) continue;
+                    if (exp->condition_count > 0 && !_evaluate_expression(row_data, exp)) continue;
+                    int row_status = _aggregate_row(state, aggregate, row_data);
+                    if (row_status != 1) {
+                        #pragma omp atomic write
+                        status = row_status;
+                    }
+                }
+            }
+
+            SOFT_FREE(page_buffer);
+            QST_merge(session_stats, &worker_stats);
+        }
+
+        for (int i = 1; i < threads_count; i++) {
+            int merge_status = _merge_states(&states[0], &states[i], aggregate);
+            if (merge_status != 1) status = merge_status;
+            _free_state(&states[i]);
+        }
+
+        // Query without group by should return result even for empty table
+        if (aggregate->group.size == 0 && !_get_group(&states[0], (unsigned char*)"", 0)) status = -1;
+        if (status == 1) status = _write_aggregate(aggregate, &states[0], answer);
+
+        long long aggregated_rows = 0;
+        for (int i = 0; i < states[0].capacity; i++) {
+            if (states[0].groups[i].key != NULL) aggregated_rows += states[0].groups[i].count;
+        }
+
+        QST_end(QST_AGGREGATE, start, aggregated_rows, states[0].group_count);
+
+        _free_state(&states[0]);
+        free(states);
+        return status;
+    }
+
+#pragma region [Cursor]
+
+    static int _free_cursor(int connection) {
+        cursor_t* cursor = _cursors[connection];
+        if (!cursor) return -1;
+
+        for (int i = 0; i < cursor->argc; i++) SOFT_FREE(cursor->commands[i]);
+        SOFT_FREE(cursor->page_buffer);
+        SOFT_FREE(cursor);
+        _cursors[connection] = NULL;
+        return 1;
+    }
+
+    /*
+    Open cursor for session. Command copied to cursor, because argv freed after every command.
+    Command syntax: open cursor <table_name> columns ( ... ) by_exp <expression>
+    */
+    static int _open_cursor(database_t* database, int connection, char* commands[], int current_command, int argc) {
+        _free_cursor(connection);
+
+        cursor_t* cursor = (cursor_t*)malloc(sizeof(cursor_t));
+        if (!cursor) return -1;
+        memset(cursor, 0, sizeof(cursor_t));
+        _cursors[connection] = cursor;
+
+        for (int i = current_command; i < argc && i < MAX_COMMANDS && commands[i] != NULL; i++) {
+            cursor->commands[cursor->argc] = strdup(commands[i]);
+            if (!cursor->commands[cursor->argc++]) return -1;
+        }
+
+        cursor->page_buffer = (unsigned char*)malloc(PAGE_CONTENT_SIZE);
+        if (!cursor->page_buffer) return -1;
+
+        int command_index = 2;
+        char* table_name = _get_command(cursor->commands, cursor->argc, command_index);
+        strncpy(cursor->table_name, table_name, TABLE_NAME_SIZE);
+
+        table_t* table = _get_table(database, cursor->table_name);
+        if (!table) return -1;
+
+        int status = 1;
+        command_index++;
+        if (strcmp(SAFE_GET_VALUE_S(cursor->commands, cursor->argc, command_index), COLUMNS) == 0) {
+            if (_create_projection(table, cursor->commands, &command_index, cursor->argc, &cursor->projection) != 1) status = -1;
+            command_index++;
+        }
+
+        if (status == 1 && strcmp(SAFE_GET_VALUE_S(cursor->commands, cursor->argc, command_index), BY_EXPRESSION) == 0) {
+            _create_expression(table, NULL, cursor->commands, command_index, cursor->argc, &cursor->exp);
+            if (cursor->projection.column_count > 0) _mark_expression_columns(table, &cursor->exp, cursor->projection.mask);
+            cursor->page = cursor->exp.offset / (PAGE_CONTENT_SIZE / table->row_size);
+        }
+        else {
+            status = -1;
+        }
+
+        TBM_flush_table(table);
+        return status;
+    }
+
+    /*
+    Fetch next rows from cursor. Scan continues from last position, so every fetch reads only
+    pages, that needed for this rows. Page of last position read again, because rows could be changed after last fetch.
+    */
+    static int _fetch_cursor(database_t* database, int connection, int count, unsigned char access, kernel_answer_t* answer) {
+        cursor_t* cursor = _cursors[connection];
+        if (!cursor) return -1;
+
+        table_t* table = _get_table(database, cursor->table_name);
+        if (!table) return -1;
+
+        projection_t* projection = &cursor->projection;
+        unsigned char* columns = projection->column_count > 0 ? projection->mask : NULL;
+        int row_size = columns == NULL ? table->text_row_size : projection->size;
+        int rows_per_page = PAGE_CONTENT_SIZE / table->row_size;
+
+        count = MIN(count, CURSOR_FETCH_SIZE / row_size);
+        if (count <= 0 || cursor->is_done) {
+            TBM_flush_table(table);
+            return 0;
+        }
+
+        answer->answer_body = (unsigned char*)malloc(count * row_size);
+        if (!answer->answer_body) {
+            TBM_flush_table(table);
+            return -1;
+        }
+
+        if (cursor->slot < cursor->rows_count) {
+            cursor->rows_count = MAX(DB_get_page_rows(database, table->header->name, cursor->page - 1, access, cursor->page_buffer, columns), 0);
+        }
+
+        int fetched = 0;
+        while (fetched < count && !cursor->is_done) {
+            if (cursor->slot >= cursor->rows_count) {
+                int skipped_pages = _get_skipped_pages(database, table, &cursor->exp, cursor->page, access);
+                if (skipped_pages == -1) cursor->is_done = 1;
+                else if (skipped_pages > 0) cursor->page += skipped_pages;
+                else {
+                    cursor->rows_count = DB_get_page_rows(database, table->header->name, cursor->page++, access, cursor->page_buffer, columns);
+                    cursor->slot = 0;
+                    if (cursor->rows_count <= 0) cursor->is_done = 1;
+                }
+
+                continue;
+            }
+
+            int index = (cursor->page - 1) * rows_per_page + cursor->slot;
+            unsigned char* row_data = cursor->page_buffer + cursor->slot++ * table->row_size;
+            if (index < cursor->exp.offset || *row_data == PAGE_EMPTY) continue;
+            if (!_evaluate_expression(row_data, &cursor->exp)) continue;
+            if (cursor->exp.limit != -1 && cursor->processed_rows++ >= cursor->exp.limit) {
+                cursor->is_done = 1;
+                break;
+            }
+
+            _output_row(table, projection, row_data, answer->answer_body + fetched++ * row_size);
+        }
+
+        TBM_flush_table(table);
+        QST_add(rows_returned, fetched);
+        if (fetched == 0) SOFT_FREE(answer->answer_body);
+        answer->answer_size = fetched * row_size;
+        return fetched;
+    }
+
+#pragma endregion
+
+#pragma region [Statements]
+
+    /*
+    Process command, that placed in other command (statement, explain), in current session.
+    Data modules can change command in place, that's why command processed in copy of tokens.
+    */
+    static kernel_answer_t* _process_nested(database_t* database, char* tokens[], int count, unsigned char access, int connection) {
+        char db_name[DATABASE_NAME_SIZE + 1] = { 0 };
+        strncpy(db_name, database->header->name, DATABASE_NAME_SIZE);
+
+        char* argv[MAX_COMMANDS] = { NULL, db_name };
+        int argc = 2;
+        for (int i = 0; i < count && tokens[i] != NULL && argc < MAX_COMMANDS; i++) {
+            argv[argc] = strdup(tokens[i]);
+            if (!argv[argc++]) break;
+        }
+
+        kernel_answer_t* answer = kernel_process_command(argc, argv, access, connection);
+        for (int i = 2; i < argc; i++) SOFT_FREE(argv[i]);
+        return answer;
+    }
+
+    static int _find_statement(int connection, char* name) {
+        for (int i = 0; i < MAX_PREPARED; i++) {
+            statement_t* statement = _statements[connection][i];
+            if (statement && strncmp(statement->name, name, STATEMENT_NAME_SIZE) == 0) return i;
+        }
+
+        return -1;
+    }
+
+    static int _free_statement(int connection, int index) {
+        statement_t* statement = _statements[connection][index];
+        if (!statement) return -1;
+
+        for (int i = 0; i < statement->argc; i++) SOFT_FREE(statement->commands[i]);
+        SOFT_FREE(statement);
+        _statements[connection][index] = NULL;
+        return 1;
+    }
+
+    static int _free_statements(int connection) {
+        for (int i = 0; i < MAX_PREPARED; i++) _free_statement(connection, i);
+        return 1;
+    }
+
+    /*
+    Build cached plan for statement: table, projection and expression with resolved columns.
+    Plan created only for plain scan: get row <table_name> columns ( ... ) by_exp <expression>,
+    where parameters used only as condition values.
+    Return 1 if plan created.
+    */
+    static int _build_plan(database_t* database, statement_t* statement) {
+        statement->has_plan = 0;
+        if (strcmp(_get_command(statement->commands, statement->argc, 0), GET) != 0) return 0;
+        if (strcmp(_get_command(statement->commands, statement->argc, 1), ROW) != 0) return 0;
+        for (int i = 0; i < statement->argc; i++) {
+            char* command = statement->commands[i];
+            if (strcmp(command, JOIN) == 0 || strcmp(command, ORDER) == 0 || strcmp(command, BY_INDEX) == 0) return 0;
+        }
+
+        char* table_name = _get_command(statement->commands, statement->argc, 2);
+        table_t* table = _get_table(database, table_name);
+        if (!table) return 0;
+
+        int status = 1;
+        int command_index = 3;
+        statement->projection.column_count = 0;
+        if (strcmp(_get_command(statement->commands, statement->argc, command_index), COLUMNS) == 0) {
+            if (_create_projection(table, statement->commands, &command_index, statement->argc, &statement->projection) != 1) status = 0;
+            command_index++;
+        }
+
+        if (status == 1 && strcmp(_get_command(statement->commands, statement->argc, command_index), BY_EXPRESSION) == 0) {
+            _create_expression(table, NULL, statement->commands, command_index, statement->argc, &statement->exp);
+
+            int bound_params = 0;
+            for (int i = 0; i < statement->exp.condition_count; i++) {
+                char* value = statement->exp.conditions[i].value;
+                statement->params[i] = value != NULL && strcmp(value, PARAMETER) == 0 ? bound_params++ : -1;
+            }
+
+            // Parameter in limit, offset or projection can't be placed into plan
+            if (bound_params != statement->param_count) status = 0;
+        }
+        else {
+            status = 0;
+        }
+
+        if (status == 1) {
+            strncpy(statement->table_name, table_name, TABLE_NAME_SIZE);
+            statement->row_size = table->row_size;
+            statement->has_plan = 1;
+        }
+
+        TBM_flush_table(table);
+        return status;
+    }
+
+    /*
+    Prepare statement for session. Command copied to statement, because argv freed after every command.
+    Command syntax: prepare <name> <command with ?>
+    */
+    static int _prepare_statement(database_t* database, int connection, char* commands[], int current_command, int argc) {
+        char* name = _get_command(commands, argc, current_command + 1);
+        char* first_command = _get_command(commands, argc, current_command + 2);
+        if (strcmp(first_command, "-1") == 0 || strcmp(first_command, PREPARE) == 0 || strcmp(first_command, EXECUTE) == 0) {
+            print_error("Wrong command for statement [%s]", name);
+            return -1;
+        }
+
+        int index = _find_statement(connection, name);
+        if (index != -1) _free_statement(connection, index);
+        else {
+            for (int i = 0; i < MAX_PREPARED && index == -1; i++) {
+                if (_statements[connection][i] == NULL) index = i;
+            }
+        }
+
+        if (index == -1) {
+            print_error("Session can't have more then [%i] statements", MAX_PREPARED);
+            return -1;
+        }
+
+        statement_t* statement = (statement_t*)malloc(sizeof(statement_t));
+        if (!statement) return -1;
+        memset(statement, 0, sizeof(statement_t));
+        strncpy(statement->name, name, STATEMENT_NAME_SIZE);
+        _statements[connection][index] = statement;
+
+        for (int i = current_command + 2; i < argc && i < MAX_COMMANDS && commands[i] != NULL; i++) {
+            statement->commands[statement->argc] = strdup(commands[i]);
+            if (!statement->commands[statement->argc++]) {
+                _free_statement(connection, index);
+                return -1;
+            }
+
+            if (strcmp(commands[i], PARAMETER) == 0) statement->param_count++;
+        }
+
+        _build_plan(database, statement);
+        return 1;
+    }
+
+    /*
+    Execute prepared statement. With cached plan parameters placed into expression without parsing,
+    otherwise parameters placed into copy of command and command processed as usual.
+    Command syntax: execute <name> <params...>
+    */
+    static int _execute_statement(
+        database_t* database, int connection, char* commands[], int current_command, int argc, unsigned char access, kernel_answer_t* answer
+    ) {
+        char* name = _get_command(commands, argc, current_command + 1);
+        int index = _find_statement(connection, name);
+        if (index == -1 || database == NULL) {
+            print_error("Statement [%s] not prepared", name);
+            return -1;
+        }
+
+        statement_t* statement = _statements[connection][index];
+        char* params[MAX_COMMANDS] = { NULL };
+        int params_count = 0;
+        for (int i = current_command + 2; i < argc && i < MAX_COMMANDS && commands[i] != NULL; i++) {
+            params[params_count++] = commands[i];
+        }
+
+        if (params_count != statement->param_count) {
+            print_error("Statement [%s] expects [%i] params, but [%i] provided", name, statement->param_count, params_count);
+            return -1;
+        }
+
+        if (statement->has_plan) {
+            table_t* table = _get_table(database, statement->table_name);
+            if (!table) return -1;
+
+            // Table can be recreated with another layout. In this case plan rebuilt.
+            if (table->row_size != statement->row_size) {
+                TBM_flush_table(table);
+                _build_plan(database, statement);
+                return _execute_statement(database, connection, commands, current_command, argc, access, answer);
+            }
+
+            expression_t exp;
+            memcpy(&exp, &statement->exp, sizeof(expression_t));
+            for (int i = 0; i < exp.condition_count; i++) {
+                if (statement->params[i] != -1) exp.conditions[i].value = params[statement->params[i]];
+            }
+
+            _process_table(database, table, answer, &exp, &statement->projection, access, __get_logic);
+            TBM_flush_table(table);
+            return 1;
+        }
+
+        char* tokens[MAX_COMMANDS] = { NULL };
+        for (int i = 0, param = 0; i < statement->argc; i++) {
+            tokens[i] = strcmp(statement->commands[i], PARAMETER) == 0 ? params[param++] : statement->commands[i];
+        }
+
+        kernel_answer_t* nested = _process_nested(database, tokens, statement->argc, access, connection);
+        if (!nested) return -1;
+
+        // Nested answer body moved to answer. Arena position of answer stays same.
+        SOFT_FREE(answer->answer_body);
+        answer->answer_code = nested->answer_code;
+        answer->answer_size = nested->answer_size;
+        answer->answer_body = nested->answer_body;
+        answer->answer_capacity = nested->answer_capacity;
+        nested->answer_body = NULL;
+        kernel_free_answer(nested);
         return 1;
     }
 
-    static table_t* _get_table(database_t* database, char* table_name) {
-        table_t* table = DB_get_table(database, table_name);
-        if (!table) { print_error("Table [%s] not found in database [%.*s]", table_name, DATABASE_NAME_SIZE, database->header->name); }
-        return table;
-    }
+#pragma endregion
 
-    static int _compare_data(char* expression, char* fdata, size_t fdata_size, char* sdata, size_t sdata_size) {
-        char* temp_fdata = (char*)malloc(fdata_size + 1);
-        if (!temp_fdata) return 0;
+#pragma region [Explain]
 
-        memcpy(temp_fdata, fdata, fdata_size);
-        temp_fdata[fdata_size] = '\0';
-        char* mv_fdata = temp_fdata + strspn(temp_fdata, " ");
-        
-        char* temp_sdata = (char*)malloc(sdata_size + 1);
-        if (!temp_sdata) return 0;
+    static int _explain_line(kernel_answer_t* answer, const char* format, ...) {
+        char line[256] = { 0 };
+        va_list args;
+        va_start(args, format);
+        int size = vsnprintf(line, sizeof(line) - 1, format, args);
+        va_end(args);
 
-        memcpy(temp_sdata, sdata, sdata_size);
-        temp_sdata[sdata_size] = '\0';
-        char* mv_sdata = temp_sdata + strspn(temp_sdata, " ");
+        size = MIN(size, (int)sizeof(line) - 2);
+        line[size++] = '\n';
+        return __get_logic(NULL, NULL, 0, (unsigned char*)line, size, 0, answer);
+    }
 
-        int comparison = 0;
-        if (strcmp(expression, STR_EQUALS) == 0) comparison = strcmp(mv_fdata, mv_sdata) == 0;
-        else if (strcmp(expression, STR_NEQUALS) == 0) comparison = strcmp(mv_fdata, mv_sdata) != 0;
-        else {
-            int first = atoi(mv_fdata);
-            int second = atoi(mv_sdata);
-            if (strcmp(expression, NEQUALS) == 0) comparison = first != second;
-            else if (strcmp(expression, EQUALS) == 0) comparison = first == second;
-            else if (strcmp(expression, LESS_THAN) == 0) comparison = first < second;
-            else if (strcmp(expression, MORE_THAN) == 0) comparison = first > second;
+    /*
+    Describe page scan: table size and which conditions can be checked by zone maps or Bloom filters
+    without page reading.
+    */
+    static int _explain_scan(
+        database_t* database, table_t* table, char* commands[], int current_command, int argc, unsigned char access, kernel_answer_t* answer
+    ) {
+        page_zone_t page_zone, directory_zone;
+        zone_layout_t layout = { .row_size = 0 };
+        int pages = 0;
+        for (int pages_left = 0; (pages_left = DB_get_page_zone(database, table->header->name, pages, access, &page_zone, &directory_zone, &layout, NULL)) > 0;) {
+            pages += pages_left;
         }
 
-        free(temp_fdata);
-        free(temp_sdata);
-        return comparison;
-    }
-
-    static int _create_expression(table_t* table, char* commands[], int current_command, int argc, expression_t* expression) {
-        expression->condition_count = 0;
-        expression->operator_count = 0;
-        expression->limit = -1;
-        expression->offset = 0;
+        _explain_line(
+            answer, "-> page scan on %.*s (rows=%i directories=%i pages=%i layout=%s compress=%s)", TABLE_NAME_SIZE, table->header->name, 
+            table->header->row_count, table->header->dir_count, pages, table->header->layout == PAGE_LAYOUT_PAX ? "pax" : "rows",
+            table->header->codec == CDC_LZ ? "lz" : "none"
+        );
+
+        expression_t exp = { .condition_count = 0, .operator_count = 0, .offset = 0, .limit = -1 };
+        if (strcmp(_get_command(commands, argc, current_command), BY_EXPRESSION) != 0) return 1;
+        _create_expression(table, NULL, commands, current_command, argc, &exp);
+
+        for (int i = current_command, condition = 0; i < argc && i < MAX_COMMANDS && commands[i] != NULL; i++) {
+            if (strcmp(commands[i], COLUMN) != 0 || condition >= exp.condition_count) continue;
+            condition_t* current = &exp.conditions[condition++];
+            char* filter = "row check";
+            int is_zone_expression = 
+                strcmp(current->expression, MORE_THAN) == 0 || strcmp(current->expression, LESS_THAN) == 0 ||
+                strcmp(current->expression, EQUALS) == 0 || strcmp(current->expression, NEQUALS) == 0;
+            for (int j = 0; j < layout.column_count && is_zone_expression; j++) {
+                if (layout.offsets[j] == current->col_info.offset) filter = "zone map";
+            }
 
-        while (1) {
-            char* operator = SAFE_GET_VALUE_PRE_INC(commands, argc, current_command);
-            if (!operator) break;
-            if (strcmp(operator, COLUMN) == 0) {
-                TBM_get_column_info(table, SAFE_GET_VALUE_PRE_INC(commands, argc, current_command), &expression->conditions[expression->condition_count].col_info);
-                expression->conditions[expression->condition_count].expression = SAFE_GET_VALUE_PRE_INC(commands, argc, current_command);
-                expression->conditions[expression->condition_count].value = SAFE_GET_VALUE_PRE_INC(commands, argc, current_command);
-                expression->condition_count++;
-            } 
-            else if (strcmp(operator, OR) == 0 || strcmp(operator, AND) == 0) {
-                expression->operators[expression->operator_count++] = operator;
-            } 
-            else if (strcmp(operator, OFFSET) == 0) {
-                expression->offset = atoi(SAFE_GET_VALUE_PRE_INC_S(commands, argc, current_command));
-            } 
-            else if (strcmp(operator, LIMIT) == 0) {
-                expression->limit = atoi(SAFE_GET_VALUE_PRE_INC_S(commands, argc, current_command));
+            for (int j = 0; j < layout.bloom_count; j++) {
+                if (layout.bloom_offsets[j] != current->col_info.offset) continue;
+                if (strcmp(current->expression, layout.bloom_numeric[j] ? EQUALS : STR_EQUALS) == 0) filter = "bloom filter";
             }
-            else break;
-        }  
-        
+
+            _explain_line(answer, "   filter: column %s %s %s (%s)", _get_command(commands, argc, i + 1), current->expression, current->value, filter);
+        }
+
+        if (exp.limit != -1 || exp.offset != 0) _explain_line(answer, "   limit=%i offset=%i", exp.limit, exp.offset);
         return 1;
     }
 
-    static int _evaluate_expression(unsigned char* row_data, expression_t* expression) {
-        int results[MAX_STATEMENTS] = { 0 };
-        #pragma omp parallel for schedule(dynamic, 2)
-        for (int i = 0; i < expression->condition_count; i++) {
-            results[i] = _compare_data(
-                expression->conditions[i].expression, (char*)(row_data + expression->conditions[i].col_info.offset), 
-                expression->conditions[i].col_info.size, expression->conditions[i].value, strlen(expression->conditions[i].value)
-            );
+    /*
+    Describe access path of get / update / delete command without execution.
+    */
+    static int _explain_plan(
+        database_t* database, char* commands[], int current_command, int argc, unsigned char access, kernel_answer_t* answer
+    ) {
+        char* command = _get_command(commands, argc, current_command);
+        int is_row = strcmp(_get_command(commands, argc, current_command + 1), ROW) == 0;
+        if (strcmp(command, GET) != 0 && ((strcmp(command, UPDATE) != 0 && strcmp(command, DELETE) != 0) || !is_row)) {
+            print_error("Explain supports only get, update row and delete row commands");
+            return -1;
         }
 
-        int match = results[0];
-        for (int i = 0; i < expression->operator_count; i++) {
-            if (strcmp(expression->operators[i], AND) == 0) match &= results[i + 1];
-            else if (strcmp(expression->operators[i], OR) == 0) match |= results[i + 1];
+        // Aggregate command has function instead of row: get <function> <table_name>
+        int command_index = current_command + 2;
+        char* table_name = _get_command(commands, argc, command_index);
+        table_t* table = _get_table(database, table_name);
+        if (!table) return -1;
+
+        if (strcmp(command, UPDATE) == 0) command_index++;
+        if (strcmp(_get_command(commands, argc, ++command_index), COLUMNS) == 0) {
+            while (*_get_command(commands, argc, ++command_index) != CLOSE_BRACKET && command_index < argc);
+            command_index++;
         }
 
-        return match;
-    }
+        char* path = _get_command(commands, argc, command_index);
+        if (strcmp(command, GET) == 0 && !is_row) {
+            _explain_line(answer, "-> aggregate %s (parallel page scan, threads=%i)", _get_command(commands, argc, current_command + 1), omp_get_max_threads());
+            _explain_scan(database, table, commands, command_index, argc, access, answer);
+        }
+        else if (strcmp(path, BY_INDEX) == 0) {
+            int index = atoi(_get_command(commands, argc, command_index + 1));
+            _explain_line(answer, "-> index %s on %s (row=%i page=%i)", strcmp(command, GET) == 0 ? "lookup" : "write", table_name, index, index / (PAGE_CONTENT_SIZE / table->row_size));
+        }
+        else if (strcmp(path, JOIN) == 0) {
+            char* join_table_name = _get_command(commands, argc, command_index + 1);
+            table_t* join_table = _get_second_table(database, table, join_table_name);
+            if (join_table) {
+                int build_is_first = (size_t)table->header->row_count * table->row_size <= (size_t)join_table->header->row_count * join_table->row_size;
+                _explain_line(
+                    answer, "-> hash join on %s = %s (build=%s probe=%s)", _get_command(commands, argc, command_index + 3), 
+                    _get_command(commands, argc, command_index + 5), build_is_first ? table_name : join_table_name, build_is_first ? join_table_name : table_name
+                );
+
+                _explain_line(answer, "-> page scan on %s (build)", build_is_first ? table_name : join_table_name);
+                _explain_line(answer, "-> page scan on %s (probe)", build_is_first ? join_table_name : table_name);
+                TBM_flush_table(join_table);
+            }
+        }
+        else if (strcmp(command, GET) == 0) {
+            int order_index = -1;
+            for (int i = command_index; i < argc && i < MAX_COMMANDS && commands[i] != NULL; i++) {
+                if (strcmp(commands[i], ORDER) == 0 && strcmp(_get_command(commands, argc, i + 1), BY) == 0) order_index = i;
+            }
 
-    static int __delete_logic(
-        database_t* database, char* table_name, int index, unsigned char* data, 
-        size_t data_size, unsigned char access, kernel_answer_t* answer
-    ) {
-        answer->answer_code = DB_insert_row(database, table_name, index, data, data_size, access);
+            if (order_index != -1) {
+                expression_t exp;
+                _create_expression(table, NULL, commands, command_index, argc, &exp);
+                char* column = _get_command(commands, argc, order_index + 2);
+                char* direction = strcmp(_get_command(commands, argc, order_index + 3), DESCENDING) == 0 ? DESCENDING : ASCENDING;
+                if (exp.limit != -1) _explain_line(answer, "-> order by %s %s (top-K heap, K=%i)", column, direction, exp.limit);
+                else _explain_line(answer, "-> order by %s %s (external merge sort, buffer=%i pages)", column, direction, SORT_BUFFER_PAGES);
+            }
+
+            _explain_scan(database, table, commands, command_index, argc, access, answer);
+        }
+        else {
+            _explain_line(answer, "-> set-based %s (one write per page)", command);
+            _explain_scan(database, table, commands, command_index, argc, access, answer);
+        }
+
+        TBM_flush_table(table);
         return 1;
     }
 
-    static int __insert_logic(
-        database_t* database, char* table_name, int index, unsigned char* data,
-        size_t data_size, unsigned char access, kernel_answer_t* answer
-    ) {
-        answer->answer_code = DB_delete_row(database, table_name, index, access);
-        return 1;
+    static void _explain_operator(kernel_answer_t* answer, char* name, operator_stats_t* stats) {
+        if (stats->calls == 0 && stats->rows_in == 0) return;
+
+        // Per-row operators (filter) are not timed
+        if (stats->calls == 0) _explain_line(answer, "   %s: rows_in=%llu rows_out=%llu", name, stats->rows_in, stats->rows_out);
+        else _explain_line(
+            answer, "   %s: calls=%u rows_in=%llu rows_out=%llu time=%lluus", 
+            name, stats->calls, stats->rows_in, stats->rows_out, stats->time
+        );
     }
 
-    static int __get_logic(
-        database_t* database, char* table_name, int index, unsigned char* data, 
-        size_t data_size, unsigned char access, kernel_answer_t* answer
+    /*
+    Explain command. With analyze command executed, and plan followed by counters of this execution.
+    Command syntax: explain [analyze] <command>
+    */
+    static int _explain_command(
+        database_t* database, char* commands[], int current_command, int argc, 
+        unsigned char access, int is_analyze, int connection, kernel_answer_t* answer
     ) {
-        int data_start = answer->answer_size;
-        answer->answer_size += data_size;
-        answer->answer_body = (unsigned char*)realloc(answer->answer_body, answer->answer_size);
-        memcpy(answer->answer_body + data_start, data, data_size);
+        if (!database) return -1;
+        if (_explain_plan(database, commands, current_command, argc, access, answer) != 1) return -1;
+        if (!is_analyze) return 1;
+
+        char* tokens[MAX_COMMANDS] = { NULL };
+        int count = 0;
+        for (int i = current_command; i < argc && i < MAX_COMMANDS && commands[i] != NULL; i++) tokens[count++] = commands[i];
+
+        QST_reset();
+        unsigned long long start = QST_time();
+        kernel_answer_t* nested = _process_nested(database, tokens, count, access, connection);
+        unsigned long long total_time = QST_time() - start;
+        if (!nested) return -1;
+
+        query_stats_t stats;
+        memcpy(&stats, QST_get(), sizeof(query_stats_t));
+        _explain_line(answer, "analyze:");
+        _explain_line(answer, "   tables: loads=%u cache_hits=%u", stats.table_loads, stats.table_hits);
+        _explain_line(answer, "   directories: loads=%u cache_hits=%u", stats.directory_loads, stats.directory_hits);
+        _explain_line(answer, "   pages: loads=%u cache_hits=%u skipped=%u", stats.page_loads, stats.page_hits, stats.pages_skipped);
+        _explain_line(answer, "   disk load time=%lluus", stats.load_time);
+
+        module_memo_stats_t memo;
+        MDL_get_memo_stats(&memo);
+        _explain_line(
+            answer, "   modules: calls=%u memo_hits=%u inline=%u (memo total: hits=%llu misses=%llu entries=%u/%u)", 
+            stats.module_calls, stats.module_hits, stats.module_inline, memo.hits, memo.misses, memo.entries, memo.capacity
+        );
+
+        char* names[QST_OPERATORS] = { "scan", "filter", "sort", "join", "aggregate", "mutation" };
+        for (int i = 0; i < QST_OPERATORS; i++) _explain_operator(answer, names[i], &stats.operators[i]);
+
+        _explain_line(answer, "   result: code=%i size=%u", nested->answer_code, nested->answer_body == NULL ? 0 : nested->answer_size);
+        _explain_line(answer, "   total time=%lluus", total_time);
+        kernel_free_answer(nested);
         return 1;
     }
 
-    static int _process_table(
-        database_t* database, table_t* table, kernel_answer_t* answer, expression_t* exp, unsigned char access, 
-        int (*logic)(database_t*, char*, int, unsigned char*, size_t, unsigned char, kernel_answer_t*)
+#pragma endregion
+
+#pragma region [Batch]
+
+    /*
+    Check, that statement is single row append: append row <table_name> values <data>
+    */
+    static int _is_row_append(char* tokens[], int count) {
+        return count == 5 && strcmp(tokens[0], APPEND) == 0 && strcmp(tokens[1], ROW) == 0 && strcmp(tokens[3], VALUES) == 0;
+    }
+
+    /*
+    Append rows of following row appends into same table with one table resolution and page writes.
+    If bulk append failed on validation, rows appended one by one, that's why every statement gets his own code.
+    Return count of processed statements.
+    */
+    static int _process_append_run(
+        database_t* database, char* tokens[], int starts[], int counts[], int statements, int first, unsigned char access, signed char codes[]
     ) {
-        int index = exp->offset;
-        int processed_rows = 0;
-        while (1) {
-            unsigned char* row_data = (unsigned char*)malloc(table->row_size);
-            if (!row_data) return -1;
+        char* table_name = tokens[starts[first] + 2];
+        int run = 1;
+        while (
+            first + run < statements && _is_row_append(tokens + starts[first + run], counts[first + run]) &&
+            strcmp(tokens[starts[first + run] + 2], table_name) == 0
+        ) run++;
+
+        int result = 0;
+        if (run > 1) {
+            arena_mark_t mark = ARN_mark(_arena);
+            unsigned char** rows = (unsigned char**)ARN_alloc(_arena, run * sizeof(unsigned char*));
+            size_t* rows_size = (size_t*)ARN_alloc(_arena, run * sizeof(size_t));
+            if (rows && rows_size) {
+                for (int i = 0; i < run; i++) {
+                    rows[i] = (unsigned char*)tokens[starts[first + i] + 4];
+                    rows_size[i] = strlen(tokens[starts[first + i] + 4]);
+                }
 
-            int get_result = DB_get_row(database, table->header->name, index, access, row_data, table->row_size);
-            if (!get_result) {
-                free(row_data);
-                break;
+                result = DB_append_rows(database, table_name, rows, rows_size, run, access);
             }
-            
-            if (*row_data != PAGE_EMPTY) {
-                if (_evaluate_expression(row_data, exp)) {
-                    if (exp->limit != -1 && processed_rows++ >= exp->limit) {
-                        free(row_data);
-                        break;
-                    }
-                    
-                    logic(database, table->header->name, index, row_data, table->row_size, access, answer);
+
+            ARN_release(_arena, mark);
+        }
+
+        // Validation codes returned before any write, that's why only wrong rows will fail in one by one append.
+        // Other codes reported for whole run, because rows can be already written.
+        int is_validation = result == 0 || result == -5 || result == -20 || (result <= -10 && result > -20);
+        for (int i = 0; i < run; i++) {
+            char* data = tokens[starts[first + i] + 4];
+            codes[first + i] = is_validation ? DB_append_row(database, table_name, (unsigned char*)data, strlen(data), access) : result;
+        }
+
+        return run;
+    }
+
+    /*
+    Execute statements of batch. Statements separated by BATCH_SEPARATOR, batch ends with END token.
+    Answer body is vector of statement codes (one byte per statement). Statement answers bodies dropped.
+    Atomic batch synced before and after execution. If any statement returns negative code, atomic batch rolled back.
+    Command syntax: batch [atomic] <statement> ; <statement> ; ... end
+
+    Return -1 if batch has no end, has too many statements or database not loaded.
+    Return -2 if atomic batch rolled back.
+    Return 1 if batch executed.
+    */
+    static int _process_batch(int connection, char* tokens[], int count, unsigned char access, kernel_answer_t* answer) {
+        int is_atomic = count > 0 && strcmp(tokens[0], ATOMIC) == 0;
+        int starts[MAX_BATCH_STATEMENTS] = { 0 };
+        int counts[MAX_BATCH_STATEMENTS] = { 0 };
+        int statements = 0;
+
+        int has_end = 0;
+        int start = is_atomic;
+        for (int i = start; i < count && tokens[i] != NULL; i++) {
+            int is_end = strcmp(tokens[i], END) == 0;
+            if (is_end || strcmp(tokens[i], BATCH_SEPARATOR) == 0) {
+                if (i > start) {
+                    if (statements >= MAX_BATCH_STATEMENTS) return -1;
+                    starts[statements] = start;
+                    counts[statements++] = i - start;
+                }
+
+                start = i + 1;
+                if (is_end) {
+                    has_end = 1;
+                    break;
                 }
             }
-            
-            index++;
-            free(row_data);
         }
 
-        return 1;
+        if (!has_end || _connections[connection] == NULL) return -1;
+        if (is_atomic) DB_init_transaction(_connections[connection]);
+
+        signed char* codes = (signed char*)malloc(MAX(statements, 1));
+        if (!codes) return -1;
+
+        int is_failed = 0;
+        for (int i = 0; i < statements;) {
+            // Statement can change session database (rollback), that's why database taken for every statement
+            database_t* database = _connections[connection];
+            char** statement = tokens + starts[i];
+            if (_is_row_append(statement, counts[i])) {
+                i += _process_append_run(database, tokens, starts, counts, statements, i, access, codes);
+                continue;
+            }
+
+            if (strcmp(statement[0], BATCH) == 0) codes[i] = -1;
+            else {
+                kernel_answer_t* nested = _process_nested(database, statement, counts[i], access, connection);
+                codes[i] = -1;
+                if (nested) {
+                    codes[i] = nested->answer_code;
+                    kernel_free_answer(nested);
+                }
+            }
+
+            i++;
+        }
+
+        for (int i = 0; i < statements; i++) {
+            if (codes[i] < 0) is_failed = 1;
+        }
+
+        int result = 1;
+        if (is_atomic) {
+            if (is_failed) result = DB_rollback(&_connections[connection]) == 1 ? -2 : -1;
+            else DB_init_transaction(_connections[connection]);
+        }
+
+        answer->answer_body = (unsigned char*)codes;
+        answer->answer_size = statements;
+        answer->answer_capacity = MAX(statements, 1);
+        return result;
     }
 
 #pragma endregion
 
 
-kernel_answer_t* kernel_process_command(int argc, char* argv[], unsigned char access, int connection) {
-    kernel_answer_t* answer = (kernel_answer_t*)malloc(sizeof(kernel_answer_t));
+#pragma region [Metrics]
+
+    // Commands with own metrics slot. Other commands recorded as MTR_OTHER_COMMAND.
+    static char* _metric_commands[] = {
+        SYNC, ROLLBACK, VERSION, STATS, CREATE, MIGRATE, DELETE, APPEND, UPDATE, GET,
+        OPEN, FETCH, CLOSE, PREPARE, EXECUTE, EXPLAIN, BATCH
+    };
+
+    static const char* _get_metric_name(char* command) {
+        for (int i = 0; command != NULL && i < (int)(sizeof(_metric_commands) / sizeof(_metric_commands[0])); i++) {
+            if (strcmp(command, _metric_commands[i]) == 0) return _metric_commands[i];
+        }
+
+        return MTR_OTHER_COMMAND;
+    }
+
+#pragma endregion
+
+
+/*
+Process command. First command token placed to command for metrics.
+*/
+static kernel_answer_t* _process_command(int argc, char* argv[], unsigned char access, int connection, char** command_name) {
+    // Nested commands (statements, batch, explain) use same arena after memory of outer command
+    _arena = &_arenas[connection];
+    arena_mark_t mark = ARN_mark(_arena);
+    kernel_answer_t* answer = (kernel_answer_t*)ARN_alloc(_arena, sizeof(kernel_answer_t));
     if (!answer) return NULL;
     memset(answer, 0, sizeof(kernel_answer_t));
+    answer->arena = _arena;
+    answer->mark = mark;
 
     int current_start = 1;
     char* db_name = SAFE_GET_VALUE_POST_INC_S(argv, argc, current_start);
@@ -180,6 +1627,8 @@ kernel_answer_t* kernel_process_command(int argc, char* argv[], unsigned char ac
             else {
                 DB_free_database(_connections[connection]);
                 _connections[connection] = NULL;
+                _free_cursor(connection);
+                _free_statements(connection);
             }
         }
     }
@@ -190,10 +1639,13 @@ kernel_answer_t* kernel_process_command(int argc, char* argv[], unsigned char ac
     Save commands into RAM.
     */
     char* commands[MAX_COMMANDS] = { NULL };
-    for (int i = current_start; i < argc; i++) {
-        commands[i - current_start] = argv[i];
+    int commands_count = MIN(argc - current_start, MAX_COMMANDS);
+    for (int i = 0; i < commands_count; i++) {
+        commands[i] = argv[current_start + i];
     }
 
+    *command_name = commands[0];
+
     /*
     Handle command.
     */
@@ -228,20 +1680,33 @@ kernel_answer_t* kernel_process_command(int argc, char* argv[], unsigned char ac
             answer->answer_size = strlen(KERNEL_VERSION);
         }
 #endif
+        /*
+        Handle server metrics command. Answer is text with latency percentiles of every command type and counters
+        of cache, page I/O and locks since server start.
+        Command syntax: stats
+        */
+        else if (strcmp(command, STATS) == 0) {
+            char text[MTR_TEXT_SIZE];
+            int text_size = MTR_get_text(text, sizeof(text));
+            answer->answer_body = (unsigned char*)malloc(text_size);
+            if (!answer->answer_body) return answer;
+            memcpy(answer->answer_body, text, text_size);
+            answer->answer_size = text_size;
+        }
         /*
         Handle migration.
         Command syntax: migrate <src_table_name> <dst_table_name> nav ( ... )
         */
 #ifndef NO_MIGRATE_COMMAND
         else if (strcmp(command, MIGRATE) == 0) {
-            char* src_table_name = SAFE_GET_VALUE_PRE_INC_S(commands, argc, command_index);
-            char* dst_table_name = SAFE_GET_VALUE_PRE_INC_S(commands, argc, command_index);
-            if (strcmp(SAFE_GET_VALUE_PRE_INC_S(commands, argc, command_index), NAV) == 0) {
-                if (*(SAFE_GET_VALUE_PRE_INC_S(commands, argc, command_index)) == OPEN_BRACKET) {
+            char* src_table_name = SAFE_GET_VALUE_PRE_INC_S(commands, commands_count, command_index);
+            char* dst_table_name = SAFE_GET_VALUE_PRE_INC_S(commands, commands_count, command_index);
+            if (strcmp(SAFE_GET_VALUE_PRE_INC_S(commands, commands_count, command_index), NAV) == 0) {
+                if (*(SAFE_GET_VALUE_PRE_INC_S(commands, commands_count, command_index)) == OPEN_BRACKET) {
                     int nav_stack_index = 0;
                     char* nav_stack[128] = { NULL };
-                    while (*(SAFE_GET_VALUE_PRE_INC_S(commands, argc, command_index)) != CLOSE_BRACKET) {
-                        nav_stack[nav_stack_index++] = SAFE_GET_VALUE_S(commands, argc, command_index);
+                    while (*(SAFE_GET_VALUE_PRE_INC_S(commands, commands_count, command_index)) != CLOSE_BRACKET) {
+                        nav_stack[nav_stack_index++] = SAFE_GET_VALUE_S(commands, commands_count, command_index);
                     }
 
                     table_t* src_table = _get_table(database, src_table_name);
@@ -266,8 +1731,8 @@ kernel_answer_t* kernel_process_command(int argc, char* argv[], unsigned char ac
             Command syntax: create database <name>
             */
             command_index++;
-            if (strcmp(SAFE_GET_VALUE_S(commands, argc, command_index), DATABASE) == 0) {
-                char* database_name = SAFE_GET_VALUE_PRE_INC(commands, argc, command_index);
+            if (strcmp(SAFE_GET_VALUE_S(commands, commands_count, command_index), DATABASE) == 0) {
+                char* database_name = SAFE_GET_VALUE_PRE_INC(commands, commands_count, command_index);
                 if (!database_name) return answer;
 
                 database_t* new_database = DB_create_database(database_name);
@@ -282,12 +1747,13 @@ kernel_answer_t* kernel_process_command(int argc, char* argv[], unsigned char ac
             }
             /*
             Handle table creation.
-            Command syntax: create table <name> <rwd/same> columns ( name size <int/str/"<module>=args,<mpre/mpost/both>"/any> <is_primary/np> <auto_increment/na> )
+            Command syntax: create table <name> <rwd/same> columns ( name size <int/str/"<module>=args,<mpre/mpost/both>"/any> <is_primary/np> <auto_increment/na> ) bloom ( name ... )
+            Note: Bloom part is optional. Pages keep Bloom filters for listed columns.
             Errors:
             - Return -1 if table already exists in database.
             */
-            else if (strcmp(SAFE_GET_VALUE_S(commands, argc, command_index), TABLE) == 0) {
-                char* table_name = SAFE_GET_VALUE_PRE_INC(commands, argc, command_index);
+            else if (strcmp(SAFE_GET_VALUE_S(commands, commands_count, command_index), TABLE) == 0) {
+                char* table_name = SAFE_GET_VALUE_PRE_INC(commands, commands_count, command_index);
                 table_t* table = _get_table(database, table_name);
                 if (table) { // Table already exist
                     TBM_flush_table(table);
@@ -295,20 +1761,22 @@ kernel_answer_t* kernel_process_command(int argc, char* argv[], unsigned char ac
                 }
 
                 unsigned char access_byte = access;
-                char* table_access = SAFE_GET_VALUE_PRE_INC_S(commands, argc, command_index);                
+                char* table_access = SAFE_GET_VALUE_PRE_INC_S(commands, commands_count, command_index);                
                 if (strcmp(table_access, ACCESS_SAME) != 0) {
                     access_byte = CREATE_ACCESS_BYTE((table_access[0] - '0'), (table_access[1] - '0'), (table_access[2] - '0'));
                     access_byte = (access_byte < access) ? access : access_byte;
                 }
 
                 int column_count = 0;
+                unsigned char page_layout = PAGE_LAYOUT_ROWS;
+                unsigned char page_codec = CDC_NONE;
                 table_column_t** columns = NULL;
-                if (strcmp(SAFE_GET_VALUE_PRE_INC_S(commands, argc, command_index), COLUMNS) == 0) {
-                    if (*(SAFE_GET_VALUE_PRE_INC_S(commands, argc, command_index)) == OPEN_BRACKET) {
+                if (strcmp(SAFE_GET_VALUE_PRE_INC_S(commands, commands_count, command_index), COLUMNS) == 0) {
+                    if (*(SAFE_GET_VALUE_PRE_INC_S(commands, commands_count, command_index)) == OPEN_BRACKET) {
                         int current_stack_pointer = 0;
                         char* column_stack[512] = { NULL };
-                        while (*(SAFE_GET_VALUE_PRE_INC_S(commands, argc, command_index)) != CLOSE_BRACKET) {
-                            column_stack[current_stack_pointer++] = SAFE_GET_VALUE(commands, argc, command_index);
+                        while (*(SAFE_GET_VALUE_PRE_INC_S(commands, commands_count, command_index)) != CLOSE_BRACKET) {
+                            column_stack[current_stack_pointer++] = SAFE_GET_VALUE(commands, commands_count, command_index);
                         }
 
                         column_count = current_stack_pointer / 5;
@@ -326,6 +1794,14 @@ kernel_answer_t* kernel_process_command(int argc, char* argv[], unsigned char ac
                             else if (strcmp(column_data_type, TYPE_ANY) == 0) data_type = COLUMN_TYPE_ANY;
                             else if (strcmp(column_data_type, TYPE_STRING) == 0) data_type = COLUMN_TYPE_STRING;
 
+                            // Binary kinds have fixed size. Kind placed in data type bits with binary bit.
+                            int binary_type = -1;
+                            if (strcmp(column_data_type, TYPE_I32) == 0) binary_type = COLUMN_BINARY_I32;
+                            else if (strcmp(column_data_type, TYPE_I64) == 0) binary_type = COLUMN_BINARY_I64;
+                            else if (strcmp(column_data_type, TYPE_F64) == 0) binary_type = COLUMN_BINARY_F64;
+                            else if (strcmp(column_data_type, TYPE_DEC) == 0) binary_type = COLUMN_BINARY_DECIMAL;
+                            if (binary_type != -1) data_type = binary_type;
+
                             // Get column primary status
                             unsigned char primary_status = COLUMN_NOT_PRIMARY;
                             if (strcmp(column_stack[j + 3], PRIMARY) == 0) primary_status = COLUMN_PRIMARY;
@@ -334,11 +1810,15 @@ kernel_answer_t* kernel_process_command(int argc, char* argv[], unsigned char ac
                             unsigned char increment_status = COLUMN_NO_AUTO_INC;
                             if (strcmp(column_stack[j + 4], AUTO_INC) == 0) increment_status = COLUMN_AUTO_INCREMENT;
 
-                            columns[k] = TBM_create_column(
-                                CREATE_COLUMN_TYPE_BYTE(primary_status, data_type, increment_status), atoi(column_stack[j + 1]), column_stack[j]
-                            );
+                            int column_size = atoi(column_stack[j + 1]);
+                            unsigned char column_type = CREATE_COLUMN_TYPE_BYTE(primary_status, data_type, increment_status);
+                            if (binary_type != -1) {
+                                column_type = SET_COLUMN_BINARY(column_type);
+                                column_size = binary_type == COLUMN_BINARY_I32 ? sizeof(int32_t) : sizeof(long long);
+                            }
 
-                            if (data_type == COLUMN_TYPE_MODULE) {
+                            columns[k] = TBM_create_column(column_type, column_size, column_stack[j]);
+                            if (binary_type == -1 && data_type == COLUMN_TYPE_MODULE) {
                                 char* equals_pos = strchr(column_data_type, '=');
                                 char* comma_pos  = strchr(column_data_type, ',');
 
@@ -350,16 +1830,45 @@ kernel_answer_t* kernel_process_command(int argc, char* argv[], unsigned char ac
                                     strncpy(columns[k]->module_name, column_data_type, MIN(equals_pos - column_data_type, MODULE_NAME_SIZE));
                                     strncpy(columns[k]->module_querry, equals_pos + 1, MIN(comma_pos - equals_pos - 1, COLUMN_MODULE_SIZE));
                                     print_debug(
-                                        "Module [%s] registered with [%s] querry", columns[k]->module_name, columns[column_count]->module_querry
+                                        "Module [%s] registered with [%s] querry", columns[k]->module_name, columns[k]->module_querry
                                     );
                                 }
                             }
 
                             print_debug("%i) Column [%s] with args: [%i], created success!", k, column_stack[j], columns[k]->type);
                         }
+
+                        if (strcmp(_get_command(commands, commands_count, command_index + 1), BLOOM) == 0) {
+                            command_index++;
+                            if (*(SAFE_GET_VALUE_PRE_INC_S(commands, commands_count, command_index)) == OPEN_BRACKET) {
+                                for (char* name = SAFE_GET_VALUE_PRE_INC(commands, commands_count, command_index); name && *name != CLOSE_BRACKET; name = SAFE_GET_VALUE_PRE_INC(commands, commands_count, command_index)) {
+                                    for (int k = 0; k < column_count; k++) {
+                                        if (strcmp(columns[k]->name, name) == 0) columns[k]->type = SET_COLUMN_BLOOM(columns[k]->type);
+                                    }
+                                }
+                            }
+                        }
+
+                        if (strcmp(_get_command(commands, commands_count, command_index + 1), LAYOUT) == 0) {
+                            command_index++;
+                            if (strcmp(SAFE_GET_VALUE_PRE_INC_S(commands, commands_count, command_index), LAYOUT_PAX) == 0) page_layout = PAGE_LAYOUT_PAX;
+                        }
+
+                        if (strcmp(_get_command(commands, commands_count, command_index + 1), COMPRESS) == 0) {
+                            command_index++;
+                            if (strcmp(SAFE_GET_VALUE_PRE_INC_S(commands, commands_count, command_index), CODEC_LZ) == 0) page_codec = CDC_LZ;
+                        }
                     }
                 }
 
+                // First byte of row marks empty row, that's why binary value can't be placed there
+                if (column_count > 0 && columns[0] != NULL && GET_COLUMN_BINARY(columns[0]->type)) {
+                    print_error("First column of table [%s] can't have binary type", table_name);
+                    answer->answer_code = 6;
+                    ARRAY_SOFT_FREE(columns, column_count);
+                    return answer;
+                }
+
                 table_t* new_table = TBM_create_table(table_name, columns, column_count, access_byte);
                 if (!new_table) {
                     answer->answer_code = 6;
@@ -367,6 +1876,8 @@ kernel_answer_t* kernel_process_command(int argc, char* argv[], unsigned char ac
                     return answer;
                 }
 
+                new_table->header->layout = page_layout;
+                new_table->header->codec = page_codec;
                 DB_link_table2database(database, new_table);
                 CHC_add_entry(new_table, new_table->header->name, TABLE_BASE_PATH, TABLE_CACHE, (void*)TBM_free_table, (void*)TBM_save_table);
                 print_log("Table [%s] create success!", new_table->header->name);
@@ -386,10 +1897,10 @@ kernel_answer_t* kernel_process_command(int argc, char* argv[], unsigned char ac
         - Return -2 error if data size not equals row size.
         */
         else if (strcmp(command, APPEND) == 0) {
-            if (strcmp(SAFE_GET_VALUE_PRE_INC_S(commands, argc, command_index), ROW) == 0) {
-                char* table_name = SAFE_GET_VALUE_PRE_INC(commands, argc, command_index);
-                if (strcmp(SAFE_GET_VALUE_PRE_INC_S(commands, argc, command_index), VALUES) == 0) {
-                    char* input_data = SAFE_GET_VALUE_PRE_INC(commands, argc, command_index);
+            if (strcmp(SAFE_GET_VALUE_PRE_INC_S(commands, commands_count, command_index), ROW) == 0) {
+                char* table_name = SAFE_GET_VALUE_PRE_INC(commands, commands_count, command_index);
+                if (strcmp(SAFE_GET_VALUE_PRE_INC_S(commands, commands_count, command_index), VALUES) == 0) {
+                    char* input_data = SAFE_GET_VALUE_PRE_INC(commands, commands_count, command_index);
                     int result = DB_append_row(database, table_name, (unsigned char*)input_data, strlen(input_data), access);
                     if (result >= 0) { print_log("Row [%s] successfully added to [%s] database!", input_data, database->header->name); }
                     else {
@@ -400,6 +1911,113 @@ kernel_answer_t* kernel_process_command(int argc, char* argv[], unsigned char ac
                     answer->answer_code = result;
                 }
             }
+            /*
+            Command syntax: append rows <table_name> values ( <data> <data> ... )
+            Note: Batch is atomic. If any row is wrong, nothing will be appended.
+            Errors:
+            - Return -3 error if rows list has no closing bracket.
+            */
+            else if (strcmp(SAFE_GET_VALUE_S(commands, commands_count, command_index), ROWS) == 0) {
+                char* table_name = SAFE_GET_VALUE_PRE_INC(commands, commands_count, command_index);
+                if (strcmp(SAFE_GET_VALUE_PRE_INC_S(commands, commands_count, command_index), VALUES) == 0) {
+                    if (*(SAFE_GET_VALUE_PRE_INC_S(commands, commands_count, command_index)) == OPEN_BRACKET) {
+                        // Rows taken from argv, because bulk append can be longer then MAX_COMMANDS
+                        int rows_start = current_start + command_index + 1;
+                        int rows_end = rows_start;
+                        while (rows_end < argc && *argv[rows_end] != CLOSE_BRACKET) rows_end++;
+                        if (rows_end >= argc) {
+                            answer->answer_size = -1;
+                            answer->answer_code = -3;
+                            break;
+                        }
+
+                        size_t rows_count = rows_end - rows_start;
+                        unsigned char** rows = (unsigned char**)ARN_alloc(_arena, (rows_count + 1) * sizeof(unsigned char*));
+                        size_t* rows_size = (size_t*)ARN_alloc(_arena, (rows_count + 1) * sizeof(size_t));
+                        if (!rows || !rows_size) return answer;
+                        for (size_t j = 0; j < rows_count; j++) {
+                            rows[j] = (unsigned char*)argv[rows_start + j];
+                            rows_size[j] = strlen(argv[rows_start + j]);
+                        }
+
+                        int result = DB_append_rows(database, table_name, rows, rows_size, rows_count, access);
+                        if (result >= 0) { print_log("[%li] rows successfully added to [%s] table!", rows_count, table_name); }
+                        else {
+                            print_error("Error code: %i, Params: [%s] [%s] [%li] [%i]", result, database->header->name, table_name, rows_count, access);
+                        }
+
+                        answer->answer_size = -1;
+                        answer->answer_code = result;
+                    }
+                }
+            }
+        }
+        /*
+        Handle cursor opening. Cursor keeps scan state in session between fetches.
+        Note: Session can have only one cursor. New cursor will close previous.
+        Command syntax: open cursor <table_name> columns ( <column_name> ... ) by_exp <expression>
+        */
+        else if (strcmp(command, OPEN) == 0) {
+            if (strcmp(SAFE_GET_VALUE_PRE_INC_S(commands, commands_count, command_index), CURSOR) == 0) {
+                answer->answer_code = _open_cursor(database, connection, commands, i, commands_count);
+                if (answer->answer_code != 1) _free_cursor(connection);
+            }
+        }
+        /*
+        Handle batch. Statements executed in one message, answer is vector of statement codes.
+        Batch tokens taken from argv, because batch can be longer then MAX_COMMANDS.
+        Command syntax: batch [atomic] <statement> ; <statement> ; ... end
+        */
+        else if (strcmp(command, BATCH) == 0) {
+            int batch_start = current_start + i + 1;
+            answer->answer_code = _process_batch(connection, argv + batch_start, argc - batch_start, access, answer);
+            break;
+        }
+        /*
+        Handle explain. Rest of command will be described (and executed with analyze).
+        Command syntax: explain [analyze] <get/update/delete command>
+        */
+        else if (strcmp(command, EXPLAIN) == 0) {
+            int is_analyze = strcmp(_get_command(commands, commands_count, i + 1), ANALYZE) == 0;
+            answer->answer_code = _explain_command(database, commands, i + 1 + is_analyze, commands_count, access, is_analyze, connection, answer);
+            break;
+        }
+        /*
+        Handle statement prepare. Rest of command will be saved in session as statement.
+        Command syntax: prepare <name> <command with ?>
+        */
+        else if (strcmp(command, PREPARE) == 0) {
+            answer->answer_code = _prepare_statement(database, connection, commands, i, commands_count);
+            break;
+        }
+        /*
+        Handle statement execute. Every param will replace ? in statement.
+        Command syntax: execute <name> <params...>
+        */
+        else if (strcmp(command, EXECUTE) == 0) {
+            if (_execute_statement(database, connection, commands, i, commands_count, access, answer) != 1) answer->answer_code = -1;
+            break;
+        }
+        /*
+        Handle cursor fetch. Answer size limited by CURSOR_FETCH_SIZE.
+        Note: Answer without body (code 0) means, that cursor reached end.
+        Command syntax: fetch <count>
+        */
+        else if (strcmp(command, FETCH) == 0) {
+            int count = atoi(SAFE_GET_VALUE_PRE_INC_S(commands, commands_count, command_index));
+            answer->answer_code = MIN(_fetch_cursor(database, connection, count, access, answer), 1);
+        }
+        /*
+        Handle cursor or statement close.
+        Command syntax: close cursor / close statement <name>
+        */
+        else if (strcmp(command, CLOSE) == 0) {
+            char* target = SAFE_GET_VALUE_PRE_INC_S(commands, commands_count, command_index);
+            if (strcmp(target, CURSOR) == 0) answer->answer_code = _free_cursor(connection);
+            else if (strcmp(target, STATEMENT) == 0) {
+                int index = _find_statement(connection, SAFE_GET_VALUE_PRE_INC_S(commands, commands_count, command_index));
+                answer->answer_code = index == -1 ? -1 : _free_statement(connection, index);
+            }
         }
         /*
         Handle get command.
@@ -409,8 +2027,8 @@ kernel_answer_t* kernel_process_command(int argc, char* argv[], unsigned char ac
             /*
             Command syntax: get row <table_name> <operation_type> <options>
             */
-            if (strcmp(SAFE_GET_VALUE_PRE_INC_S(commands, argc, command_index), ROW) == 0) {
-                char* table_name = SAFE_GET_VALUE_PRE_INC(commands, argc, command_index);
+            if (strcmp(SAFE_GET_VALUE_PRE_INC_S(commands, commands_count, command_index), ROW) == 0) {
+                char* table_name = SAFE_GET_VALUE_PRE_INC(commands, commands_count, command_index);
                 table_t* table = _get_table(database, table_name);
                 if (!table) return answer;
 
@@ -418,37 +2036,125 @@ kernel_answer_t* kernel_process_command(int argc, char* argv[], unsigned char ac
                 int answer_size = 0;
                 int index = -1;
 
+                /*
+                Note: Will return only provided columns in provided order.
+                Command syntax: get row <table_name> columns ( <column_name> ... ) <operation_type> <options>
+                */
+                projection_t projection = { .column_count = 0 };
+                command_index++;
+                if (strcmp(SAFE_GET_VALUE_S(commands, commands_count, command_index), COLUMNS) == 0) {
+                    if (_create_projection(table, commands, &command_index, commands_count, &projection) != 1) {
+                        print_error("Wrong columns projection for table [%s]", table_name);
+                        answer->answer_code = -1;
+                        TBM_flush_table(table);
+                        return answer;
+                    }
+
+                    command_index++;
+                }
+
                 /*
                 Note: Will get entire row.
                 Command syntax: get row <table_name> by_index <index>
                 */
-                command_index++;
-                if (strcmp(SAFE_GET_VALUE_S(commands, argc, command_index), BY_INDEX) == 0) {
-                    int index = atoi(SAFE_GET_VALUE_PRE_INC_S(commands, argc, command_index));
-                    answer->answer_body = (unsigned char*)malloc(table->row_size);
+                if (strcmp(SAFE_GET_VALUE_S(commands, commands_count, command_index), BY_INDEX) == 0) {
+                    int index = atoi(SAFE_GET_VALUE_PRE_INC_S(commands, commands_count, command_index));
+                    answer->answer_body = (unsigned char*)malloc(table->text_row_size);
                     if (!answer->answer_body) {
                         return answer;
                     }
 
-                    if (!DB_get_row(database, table_name, index, access, answer->answer_body, table->row_size)) {
+                    unsigned char row_data[PAGE_CONTENT_SIZE];
+                    unsigned char* columns = projection.column_count > 0 ? projection.mask : NULL;
+                    if (!DB_get_row(database, table_name, index, access, row_data, table->row_size, columns)) {
                         print_error("Something goes wrong! Params: [%.*s] [%s] [%i] [%i]", DATABASE_NAME_SIZE, database->header->name, table_name, index, access);
                         answer->answer_code = 8;
                         return answer;
                     }
 
-                    answer->answer_size = table->row_size;
+                    answer->answer_size = _output_row(table, &projection, row_data, answer->answer_body);
+                    QST_add(rows_returned, 1);
+
                     answer->answer_code = (char)index;
                 }
                 /*
+                Note: will get rows of both tables, where values in provided columns are equal.
+                Command syntax: get row <table_name> join <table_name> on <column_name> = <column_name> by_exp <expression>
+                */
+                else if (strcmp(SAFE_GET_VALUE_S(commands, commands_count, command_index), JOIN) == 0) {
+                    char* join_table_name = SAFE_GET_VALUE_PRE_INC(commands, commands_count, command_index);
+                    table_t* join_table = join_table_name ? _get_second_table(database, table, join_table_name) : NULL;
+                    if (!join_table) {
+                        TBM_flush_table(table);
+                        return answer;
+                    }
+
+                    answer->answer_code = -1;
+                    if (strcmp(_get_command(commands, commands_count, command_index + 1), ON) == 0 && strcmp(_get_command(commands, commands_count, command_index + 3), EQUALS) == 0) {
+                        char* first_column = _get_command(commands, commands_count, command_index + 2);
+                        char* second_column = _get_command(commands, commands_count, command_index + 4);
+                        command_index += 4;
+
+                        expression_t exp = { .condition_count = 0, .operator_count = 0, .offset = 0, .limit = -1 };
+                        if (strcmp(_get_command(commands, commands_count, command_index + 1), BY_EXPRESSION) == 0) {
+                            _create_expression(table, join_table, commands, command_index + 1, commands_count, &exp);
+                        }
+
+                        answer->answer_code = _process_join(database, table, join_table, first_column, second_column, &exp, access, answer);
+                    }
+
+                    TBM_flush_table(join_table);
+                }
+                /*
                 Note: will get line of rows, that equals expression.
                 Command syntax: get row table <table_name> by_exp column <column_name> <</>/!=/=/eq/neq> <value> <or/and> ... limit <limit>
                 */
-                else if (strcmp(SAFE_GET_VALUE_S(commands, argc, command_index), BY_EXPRESSION) == 0) {      
+                else if (strcmp(SAFE_GET_VALUE_S(commands, commands_count, command_index), BY_EXPRESSION) == 0) {      
                     expression_t exp;
-                    _create_expression(table, commands, command_index, argc, &exp);
-                    _process_table(database, table, answer, &exp, access, __get_logic);
+                    _create_expression(table, NULL, commands, command_index, commands_count, &exp);
+
+                    /*
+                    Note: will sort rows by column. With limit will return only first <limit> rows.
+                    Command syntax: get row <table_name> by_exp <expression> order by <column_name> <asc/desc>
+                    */
+                    sorter_t* sorter = NULL;
+                    int sort_status = _create_sorter(table, commands, command_index, commands_count, &exp, &projection, &sorter);
+                    if (sort_status == 0) _process_table(database, table, answer, &exp, &projection, access, __get_logic);
+                    else if (sort_status == 1) answer->answer_code = _process_sorted(database, table, answer, &exp, &projection, sorter, access);
+                    else answer->answer_code = -1;
+                    SRT_free_sorter(sorter);
+                }
+
+                TBM_flush_table(table);
+            }
+            /*
+            Note: Will return only aggregate result. Without group by it will be one value.
+            Command syntax: get <count/sum(col)/min(col)/max(col)/avg(col)> <table_name> by_exp <expression> group by <column_name>
+            */
+            else {
+                char* function = SAFE_GET_VALUE_S(commands, commands_count, command_index);
+                char* table_name = SAFE_GET_VALUE_PRE_INC(commands, commands_count, command_index);
+                if (!table_name) return answer;
+
+                table_t* table = _get_table(database, table_name);
+                if (!table) return answer;
+
+                aggregate_t aggregate;
+                answer->answer_code = _create_aggregate(table, function, &aggregate);
+
+                expression_t exp = { .condition_count = 0, .operator_count = 0, .offset = 0, .limit = -1 };
+                for (int j = command_index + 1; j < commands_count && commands[j] != NULL && answer->answer_code == 1; j++) {
+                    if (strcmp(commands[j], BY_EXPRESSION) == 0) _create_expression(table, NULL, commands, j, commands_count, &exp);
+                    else if (strcmp(commands[j], GROUP) == 0 && strcmp(_get_command(commands, commands_count, j + 1), BY) == 0) {
+                        int column_index = _get_column_index(table, _get_command(commands, commands_count, j + 2), &aggregate.group);
+                        if (column_index == -1) answer->answer_code = -1;
+                        else aggregate.mask[column_index] = 1;
+                    }
                 }
 
+                if (answer->answer_code == 1) answer->answer_code = _process_aggregate(database, table, answer, &exp, &aggregate, access);
+                else print_error("Wrong aggregate [%s] for table [%s]", function, table_name);
+
                 TBM_flush_table(table);
             }
         }
@@ -461,29 +2167,34 @@ kernel_answer_t* kernel_process_command(int argc, char* argv[], unsigned char ac
             /*
             Command syntax: update row <table_name> <new_data> <option>
             */
-            if (strcmp(SAFE_GET_VALUE_PRE_INC_S(commands, argc, command_index), ROW) == 0) {
+            if (strcmp(SAFE_GET_VALUE_PRE_INC_S(commands, commands_count, command_index), ROW) == 0) {
                 int index = -1;
-                char* table_name = SAFE_GET_VALUE_PRE_INC(commands, argc, command_index);
-                char* data = SAFE_GET_VALUE_PRE_INC(commands, argc, command_index);
+                char* table_name = SAFE_GET_VALUE_PRE_INC(commands, commands_count, command_index);
+                char* data = SAFE_GET_VALUE_PRE_INC(commands, commands_count, command_index);
 
                 /*
                 Command syntax: update row <table_name> <new_data> by_index <index>
                 */
                 command_index++;
-                if (strcmp(SAFE_GET_VALUE_S(commands, argc, command_index), BY_INDEX) == 0) {
-                    index = atoi(SAFE_GET_VALUE_PRE_INC_S(commands, argc, command_index));
+                if (strcmp(SAFE_GET_VALUE_S(commands, commands_count, command_index), BY_INDEX) == 0) {
+                    index = atoi(SAFE_GET_VALUE_PRE_INC_S(commands, commands_count, command_index));
                     answer->answer_code = DB_insert_row(database, table_name, index, (unsigned char*)data, strlen(data), access);
                 }
                 /*
-                Command syntax: update row <table_name> <new_data> by_exp column <column_name> <</>/!=/=/eq/neq> <value> values <data>
+                Command syntax: update row <table_name> <new_data> by_exp column <column_name> <</>/!=/=/eq/neq> <value>
                 */
-                else if (strcmp(SAFE_GET_VALUE_S(commands, argc, command_index), BY_EXPRESSION) == 0) {
+                else if (strcmp(SAFE_GET_VALUE_S(commands, commands_count, command_index), BY_EXPRESSION) == 0) {
                     table_t* table = _get_table(database, table_name);
                     if (!table) return answer;
                                         
-                    expression_t exp;
-                    _create_expression(table, commands, command_index, argc, &exp);
-                    _process_table(database, table, answer, &exp, access, __insert_logic);
+                    answer->answer_code = DB_prepare_row(database, table_name, (unsigned char*)data, strlen(data), access);
+                    if (answer->answer_code == 1) {
+                        expression_t exp;
+                        _create_expression(table, NULL, commands, command_index, commands_count, &exp);
+                        answer->answer_code = _process_mutation(database, table, &exp, (unsigned char*)data, access) < 0 ? -1 : 1;
+                    }
+
+                    TBM_flush_table(table);
                 }
             }
         }
@@ -500,7 +2211,7 @@ kernel_answer_t* kernel_process_command(int argc, char* argv[], unsigned char ac
             Command syntax: delete database
             */
             command_index++;
-            if (strcmp(SAFE_GET_VALUE_S(commands, argc, command_index), DATABASE) == 0) {
+            if (strcmp(SAFE_GET_VALUE_S(commands, commands_count, command_index), DATABASE) == 0) {
                 if (DB_delete_database(database, 1)) {
                     print_log("Current database was delete successfully.");
                     _connections[connection] = NULL;
@@ -513,8 +2224,8 @@ kernel_answer_t* kernel_process_command(int argc, char* argv[], unsigned char ac
             /*
             Command syntax: delete table <name>
             */
-            else if (strcmp(SAFE_GET_VALUE_S(commands, argc, command_index), TABLE) == 0) {
-                char* table_name = SAFE_GET_VALUE_PRE_INC(commands, argc, command_index);
+            else if (strcmp(SAFE_GET_VALUE_S(commands, commands_count, command_index), TABLE) == 0) {
+                char* table_name = SAFE_GET_VALUE_PRE_INC(commands, commands_count, command_index);
                 if (DB_delete_table(database, table_name, 1)) print_log("Table [%s] was delete successfully.", table_name);
                 else {
                     print_error("Error code 1 during deleting %s", table_name);
@@ -524,28 +2235,29 @@ kernel_answer_t* kernel_process_command(int argc, char* argv[], unsigned char ac
             /*
             Command syntax: delete row <table_name> <operation_type> <options>
             */
-            else if (strcmp(SAFE_GET_VALUE_S(commands, argc, command_index), ROW) == 0) {
-                char* table_name = SAFE_GET_VALUE_PRE_INC(commands, argc, command_index);
+            else if (strcmp(SAFE_GET_VALUE_S(commands, commands_count, command_index), ROW) == 0) {
+                char* table_name = SAFE_GET_VALUE_PRE_INC(commands, commands_count, command_index);
 
                 /*
                 Note: Will delete entire row.
                 Command syntax: delete row <table_name> by_index <index>
                 */
                 command_index++;
-                if (strcmp(SAFE_GET_VALUE_S(commands, argc, command_index), BY_INDEX) == 0) {
-                    answer->answer_code = DB_delete_row(database, table_name, atoi(SAFE_GET_VALUE_PRE_INC_S(commands, argc, command_index)), access);
+                if (strcmp(SAFE_GET_VALUE_S(commands, commands_count, command_index), BY_INDEX) == 0) {
+                    answer->answer_code = DB_delete_row(database, table_name, atoi(SAFE_GET_VALUE_PRE_INC_S(commands, commands_count, command_index)), access);
                 }
                 /*
                 Note: will delete all rows, where will find value in provided column.
                 Command syntax: delete row <table_name> by_exp column <column_name> <</>/!=/=/eq/neq> <value>
                 */
-                else if (strcmp(SAFE_GET_VALUE_S(commands, argc, command_index), BY_EXPRESSION) == 0) {
+                else if (strcmp(SAFE_GET_VALUE_S(commands, commands_count, command_index), BY_EXPRESSION) == 0) {
                     table_t* table = _get_table(database, table_name);
                     if (!table) return answer;
                     
                     expression_t exp;
-                    _create_expression(table, commands, command_index, argc, &exp);
-                    _process_table(database, table, answer, &exp, access, __delete_logic);
+                    _create_expression(table, NULL, commands, command_index, commands_count, &exp);
+                    answer->answer_code = _process_mutation(database, table, &exp, NULL, access) < 0 ? -1 : 1;
+                    TBM_flush_table(table);
                 }
             }
 
@@ -557,8 +2269,19 @@ kernel_answer_t* kernel_process_command(int argc, char* argv[], unsigned char ac
     return answer;
 }
 
+kernel_answer_t* kernel_process_command(int argc, char* argv[], unsigned char access, int connection) {
+    char* command = NULL;
+    unsigned long long start = QST_time();
+    kernel_answer_t* answer = _process_command(argc, argv, access, connection, &command);
+    MTR_command(_get_metric_name(command), QST_time() - start, answer == NULL || answer->answer_code < 0);
+    return answer;
+}
+
 int close_connection(int connection) {
     _flush_tables();
+    _free_cursor(connection);
+    _free_statements(connection);
+    ARN_free(&_arenas[connection]);
     if (_connections[connection] == NULL) return -2;
     DB_free_database(_connections[connection]);
     _connections[connection] = NULL;
@@ -567,14 +2290,16 @@ int close_connection(int connection) {
 
 int kernel_free_answer(kernel_answer_t* answer) {
     if (answer->answer_body != NULL) free(answer->answer_body);
-    free(answer);
-    return 1;
+    return ARN_release(answer->arena, answer->mark);
 }
 
 void cleanup_kernel() {
     _flush_tables();
     for (int i = 0; i < MAX_CONNECTIONS; i++) {
+        ARN_free(&_arenas[i]);
         if (_connections[i] == NULL) continue;
         DB_free_database(_connections[i]);
     }
+
+    MDL_unload_modules();
 }
@@ -0,0 +1,85 @@
+#include "../include/arena.h"
+
+
+#define HEADER_SIZE ARENA_ALIGN(sizeof(arena_block_t))
+
+
+static arena_block_t* _create_block(size_t size) {
+    size = size > ARENA_BLOCK_SIZE ? size : ARENA_BLOCK_SIZE;
+    arena_block_t* block = (arena_block_t*)malloc(HEADER_SIZE + size);
+    if (!block) return NULL;
+
+    print_mm("New arena block with size [%zu] at [%p]", size, block);
+    block->next = NULL;
+    block->size = size;
+    block->offset = 0;
+    return block;
+}
+
+void* ARN_alloc(arena_t* arena, size_t size) {
+    size = ARENA_ALIGN(size > 0 ? size : 1);
+    arena_block_t* block = arena->current;
+    if (block == NULL || block->offset + size > block->size) {
+        // Blocks after current are free after release, that's why they reused before new block created
+        arena_block_t* next = block == NULL ? arena->head : block->next;
+        if (next == NULL || next->size < size) {
+            arena_block_t* created = _create_block(size);
+            if (!created) return NULL;
+
+            created->next = next;
+            if (block == NULL) arena->head = created;
+            else block->next = created;
+            next = created;
+        }
+
+        next->offset = 0;
+        arena->current = block = next;
+    }
+
+    void* pointer = (unsigned char*)block + HEADER_SIZE + block->offset;
+    block->offset += size;
+    return pointer;
+}
+
+arena_mark_t ARN_mark(arena_t* arena) {
+    arena_mark_t mark = { .block = arena->current, .offset = arena->current == NULL ? 0 : arena->current->offset };
+    return mark;
+}
+
+int ARN_release(arena_t* arena, arena_mark_t mark) {
+    if (mark.block != NULL && (mark.block != arena->head || mark.offset > 0)) {
+        arena->current = mark.block;
+        arena->current->offset = mark.offset;
+        return 1;
+    }
+
+    // Start of arena. Big blocks of previous command don't hold between commands.
+    arena_block_t* block = arena->head;
+    while (block != NULL && block->next != NULL) {
+        arena_block_t* next = block->next;
+        block->next = next->next;
+        free(next);
+    }
+
+    if (block != NULL && block->size > ARENA_BLOCK_SIZE) {
+        free(block);
+        arena->head = block = NULL;
+    }
+
+    if (block != NULL) block->offset = 0;
+    arena->current = NULL;
+    return 1;
+}
+
+int ARN_free(arena_t* arena) {
+    arena_block_t* block = arena->head;
+    while (block != NULL) {
+        arena_block_t* next = block->next;
+        free(block);
+        block = next;
+    }
+
+    arena->head = NULL;
+    arena->current = NULL;
+    return 1;
+}
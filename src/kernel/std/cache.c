@@ -28,6 +28,10 @@ static int GCT_TYPES_MAX[CACHE_TYPES_COUNT] = { 4, 2, 2 };
 
 static int _flush_index(int index) {
     if (GCT[index].pointer == NULL) return -1;
+
+    // Every flushed entry frees slot of its type, otherwise after rollback new entries can't be cached
+    #pragma omp critical (gct_types_decreese)
+    GCT_TYPES[GCT[index].type] = MAX(GCT_TYPES[GCT[index].type] - 1, 0);
     GCT[index].free(GCT[index].pointer);
     GCT[index].pointer = NULL;
 
@@ -63,7 +67,8 @@ int CHC_add_entry(void* entry, char* name, char* base_path, unsigned char type,
     if (GCT_TYPES[type] >= GCT_TYPES_MAX[type]) should_replace = 1;
     for (int i = 0; i < ENTRY_COUNT; i++) {
         if (GCT[i].pointer != NULL) {
-            if (THR_test_lock(&((cache_body_t*)GCT[i].pointer)->lock, omp_get_thread_num()) == UNLOCKED) {
+            // Entry, locked by current thread, still used by this thread, that's why only unlocked entries replaced
+            if (UNPACK_STATUS(((cache_body_t*)GCT[i].pointer)->lock) == UNLOCKED) {
                 if (GCT[i].type == type && should_replace == 1) {
                     occup_current = i;
                     break;
@@ -82,8 +87,6 @@ int CHC_add_entry(void* entry, char* name, char* base_path, unsigned char type,
 
     if (GCT[current].pointer != NULL) {
         if (THR_require_lock(&((cache_body_t*)GCT[current].pointer)->lock, omp_get_thread_num()) != -1) {
-            #pragma omp critical (gct_types_decreese)
-            GCT_TYPES[GCT[current].type] = MAX(GCT_TYPES[GCT[current].type] - 1, 0);
             GCT[current].save(GCT[current].pointer);
             _flush_index(current);
         }
@@ -95,7 +98,7 @@ int CHC_add_entry(void* entry, char* name, char* base_path, unsigned char type,
     ((cache_body_t*)entry)->is_cached = 1;
 
     if (base_path != NULL) {
-        GCT[current].base_path = (char*)malloc(strlen(base_path));
+        GCT[current].base_path = (char*)malloc(strlen(base_path) + 1);
         if (!GCT[current].base_path) return -5;
         strcpy(GCT[current].base_path, base_path);
     }
@@ -115,13 +118,20 @@ void* CHC_find_entry(char* name, char* base_path, unsigned char type) {
     for (int i = 0; i < ENTRY_COUNT; i++) {
         if (GCT[i].pointer == NULL) continue;
         if (strncmp(GCT[i].name, name, ENTRY_NAME_SIZE) == 0 && (GCT[i].type == type || type == ANY_CACHE)) {
-            if (!GCT[i].base_path && !base_path) return GCT[i].pointer;
+            if (!GCT[i].base_path && !base_path) {
+                MTR_add(MTR_CACHE_HITS, 1);
+                return GCT[i].pointer;
+            }
             else {
-                if (strcmp(GCT[i].base_path, base_path) == 0) return GCT[i].pointer;
+                if (strcmp(GCT[i].base_path, base_path) == 0) {
+                    MTR_add(MTR_CACHE_HITS, 1);
+                    return GCT[i].pointer;
+                }
             }
         }
     }
 
+    MTR_add(MTR_CACHE_MISSES, 1);
     return NULL;
 }
 
@@ -0,0 +1,106 @@
+#include "../include/codec.h"
+
+
+#define HASH_SIZE (1 << CDC_HASH_BITS)
+#define HASH(data) ((((data)[0] << 16 | (data)[1] << 8 | (data)[2]) * 2654435761U) >> (32 - CDC_HASH_BITS))
+
+
+static int _flush_literals(
+    const unsigned char* __restrict literals, int count, unsigned char* __restrict destination, int position, int capacity
+) {
+    while (count > 0) {
+        int run = count > CDC_MAX_LITERAL ? CDC_MAX_LITERAL : count;
+        if (position + run + 1 > capacity) return -1;
+
+        destination[position++] = (unsigned char)(run - 1);
+        memcpy(destination + position, literals, run);
+        position += run;
+        literals += run;
+        count -= run;
+    }
+
+    return position;
+}
+
+int CDC_compress(const unsigned char* __restrict source, int source_size, unsigned char* __restrict destination, int capacity) {
+    int table[HASH_SIZE];
+    for (int i = 0; i < HASH_SIZE; i++) table[i] = -1;
+
+    int position = 0;
+    int literal_start = 0;
+    int index = 0;
+    while (index < source_size) {
+        int length = 0;
+        int distance = 0;
+
+        // Run of one byte checked first. This is most common case for padding.
+        if (index > 0) {
+            while (index + length < source_size && length < CDC_MAX_MATCH && source[index + length] == source[index - 1]) length++;
+            distance = 1;
+        }
+
+        if (length < CDC_MAX_MATCH && index + CDC_MIN_MATCH <= source_size) {
+            unsigned int hash = HASH(source + index);
+            int candidate = table[hash];
+            table[hash] = index;
+
+            if (candidate >= 0 && index - candidate <= CDC_MAX_DISTANCE) {
+                int candidate_length = 0;
+                while (
+                    index + candidate_length < source_size && candidate_length < CDC_MAX_MATCH &&
+                    source[candidate + candidate_length] == source[index + candidate_length]
+                ) candidate_length++;
+
+                if (candidate_length > length) {
+                    length = candidate_length;
+                    distance = index - candidate;
+                }
+            }
+        }
+
+        if (length < CDC_MIN_MATCH) {
+            index++;
+            continue;
+        }
+
+        position = _flush_literals(source + literal_start, index - literal_start, destination, position, capacity);
+        if (position < 0 || position + 3 > capacity) return -1;
+
+        destination[position++] = 0x80 | (unsigned char)(length - CDC_MIN_MATCH);
+        destination[position++] = (unsigned char)((distance - 1) & 0xFF);
+        destination[position++] = (unsigned char)(((distance - 1) >> 8) & 0xFF);
+
+        index += length;
+        literal_start = index;
+    }
+
+    return _flush_literals(source + literal_start, index - literal_start, destination, position, capacity);
+}
+
+int CDC_decompress(const unsigned char* __restrict source, int source_size, unsigned char* __restrict destination, int capacity) {
+    int position = 0;
+    int index = 0;
+    while (index < source_size) {
+        unsigned char token = source[index++];
+        if (!(token & 0x80)) {
+            int run = token + 1;
+            if (index + run > source_size || position + run > capacity) return -1;
+            memcpy(destination + position, source + index, run);
+            position += run;
+            index += run;
+            continue;
+        }
+
+        if (index + 2 > source_size) return -1;
+        int length = (token & 0x7F) + CDC_MIN_MATCH;
+        int distance = (source[index] | source[index + 1] << 8) + 1;
+        index += 2;
+
+        if (distance > position || position + length > capacity) return -1;
+
+        // Regions can overlap (runs), that's why copy byte by byte
+        for (int i = 0; i < length; i++, position++) destination[position] = destination[position - distance];
+    }
+
+    return position;
+}
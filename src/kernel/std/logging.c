@@ -1,49 +1,251 @@
 #include "../include/logging.h"
 
 
+#if !defined(NO_THREADS) && !defined(_WIN32)
+    #define LOG_ASYNC
+    static pthread_mutex_t _writer_lock = PTHREAD_MUTEX_INITIALIZER;
+    static pthread_cond_t _writer_ready = PTHREAD_COND_INITIALIZER;
+    static int _is_writer_waiting = 0;
+#endif
+
+#define RING_MASK (LOG_RING_SIZE - 1)
+#define GET_SEQUENCE(record, index)         (__atomic_load_n(&(record)->sequence, __ATOMIC_SEQ_CST) + (index))
+#define SET_SEQUENCE(record, index, value)  __atomic_store_n(&(record)->sequence, (value) - (index), __ATOMIC_SEQ_CST)
+
+#define WRITER_NOT_STARTED  0
+#define WRITER_THREAD       1
+#define WRITER_INLINE       2
+
+
 #ifdef LOG_TO_FILE
     static int _log_size = 0;
     static FILE* _log_file = NULL;
     static char* _log_file_name = NULL;
 #endif
 
+static log_record_t _ring[LOG_RING_SIZE];
+static size_t _enqueue_position = 0;
+// Dequeue position changed only by thread, that holds _is_draining
+static size_t _dequeue_position = 0;
+static int _is_draining = 0;
+static unsigned int _dropped = 0;
+static int _writer_state = WRITER_NOT_STARTED;
 
-void _write_log(const char* level, const char* file, int line, const char* message, va_list args) {
-    #pragma omp critical
-    {
-        FILE* log_output = stdout;
-        #ifdef LOG_TO_FILE
-            if (_log_file_name == NULL) _log_file_name = generate_unique_filename(LOG_FILE_PATH, LOG_FILE_NAME_SIZE, LOG_FILE_EXTENSION);
-            if (_log_file_name != NULL && _log_file == NULL) {
-                char log_path[DEFAULT_BUFFER_SIZE] = { 0 };
-                get_load_path(_log_file_name, LOG_FILE_NAME_SIZE, log_path, LOG_FILE_PATH, LOG_FILE_EXTENSION);
-
-                _log_file = fopen(log_path, "a");
+
+static FILE* _get_output() {
+    FILE* log_output = stdout;
+    #ifdef LOG_TO_FILE
+        if (_log_file_name == NULL) _log_file_name = generate_unique_filename(LOG_FILE_PATH, LOG_FILE_NAME_SIZE, LOG_FILE_EXTENSION);
+        if (_log_file_name != NULL && _log_file == NULL) {
+            char log_path[DEFAULT_BUFFER_SIZE] = { 0 };
+            get_load_path(_log_file_name, LOG_FILE_NAME_SIZE, log_path, LOG_FILE_PATH, LOG_FILE_EXTENSION);
+
+            _log_file = fopen(log_path, "a");
+        }
+
+        if (_log_file) log_output = _log_file;
+    #endif
+
+    return log_output;
+}
+
+// Records, that can be written to output before rotation
+static int _get_room(FILE* log_output) {
+    #ifdef LOG_TO_FILE
+        if (log_output != stdout) return LOG_FILE_SIZE - _log_size;
+    #endif
+
+    return INT_MAX;
+}
+
+static void _count_written(FILE* log_output, int count) {
+    #ifdef LOG_TO_FILE
+        if (log_output != stdout) {
+            _log_size += count;
+            if (_log_size >= LOG_FILE_SIZE) {
+                fclose(_log_file);
+                SOFT_FREE(_log_file_name);
+
+                _log_file = NULL;
+                _log_size = 0;
             }
+        }
+    #endif
+}
 
-            if (_log_file) log_output = _log_file;
-        #endif
-
-        if (level == NULL) level = "(null)";
-        if (file == NULL) file = "(null)";
-        if (message == NULL) message = "(null)";
-
-        fprintf(log_output, "[%s] [%s] (%s:%i) ", level, get_current_time(), file, line);
-        vfprintf(log_output, message, args);
-        fprintf(log_output, "\n");
-
-        #ifdef LOG_TO_FILE
-            if (log_output != stdout) {
-                if (_log_size++ >= LOG_FILE_SIZE) {
-                    fclose(_log_file);
-                    SOFT_FREE(_log_file_name);
-                    
-                    _log_file = NULL;
-                    _log_size = 0;
-                }
+/*
+Time string formatted once per second. Called only by drainer.
+*/
+static const char* _get_time(time_t seconds) {
+    static time_t cached_seconds = -1;
+    static char cached_time[32] = { 0 };
+    if (seconds != cached_seconds) {
+        format_time(seconds, cached_time, sizeof(cached_time));
+        cached_seconds = seconds;
+    }
+
+    return cached_time;
+}
+
+static int _has_records() {
+    size_t position = __atomic_load_n(&_dequeue_position, __ATOMIC_SEQ_CST);
+    return GET_SEQUENCE(&_ring[position & RING_MASK], position & RING_MASK) == position + 1;
+}
+
+/*
+Write all ready records of ring. Only one thread drains ring at time.
+Return count of written records, or -1 if ring drained by other thread.
+*/
+static int _drain() {
+    int count = 0;
+    do {
+        if (__atomic_exchange_n(&_is_draining, 1, __ATOMIC_SEQ_CST)) return count > 0 ? count : -1;
+
+        int written = 0;
+        char batch[LOG_BATCH_SIZE];
+        size_t batch_size = 0;
+        FILE* log_output = _get_output();
+        int room = _get_room(log_output);
+
+        unsigned int dropped = __atomic_exchange_n(&_dropped, 0, __ATOMIC_RELAXED);
+        if (dropped > 0) {
+            batch_size += snprintf(
+                batch, sizeof(batch), "[WARN] [%s] (%s:%i) Log ring overflow, [%u] records dropped\n", 
+                _get_time(time(NULL)), __FILE__, __LINE__, dropped
+            );
+        }
+
+        // Pass ends on full file, so next pass continues in rotated file
+        while (written < room) {
+            size_t index = _dequeue_position & RING_MASK;
+            log_record_t* record = &_ring[index];
+            if (GET_SEQUENCE(record, index) != _dequeue_position + 1) break;
+
+            char line[LOG_MESSAGE_SIZE + 128];
+            int line_size = snprintf(
+                line, sizeof(line), "[%s] [%s] (%s:%i) %s\n", record->level, _get_time(record->time), record->file, record->line, record->message
+            );
+
+            // Slot released before write, so producers can reuse it
+            SET_SEQUENCE(record, index, _dequeue_position + LOG_RING_SIZE);
+            __atomic_store_n(&_dequeue_position, _dequeue_position + 1, __ATOMIC_SEQ_CST);
+
+            line_size = MIN(line_size, (int)sizeof(line) - 1);
+            if (batch_size + line_size > sizeof(batch)) {
+                fwrite(batch, 1, batch_size, log_output);
+                batch_size = 0;
             }
-        #endif
+
+            memcpy(batch + batch_size, line, line_size);
+            batch_size += line_size;
+            written++;
+        }
+
+        if (batch_size > 0) {
+            fwrite(batch, 1, batch_size, log_output);
+            fflush(log_output);
+            _count_written(log_output, written);
+        }
+
+        count += written;
+
+        __atomic_store_n(&_is_draining, 0, __ATOMIC_SEQ_CST);
+
+    // Producer, that failed to drain while ring was drained here, leaves his record to this thread
+    } while (_has_records());
+
+    return count;
+}
+
+#ifdef LOG_ASYNC
+    static void* _writer(void* args) {
+        while (1) {
+            if (_drain() > 0) continue;
+
+            // Waiting flag set before ring check, so producer, that published record after check, will see flag and wake writer
+            pthread_mutex_lock(&_writer_lock);
+            __atomic_store_n(&_is_writer_waiting, 1, __ATOMIC_SEQ_CST);
+            while (!_has_records()) pthread_cond_wait(&_writer_ready, &_writer_lock);
+            __atomic_store_n(&_is_writer_waiting, 0, __ATOMIC_SEQ_CST);
+            pthread_mutex_unlock(&_writer_lock);
+        }
+
+        return NULL;
+    }
+
+    static void _wake_writer() {
+        if (!__atomic_load_n(&_is_writer_waiting, __ATOMIC_SEQ_CST)) return;
+        pthread_mutex_lock(&_writer_lock);
+        pthread_cond_signal(&_writer_ready);
+        pthread_mutex_unlock(&_writer_lock);
+    }
+#endif
+
+static int _start_writer() {
+    int state = __atomic_load_n(&_writer_state, __ATOMIC_ACQUIRE);
+    if (state != WRITER_NOT_STARTED) return state;
+
+    int expected = WRITER_NOT_STARTED;
+    if (!__atomic_compare_exchange_n(&_writer_state, &expected, WRITER_INLINE, 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) return expected;
+
+    atexit(log_flush);
+    #ifdef LOG_ASYNC
+        if (THR_create_thread(_writer, NULL) == 1) {
+            __atomic_store_n(&_writer_state, WRITER_THREAD, __ATOMIC_RELEASE);
+            return WRITER_THREAD;
+        }
+    #endif
+
+    return WRITER_INLINE;
+}
+
+
+void _write_log(const char* level, const char* file, int line, const char* message, va_list args) {
+    if (level == NULL) level = "(null)";
+    if (file == NULL) file = "(null)";
+    if (message == NULL) message = "(null)";
+
+    int writer_state = _start_writer();
+    log_record_t* record = NULL;
+    size_t position = __atomic_load_n(&_enqueue_position, __ATOMIC_RELAXED);
+    while (1) {
+        size_t index = position & RING_MASK;
+        record = &_ring[index];
+        size_t sequence = GET_SEQUENCE(record, index);
+        if (sequence == position) {
+            if (__atomic_compare_exchange_n(&_enqueue_position, &position, position + 1, 1, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) break;
+        }
+        else if ((long long)(sequence - position) < 0) {
+            // Slot not released by drainer, that's why ring is full
+            #ifdef LOG_BLOCK_ON_OVERFLOW
+                if (_drain() < 0) {
+                    #ifndef _WIN32
+                        sched_yield();
+                    #endif
+                }
+
+                position = __atomic_load_n(&_enqueue_position, __ATOMIC_RELAXED);
+            #else
+                __atomic_fetch_add(&_dropped, 1, __ATOMIC_RELAXED);
+                return;
+            #endif
+        }
+        else {
+            position = __atomic_load_n(&_enqueue_position, __ATOMIC_RELAXED);
+        }
     }
+
+    record->level = level;
+    record->file = file;
+    record->line = line;
+    record->time = time(NULL);
+    vsnprintf(record->message, LOG_MESSAGE_SIZE, message, args);
+    SET_SEQUENCE(record, position & RING_MASK, position + 1);
+
+    if (writer_state != WRITER_THREAD) _drain();
+    #ifdef LOG_ASYNC
+        else _wake_writer();
+    #endif
 }
 
 void log_message(const char* level, const char* file, int line, const char* message, ...) {
@@ -51,4 +253,15 @@ void log_message(const char* level, const char* file, int line, const char* mess
     va_start(args, message);
     _write_log(level, file, line, message, args);
     va_end(args);
-}
\ No newline at end of file
+}
+
+void log_flush() {
+    // Writer thread can hold ring, that's why drain repeated until ring is empty
+    for (int i = 0; i < LOG_RING_SIZE * 16 && _has_records(); i++) {
+        if (_drain() < 0) {
+            #ifndef _WIN32
+                sched_yield();
+            #endif
+        }
+    }
+}
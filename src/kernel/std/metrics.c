@@ -0,0 +1,169 @@
+#include "../include/metrics.h"
+
+
+#define ATOMIC_ADD(target, value)   __atomic_fetch_add(&(target), (value), __ATOMIC_RELAXED)
+#define ATOMIC_GET(target)          __atomic_load_n(&(target), __ATOMIC_RELAXED)
+
+
+static unsigned long long _counters[MTR_COUNTERS] = { 0 };
+static metric_command_t _commands[MTR_MAX_COMMANDS] = { { 0 } };
+
+static const char* _counter_names[MTR_COUNTERS] = {
+    "cache_hits", "cache_misses", "page_loads", "page_saves", "fsyncs", "lock_acquires", "lock_waits", "lock_timeouts"
+};
+
+
+static metric_command_t* _get_command(const char* name) {
+    for (int i = 0; i < MTR_MAX_COMMANDS; i++) {
+        const char* slot = __atomic_load_n(&_commands[i].name, __ATOMIC_ACQUIRE);
+        if (slot == NULL) {
+            // Free slot taken by first thread. Other thread gets name of winner in slot.
+            if (__atomic_compare_exchange_n(&_commands[i].name, &slot, name, 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+                return &_commands[i];
+            }
+        }
+
+        if (slot == name || strcmp(slot, name) == 0) return &_commands[i];
+    }
+
+    return NULL;
+}
+
+static int _get_bucket(unsigned long long value) {
+    if (value < (1ULL << MTR_SUB_BITS)) return (int)value;
+
+    int magnitude = 63 - __builtin_clzll(value);
+    if (magnitude > MTR_MAX_MAGNITUDE) return MTR_BUCKETS - 1;
+
+    int shift = magnitude - MTR_SUB_BITS;
+    return ((magnitude - MTR_SUB_BITS + 1) << MTR_SUB_BITS) + (int)((value >> shift) - (1ULL << MTR_SUB_BITS));
+}
+
+static unsigned long long _get_bucket_bound(int bucket) {
+    if (bucket < (1 << MTR_SUB_BITS)) return (unsigned long long)bucket;
+
+    int shift = (bucket >> MTR_SUB_BITS) - 1;
+    unsigned long long lower = ((1ULL << MTR_SUB_BITS) + (bucket & ((1 << MTR_SUB_BITS) - 1))) << shift;
+    return lower + (1ULL << shift) - 1;
+}
+
+static void _append(char* buffer, size_t buffer_size, size_t* position, const char* format, ...) {
+    if (*position >= buffer_size) return;
+
+    va_list args;
+    va_start(args, format);
+    int size = vsnprintf(buffer + *position, buffer_size - *position, format, args);
+    va_end(args);
+
+    if (size > 0) *position += (size_t)size;
+    if (*position >= buffer_size) *position = buffer_size - 1;
+}
+
+
+int MTR_add(int counter, unsigned long long value) {
+    ATOMIC_ADD(_counters[counter], value);
+    return 1;
+}
+
+int MTR_command(const char* name, unsigned long long time, int is_error) {
+    metric_command_t* command = _get_command(name);
+    if (!command) return -1;
+
+    ATOMIC_ADD(command->count, 1);
+    ATOMIC_ADD(command->sum, time);
+    ATOMIC_ADD(command->buckets[_get_bucket(time)], 1);
+    if (is_error) ATOMIC_ADD(command->errors, 1);
+
+    unsigned long long max = ATOMIC_GET(command->max);
+    while (time > max && !__atomic_compare_exchange_n(&command->max, &max, time, 1, __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+    return 1;
+}
+
+unsigned long long MTR_get_percentile(metric_command_t* command, double percentile) {
+    unsigned long long total = 0;
+    for (int i = 0; i < MTR_BUCKETS; i++) total += ATOMIC_GET(command->buckets[i]);
+    if (total == 0) return 0;
+
+    unsigned long long target = (unsigned long long)(percentile * total + 0.5);
+    if (target == 0) target = 1;
+
+    unsigned long long seen = 0;
+    unsigned long long max = ATOMIC_GET(command->max);
+    for (int i = 0; i < MTR_BUCKETS; i++) {
+        seen += ATOMIC_GET(command->buckets[i]);
+        if (seen < target) continue;
+
+        unsigned long long bound = _get_bucket_bound(i);
+        return bound < max ? bound : max;
+    }
+
+    return max;
+}
+
+int MTR_get_text(char* buffer, size_t buffer_size) {
+    size_t position = 0;
+    _append(buffer, buffer_size, &position, "commands:\n");
+    for (int i = 0; i < MTR_MAX_COMMANDS; i++) {
+        metric_command_t* command = &_commands[i];
+        const char* name = __atomic_load_n(&command->name, __ATOMIC_ACQUIRE);
+        if (name == NULL) break;
+
+        unsigned long long count = ATOMIC_GET(command->count);
+        _append(
+            buffer, buffer_size, &position, "   %s: count=%llu errors=%llu mean=%lluus p50=%lluus p90=%lluus p99=%lluus p999=%lluus max=%lluus\n",
+            name, count, ATOMIC_GET(command->errors), count == 0 ? 0 : ATOMIC_GET(command->sum) / count,
+            MTR_get_percentile(command, 0.5), MTR_get_percentile(command, 0.9), MTR_get_percentile(command, 0.99),
+            MTR_get_percentile(command, 0.999), ATOMIC_GET(command->max)
+        );
+    }
+
+    _append(
+        buffer, buffer_size, &position, "cache: hits=%llu misses=%llu\n",
+        ATOMIC_GET(_counters[MTR_CACHE_HITS]), ATOMIC_GET(_counters[MTR_CACHE_MISSES])
+    );
+
+    _append(
+        buffer, buffer_size, &position, "pages: loads=%llu saves=%llu fsyncs=%llu\n",
+        ATOMIC_GET(_counters[MTR_PAGE_LOADS]), ATOMIC_GET(_counters[MTR_PAGE_SAVES]), ATOMIC_GET(_counters[MTR_FSYNCS])
+    );
+
+    _append(
+        buffer, buffer_size, &position, "locks: acquires=%llu waits=%llu timeouts=%llu\n",
+        ATOMIC_GET(_counters[MTR_LOCK_ACQUIRES]), ATOMIC_GET(_counters[MTR_LOCK_WAITS]), ATOMIC_GET(_counters[MTR_LOCK_TIMEOUTS])
+    );
+
+    return (int)position;
+}
+
+int MTR_get_prometheus(char* buffer, size_t buffer_size) {
+    size_t position = 0;
+    for (int i = 0; i < MTR_COUNTERS; i++) {
+        _append(buffer, buffer_size, &position, "# TYPE cdbms_%s_total counter\n", _counter_names[i]);
+        _append(buffer, buffer_size, &position, "cdbms_%s_total %llu\n", _counter_names[i], ATOMIC_GET(_counters[i]));
+    }
+
+    _append(buffer, buffer_size, &position, "# TYPE cdbms_command_errors_total counter\n");
+    for (int i = 0; i < MTR_MAX_COMMANDS && __atomic_load_n(&_commands[i].name, __ATOMIC_ACQUIRE) != NULL; i++) {
+        _append(
+            buffer, buffer_size, &position, "cdbms_command_errors_total{command=\"%s\"} %llu\n", _commands[i].name, ATOMIC_GET(_commands[i].errors)
+        );
+    }
+
+    // Percentiles already calculated from histogram, that's why latency exported as summary
+    double quantiles[] = { 0.5, 0.9, 0.99, 0.999 };
+    _append(buffer, buffer_size, &position, "# TYPE cdbms_command_latency_microseconds summary\n");
+    for (int i = 0; i < MTR_MAX_COMMANDS && __atomic_load_n(&_commands[i].name, __ATOMIC_ACQUIRE) != NULL; i++) {
+        metric_command_t* command = &_commands[i];
+        for (int j = 0; j < (int)(sizeof(quantiles) / sizeof(quantiles[0])); j++) {
+            _append(
+                buffer, buffer_size, &position, "cdbms_command_latency_microseconds{command=\"%s\",quantile=\"%g\"} %llu\n",
+                command->name, quantiles[j], MTR_get_percentile(command, quantiles[j])
+            );
+        }
+
+        _append(buffer, buffer_size, &position, "cdbms_command_latency_microseconds_sum{command=\"%s\"} %llu\n", command->name, ATOMIC_GET(command->sum));
+        _append(buffer, buffer_size, &position, "cdbms_command_latency_microseconds_count{command=\"%s\"} %llu\n", command->name, ATOMIC_GET(command->count));
+    }
+
+    return (int)position;
+}
@@ -0,0 +1,55 @@
+#include "../include/qstats.h"
+
+
+static __thread query_stats_t _stats;
+
+
+query_stats_t* QST_get() {
+    return &_stats;
+}
+
+void QST_reset() {
+    memset(&_stats, 0, sizeof(query_stats_t));
+}
+
+void QST_merge(query_stats_t* __restrict destination, query_stats_t* __restrict start) {
+    if (destination == &_stats) return;
+    #pragma omp critical (query_stats)
+    {
+        destination->table_loads     += _stats.table_loads - start->table_loads;
+        destination->table_hits      += _stats.table_hits - start->table_hits;
+        destination->directory_loads += _stats.directory_loads - start->directory_loads;
+        destination->directory_hits  += _stats.directory_hits - start->directory_hits;
+        destination->page_loads      += _stats.page_loads - start->page_loads;
+        destination->page_hits       += _stats.page_hits - start->page_hits;
+        destination->pages_skipped   += _stats.pages_skipped - start->pages_skipped;
+        destination->module_calls    += _stats.module_calls - start->module_calls;
+        destination->module_hits     += _stats.module_hits - start->module_hits;
+        destination->module_inline   += _stats.module_inline - start->module_inline;
+        destination->load_time       += _stats.load_time - start->load_time;
+        for (int i = 0; i < QST_OPERATORS; i++) {
+            destination->operators[i].calls    += _stats.operators[i].calls - start->operators[i].calls;
+            destination->operators[i].rows_in  += _stats.operators[i].rows_in - start->operators[i].rows_in;
+            destination->operators[i].rows_out += _stats.operators[i].rows_out - start->operators[i].rows_out;
+            destination->operators[i].time     += _stats.operators[i].time - start->operators[i].time;
+        }
+    }
+}
+
+unsigned long long QST_time() {
+#ifdef _WIN32
+    return (unsigned long long)GetTickCount64() * 1000;
+#else
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return (unsigned long long)time.tv_sec * 1000000 + time.tv_nsec / 1000;
+#endif
+}
+
+void QST_end(int op, unsigned long long start, unsigned long long rows_in, unsigned long long rows_out) {
+    operator_stats_t* stats = &_stats.operators[op];
+    stats->calls++;
+    stats->rows_in  += rows_in;
+    stats->rows_out += rows_out;
+    stats->time     += QST_time() - start;
+}
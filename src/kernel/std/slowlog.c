@@ -0,0 +1,145 @@
+#include "../include/slowlog.h"
+
+
+#if !defined(NO_THREADS) && !defined(_WIN32)
+    #define SLW_ASYNC
+    static pthread_mutex_t _queue_lock = PTHREAD_MUTEX_INITIALIZER;
+    static pthread_cond_t _queue_ready = PTHREAD_COND_INITIALIZER;
+
+    static char _queue[SLW_QUEUE_SIZE][SLW_RECORD_SIZE];
+    static int _queue_head = 0;
+    static int _queue_count = 0;
+    static unsigned int _dropped = 0;
+#endif
+
+static long long _threshold = -1;
+static FILE* _file = NULL;
+static size_t _file_size = 0;
+
+
+static void _rotate() {
+    if (_file) fclose(_file);
+
+    char source[DEFAULT_PATH_SIZE] = { 0 };
+    char destination[DEFAULT_PATH_SIZE] = { 0 };
+    for (int i = SLW_FILES - 1; i > 0; i--) {
+        if (i == 1) snprintf(source, sizeof(source), "%s", SLW_PATH);
+        else snprintf(source, sizeof(source), "%s.%i", SLW_PATH, i - 1);
+        snprintf(destination, sizeof(destination), "%s.%i", SLW_PATH, i);
+        rename(source, destination);
+    }
+
+    _file = fopen(SLW_PATH, "w");
+    _file_size = 0;
+}
+
+static void _write_records(char records[][SLW_RECORD_SIZE], int count, unsigned int dropped) {
+    if (!_file) return;
+    if (dropped > 0) {
+        char time_buffer[32] = { 0 };
+        _file_size += fprintf(_file, "[%s] dropped=%u\n", format_time(time(NULL), time_buffer, sizeof(time_buffer)), dropped);
+    }
+
+    for (int i = 0; i < count; i++) {
+        _file_size += fprintf(_file, "%s\n", records[i]);
+        if (_file_size >= SLW_FILE_SIZE) _rotate();
+        if (!_file) return;
+    }
+
+    fflush(_file);
+}
+
+#ifdef SLW_ASYNC
+    static void* _writer(void* args) {
+        static char records[SLW_QUEUE_SIZE][SLW_RECORD_SIZE];
+        while (1) {
+            pthread_mutex_lock(&_queue_lock);
+            while (_queue_count == 0 && _dropped == 0) pthread_cond_wait(&_queue_ready, &_queue_lock);
+
+            // Queue copied out, so sessions don't wait for disk
+            int count = _queue_count;
+            for (int i = 0; i < count; i++) memcpy(records[i], _queue[(_queue_head + i) % SLW_QUEUE_SIZE], SLW_RECORD_SIZE);
+            unsigned int dropped = _dropped;
+            _queue_head = (_queue_head + count) % SLW_QUEUE_SIZE;
+            _queue_count = 0;
+            _dropped = 0;
+            pthread_mutex_unlock(&_queue_lock);
+
+            _write_records(records, count, dropped);
+        }
+
+        return NULL;
+    }
+#endif
+
+
+int SLW_init() {
+    _threshold = atoll(SLW_THRESHOLD);
+    if (_threshold < 0) return 0;
+
+    _file = fopen(SLW_PATH, "a");
+    if (!_file) {
+        print_error("Slow query log [%s] can't be opened", SLW_PATH);
+        _threshold = -1;
+        return 0;
+    }
+
+    fseek(_file, 0, SEEK_END);
+    _file_size = (size_t)MAX(ftell(_file), 0);
+
+#ifdef SLW_ASYNC
+    THR_create_thread(_writer, NULL);
+#endif
+
+    print_info("Slow query log [%s] with threshold [%lli]us", SLW_PATH, _threshold);
+    return 1;
+}
+
+int SLW_begin(slow_query_t* query, int session, unsigned char* command, size_t command_size) {
+    if (_threshold < 0) return 0;
+
+    QST_reset();
+    query->session = session;
+    query->start = QST_time();
+
+    // Command can have null-terminator inside (text protocol), that's why copy stops on it
+    command_size = MIN(command_size, SLW_COMMAND_SIZE);
+    memcpy(query->command, command, command_size);
+    query->command[command_size] = '\0';
+    return 1;
+}
+
+int SLW_end(slow_query_t* query, size_t bytes_sent) {
+    if (_threshold < 0) return 0;
+
+    unsigned long long duration = QST_time() - query->start;
+    if (duration < (unsigned long long)_threshold) return 0;
+
+    // Time formatted to own buffer, because SLW_end invoked from many sessions
+    query_stats_t* stats = QST_get();
+    char time_buffer[32] = { 0 };
+    char record[SLW_RECORD_SIZE];
+    snprintf(
+        record, sizeof(record),
+        "[%s] session=%i time=%lluus rows_scanned=%llu rows_returned=%llu pages_disk=%u pages_cache=%u bytes_sent=%zu command=[%s]",
+        format_time(time(NULL), time_buffer, sizeof(time_buffer)), query->session, duration, stats->operators[QST_SCAN].rows_out, stats->rows_returned,
+        stats->page_loads, stats->page_hits, bytes_sent, query->command
+    );
+
+    int result = 1;
+#ifdef SLW_ASYNC
+    pthread_mutex_lock(&_queue_lock);
+    if (_queue_count >= SLW_QUEUE_SIZE) {
+        _dropped++;
+        result = -1;
+    }
+    else memcpy(_queue[(_queue_head + _queue_count++) % SLW_QUEUE_SIZE], record, SLW_RECORD_SIZE);
+
+    pthread_cond_signal(&_queue_ready);
+    pthread_mutex_unlock(&_queue_lock);
+#else
+    _write_records(&record, 1, 0);
+#endif
+
+    return result;
+}
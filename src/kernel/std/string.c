@@ -26,6 +26,18 @@ int is_integer(const char* str) {
     return 1;
 }
 
+long long strntoll(const char* str, size_t size) {
+    size_t index = 0;
+    while (index < size && isspace((unsigned char)str[index])) index++;
+
+    int is_negative = 0;
+    if (index < size && (str[index] == '-' || str[index] == '+')) is_negative = str[index++] == '-';
+
+    unsigned long long value = 0;
+    for (; index < size && isdigit((unsigned char)str[index]); index++) value = value * 10 + (str[index] - '0');
+    return is_negative ? -(long long)value : (long long)value;
+}
+
 char* strrep(char* __restrict string, char* __restrict source, char* __restrict target) {
     char* result = NULL; // the return string
     char* ins = NULL;    // the next insert point
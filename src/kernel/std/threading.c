@@ -45,8 +45,13 @@ int THR_require_lock(unsigned short* lock, unsigned char owner) {
     if (lock == NULL) return -2;
     int delay = DEFAULT_DELAY;
     while (THR_test_lock(lock, owner) == LOCKED)
-        if (--delay <= 0) return -1;
+        if (--delay <= 0) {
+            MTR_add(MTR_LOCK_TIMEOUTS, 1);
+            return -1;
+        }
 
+    if (delay != DEFAULT_DELAY) MTR_add(MTR_LOCK_WAITS, 1);
+    MTR_add(MTR_LOCK_ACQUIRES, 1);
     *lock = PACK_LOCK(LOCKED, owner);
     return 1;
 }
@@ -14,3 +14,15 @@ char* get_current_time() {
 
     return time_str;
 }
+
+char* format_time(time_t seconds, char* buffer, size_t buffer_size) {
+    struct tm tm_info;
+#ifdef _WIN32
+    localtime_s(&tm_info, &seconds);
+#else
+    localtime_r(&seconds, &tm_info);
+#endif
+
+    strftime(buffer, buffer_size, "%Y-%m-%d %H:%M:%S", &tm_info);
+    return buffer;
+}
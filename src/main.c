@@ -25,6 +25,7 @@
 #include "kernel/include/logging.h"
 #include "kernel/include/cache.h"
 #include "kernel/include/threading.h"
+#include "kernel/include/slowlog.h"
 
 #include <stdio.h>
 #include <stdlib.h>
@@ -35,19 +36,52 @@
 #else
     #include <unistd.h>
     #include <sys/socket.h>
+    #include <sys/select.h>
     #include <netinet/in.h>
     #include <arpa/inet.h>
 #endif
 
 
 #define CDBMS_SERVER_PORT   ENV_GET("CDBMS_SERVER_PORT", "7777")
+// Port of Prometheus metrics listener on 127.0.0.1. 0 - listener disabled.
+#define CDBMS_METRICS_PORT  ENV_GET("CDBMS_METRICS_PORT", "0")
+// Scrapes, that wait for request, and seconds of waiting, after that scrape closed without answer.
+#define METRICS_CLIENTS     4
+#define METRICS_TIMEOUT     1
 #define MESSAGE_BUFFER      2048
 #define COMMANDS_BUFFER     256
 #define MAX_SESSION_COUNT   5
 
+/*
+Framed protocol. Client selects it by first byte of connection (FRAME_MAGIC can't be first byte of text command).
+Every request and response starts with frame_header_t (little-endian), that followed by body_length bytes of body.
+Requests can be pipelined: server answers them in order with request_id of request.
+*/
+#define FRAME_MAGIC         0xCD
+#define FRAME_MAX_BODY      0x100000
+#define FRAME_OP_AUTH       0x01
+#define FRAME_OP_COMMAND    0x02
+
+typedef struct {
+    unsigned char magic;
+    unsigned char opcode;
+    // Answer code of command (or auth result). Request status ignored.
+    signed char status;
+    unsigned char flags;
+    unsigned int request_id;
+    unsigned int body_length;
+} frame_header_t;
+
 
 static int sessions[MAX_SESSION_COUNT] = { 0 };
 
+typedef struct {
+    int socket;
+    time_t accepted;
+} metrics_client_t;
+
+static metrics_client_t metrics_clients[METRICS_CLIENTS];
+
 
 static void _cleanup() {
     #ifdef _WIN32
@@ -70,13 +104,110 @@ static int _send2destination_byte(int destination, int byte) {
     return _send2destination(destination, &byte, 1);
 }
 
-static int _process_quotes(unsigned char* buffer, char* argv[]) {
+/*
+ * Start metrics listener on local port.
+ * Return socket or -1, if listener disabled.
+*/
+static int _start_metrics_listener() {
+    int metrics_port = atoi(CDBMS_METRICS_PORT);
+    if (metrics_port <= 0) return -1;
+
+    int metrics_socket = socket(AF_INET, SOCK_STREAM, 0);
+    if (metrics_socket == -1) return -1;
+
+    // Server closes scrapes first, that's why closed scrapes keep port in TIME_WAIT after restart
+    int reuse = 1;
+    setsockopt(metrics_socket, SOL_SOCKET, SO_REUSEADDR, (const char*)&reuse, sizeof(reuse));
+
+    struct sockaddr_in metrics_address = {
+        .sin_port = htons(metrics_port),
+        .sin_family = AF_INET,
+        .sin_addr.s_addr = htonl(INADDR_LOOPBACK)
+    };
+
+    if (bind(metrics_socket, (struct sockaddr*)&metrics_address, sizeof(metrics_address)) < 0 || listen(metrics_socket, 5) < 0) {
+        print_error("Metrics listener can't be started on port [%i]", metrics_port);
+        close(metrics_socket);
+        return -1;
+    }
+
+    print_info("Metrics listener started on 127.0.0.1:%d", metrics_port);
+    return metrics_socket;
+}
+
+/*
+ * Add metrics listener and scrapes, that wait for request, to select set.
+ * Return biggest socket in set.
+*/
+static int _set_metrics_sockets(int metrics_socket, fd_set* sockets) {
+    int max_socket = metrics_socket;
+    FD_SET(metrics_socket, sockets);
+    for (int i = 0; i < METRICS_CLIENTS; i++) {
+        if (metrics_clients[i].socket < 0) continue;
+        FD_SET(metrics_clients[i].socket, sockets);
+        max_socket = MAX(max_socket, metrics_clients[i].socket);
+    }
+
+    return max_socket;
+}
+
+/*
+ * Answer one metrics scrape with Prometheus text. Any request answered with metrics.
+ * Request should be readed before close, otherwise client gets reset instead of answer.
+*/
+static void _answer_metrics(int client_socket_fd) {
+    char request[COMMANDS_BUFFER];
+    recv(client_socket_fd, request, sizeof(request), 0);
+
+    char body[MTR_TEXT_SIZE];
+    int body_size = MTR_get_prometheus(body, sizeof(body));
+    char header[COMMANDS_BUFFER];
+    int header_size = snprintf(
+        header, sizeof(header), "HTTP/1.0 200 OK\r\nContent-Type: text/plain; version=0.0.4\r\nContent-Length: %i\r\nConnection: close\r\n\r\n", body_size
+    );
+
+    _send2destination(client_socket_fd, header, header_size);
+    _send2destination(client_socket_fd, body, body_size);
+    close(client_socket_fd);
+}
+
+/*
+ * Serve metrics sockets after select. Scrape answered only when his request arrived, so client,
+ * that connected and sent nothing, doesn't stop accept of database sessions.
+*/
+static void _serve_metrics(int metrics_socket, fd_set* sockets) {
+    time_t now = time(NULL);
+    for (int i = 0; i < METRICS_CLIENTS; i++) {
+        if (metrics_clients[i].socket < 0) continue;
+        if (FD_ISSET(metrics_clients[i].socket, sockets)) _answer_metrics(metrics_clients[i].socket);
+        else if (now - metrics_clients[i].accepted > METRICS_TIMEOUT) close(metrics_clients[i].socket);
+        else continue;
+
+        metrics_clients[i].socket = -1;
+    }
+
+    if (!FD_ISSET(metrics_socket, sockets)) return;
+    int client_socket_fd = accept(metrics_socket, NULL, NULL);
+    if (client_socket_fd < 0) return;
+
+    for (int i = 0; i < METRICS_CLIENTS; i++) {
+        if (metrics_clients[i].socket >= 0) continue;
+        metrics_clients[i].socket = client_socket_fd;
+        metrics_clients[i].accepted = now;
+        return;
+    }
+
+    print_warn("Too many metrics scrapes, scrape closed");
+    close(client_socket_fd);
+}
+
+static int _process_quotes(unsigned char* buffer, char* argv[], int max_argc) {
     char* current_arg = NULL;
 
     int argc = 1;
     int in_quotes = 0;
 
-    for (char *p = (char*)buffer; *p != '\0'; p++) {
+    for (char *p = (char*)buffer; *p != '\0' && argc < max_argc; p++) {
         if (*p == '"') {
             in_quotes = !in_quotes;
             if (in_quotes) current_arg = p + 1;
@@ -96,13 +227,213 @@ static int _process_quotes(unsigned char* buffer, char* argv[]) {
         else if (!current_arg) current_arg = p;
     }
 
-    if (current_arg) argv[argc++] = current_arg;
+    if (current_arg && argc < max_argc) argv[argc++] = current_arg;
     return argc;
 }
 
+/*
+ * Authenticate user with first message of session, or execute command.
+ *
+ * Params:
+ * - message - Null-terminated message.
+ * - user - Session user. Will be set after success auth.
+ * - session - Session index.
+ * - auth_result - Result of auth (1 or 0), if message was auth message.
+ *
+ * Return NULL if message was auth message.
+ * Return answer of command.
+*/
+static kernel_answer_t* _process_message(unsigned char* message, user_t** user, int session, int* auth_result) {
+    if (*user == NULL) {
+#ifndef NO_USER
+        char username[USERNAME_SIZE] = { 0 };
+        char password[128] = { 0 };
+        // Widths are USERNAME_SIZE - 1 and sizeof(password) - 1, because message can be command before auth
+        sscanf((char*)message, "%7[^:]:%127s", username, password);
+
+        *user = USR_auth(username, password);
+        if (*user == NULL) {
+            print_error("Wrong password [%s] for user [%s] at session [%i]", password, username, session);
+            *auth_result = 0;
+        }
+        else {
+            print_info("User [%s] auth succes in session [%i]", (*user)->name, session);
+            *auth_result = 1;
+        }
+
+        return NULL;
+#else
+        *user = (user_t*)malloc(sizeof(user_t));
+        if (!*user) {
+            *auth_result = -1;
+            return NULL;
+        }
+
+        (*user)->access = CREATE_ACCESS_BYTE(0, 0, 0);
+#endif
+    }
+
+    // Every token takes at least two bytes (with separator), that's why batch can have more then MAX_COMMANDS tokens
+    int max_argc = MAX(MAX_COMMANDS, (int)strlen((char*)message) / 2 + 2);
+    char** argv = (char**)calloc(max_argc, sizeof(char*));
+    if (!argv) return NULL;
+
+    int argc = _process_quotes(message, argv, max_argc);
+    kernel_answer_t* answer = kernel_process_command(argc, argv, (*user)->access, session);
+    free(argv);
+    return answer;
+}
+
+/*
+ * Append response frame to output buffer.
+*/
+static int _put_frame(
+    unsigned char** output, size_t* output_size, size_t* output_capacity, frame_header_t* header, unsigned char* body
+) {
+    size_t frame_size = sizeof(frame_header_t) + header->body_length;
+    if (*output_size + frame_size > *output_capacity) {
+        size_t capacity = MAX(*output_capacity * 2, *output_size + frame_size);
+        unsigned char* buffer = (unsigned char*)realloc(*output, capacity);
+        if (!buffer) return -1;
+
+        *output = buffer;
+        *output_capacity = capacity;
+    }
+
+    memcpy(*output + *output_size, header, sizeof(frame_header_t));
+    if (header->body_length > 0) memcpy(*output + *output_size + sizeof(frame_header_t), body, header->body_length);
+    *output_size += frame_size;
+    return 1;
+}
+
+/*
+ * Serve framed session. All complete requests from input processed before answers sent,
+ * that's why pipelined requests answered by one write.
+ *
+ * Params:
+ * - source - source FD with frames.
+ * - destination - destination FD for answer frames.
+ * - session - Session index.
+ * - user - Session user.
+ * - buffer - Already readed bytes of session.
+ * - count - Count of readed bytes.
+*/
+static void _start_framed_session(int source, int destination, int session, user_t** user, unsigned char* buffer, int count) {
+    size_t input_capacity = MAX(MESSAGE_BUFFER * 2, count);
+    size_t input_size = count;
+    unsigned char* input = (unsigned char*)malloc(input_capacity);
+    if (!input) return;
+    memcpy(input, buffer, count);
+
+    unsigned char* output = NULL;
+    size_t output_size = 0;
+    size_t output_capacity = 0;
+
+    int is_open = 1;
+    while (is_open) {
+        size_t offset = 0;
+        while (is_open && input_size - offset >= sizeof(frame_header_t)) {
+            frame_header_t request;
+            memcpy(&request, input + offset, sizeof(frame_header_t));
+            if (request.magic != FRAME_MAGIC || request.body_length > FRAME_MAX_BODY) {
+                print_error("Wrong frame in session [%i]", session);
+                is_open = 0;
+                break;
+            }
+
+            size_t frame_size = sizeof(frame_header_t) + request.body_length;
+            if (input_size - offset < frame_size) {
+                // Frame bigger then input buffer will be readed with next reads
+                if (frame_size > input_capacity) {
+                    unsigned char* bigger = (unsigned char*)realloc(input, frame_size);
+                    if (!bigger) is_open = 0;
+                    else {
+                        input = bigger;
+                        input_capacity = frame_size;
+                    }
+                }
+
+                break;
+            }
+
+            // Command parsed in place and should be null-terminated, that's why body copied
+            unsigned char* body = (unsigned char*)malloc(request.body_length + 1);
+            if (!body) {
+                is_open = 0;
+                break;
+            }
+
+            memcpy(body, input + offset + sizeof(frame_header_t), request.body_length);
+            body[request.body_length] = '\0';
+            offset += frame_size;
+            print_log("Session [%i]: request [%u] [%s]", session, request.request_id, body);
+
+            frame_header_t response = { .magic = FRAME_MAGIC, .opcode = request.opcode, .request_id = request.request_id };
+            kernel_answer_t* result = NULL;
+            slow_query_t query;
+#ifndef NO_USER
+            int is_authorized = *user != NULL;
+#else
+            int is_authorized = 1;
+#endif
+
+            int auth_result = 1;
+            if (request.opcode == FRAME_OP_AUTH) {
+                if (!is_authorized) _process_message(body, user, session, &auth_result);
+                response.status = (signed char)auth_result;
+            }
+            else if (request.opcode == FRAME_OP_COMMAND) {
+                // Command before auth answered like wrong auth
+                if (!is_authorized) response.status = 0;
+                else {
+                    SLW_begin(&query, session, body, request.body_length);
+                    result = _process_message(body, user, session, &auth_result);
+                    if (!result) is_open = 0;
+                }
+            }
+            else response.status = -1;
+
+            if (result) {
+                response.status = result->answer_code;
+                if (result->answer_body != NULL) response.body_length = result->answer_size;
+                if (_put_frame(&output, &output_size, &output_capacity, &response, result->answer_body) != 1) is_open = 0;
+                kernel_free_answer(result);
+                SLW_end(&query, sizeof(frame_header_t) + response.body_length);
+            }
+            else if (_put_frame(&output, &output_size, &output_capacity, &response, NULL) != 1) is_open = 0;
+
+            free(body);
+        }
+
+        if (offset > 0) {
+            memmove(input, input + offset, input_size - offset);
+            input_size -= offset;
+        }
+
+        if (output_size > 0) {
+            _send2destination(destination, output, output_size);
+            output_size = 0;
+        }
+
+        if (!is_open) break;
+
+        #ifdef _WIN32
+        int readed = recv(source, (char*)input + input_size, input_capacity - input_size, 0);
+        #else
+        int readed = read(source, input + input_size, input_capacity - input_size);
+        #endif
+        if (readed <= 0) break;
+        input_size += readed;
+    }
+
+    SOFT_FREE(output);
+    free(input);
+}
+
 /*
  * This function takes source data and destination address for kernel answer.
  * In source should be provided correct command for kernel.
+ * Session with FRAME_MAGIC first byte served with framed protocol.
  *
  * Params:
  * - source - source FD with commands.
@@ -113,6 +444,7 @@ static void _start_kernel_session(int source, int destination, int session) {
     unsigned char buffer[MESSAGE_BUFFER] = { 0 };
     user_t* user = NULL;
     int count = 0;
+    int is_first = 1;
 
     #ifdef _WIN32
     while ((count = recv(source, (char*)buffer, MESSAGE_BUFFER, 0)) > 0)
@@ -120,45 +452,36 @@ static void _start_kernel_session(int source, int destination, int session) {
     while ((count = read(source, buffer, MESSAGE_BUFFER)) > 0)
     #endif
     {
+        if (is_first && buffer[0] == FRAME_MAGIC) {
+            _start_framed_session(source, destination, session, &user, buffer, count);
+            break;
+        }
+
+        is_first = 0;
         buffer[count - 1] = '\0';
-        print_info("Session [%i]: [%s]", session, buffer);
+        print_log("Session [%i]: [%s]", session, buffer);
 
-        if (user == NULL) {
-#ifndef NO_USER
-            char username[USERNAME_SIZE] = { 0 };
-            char password[128] = { 0 };
-            sscanf((char*)buffer, "%[^:]:%s", username, password);
-
-            user = USR_auth(username, password);
-            if (user == NULL) {
-                print_error("Wrong password [%s] for user [%s] at session [%i]", password, username, session);
-                _send2destination_byte(destination, 0);
-            }
-            else {
-                print_info("User [%s] auth succes in session [%i]", user->name, session);
-                _send2destination_byte(destination, 1);
-            }
+        slow_query_t query;
+        SLW_begin(&query, session, buffer, count - 1);
 
+        int auth_result = 0;
+        kernel_answer_t* result = _process_message(buffer, &user, session, &auth_result);
+        if (result == NULL) {
+            if (auth_result < 0) break;
+            _send2destination_byte(destination, auth_result);
             continue;
-#else
-            user = (user_t*)malloc(sizeof(user_t));
-            if (!user) break;
-            user->access = CREATE_ACCESS_BYTE(0, 0, 0);
-#endif
         }
 
-        char* argv[MAX_COMMANDS] = { NULL };
-        int argc = _process_quotes(buffer, argv);
-        kernel_answer_t* result = kernel_process_command(argc, argv, user->access, session);
         if (result->answer_body != NULL) {
             _send2destination(destination, result->answer_body, result->answer_size);
-            print_log("Answer body: [%.*s], Size: %i", result->answer_size, result->answer_body, result->answer_size);
+            print_log("Answer body: [%.*s], Size: %u", (int)result->answer_size, result->answer_body, result->answer_size);
         }
         else {
             _send2destination_byte(destination, result->answer_code);
             print_log("Answer code: %i", result->answer_code);
         }
 
+        SLW_end(&query, result->answer_body != NULL ? result->answer_size : 1);
         kernel_free_answer(result);
     }
 
@@ -188,7 +511,7 @@ static void* _handle_client(void* client_socket_fd) {
 kernel_answer_t* entry(char* command) {
 #ifdef NO_SERVER
     char* argv[MAX_COMMANDS] = { NULL };
-    int argc = _process_quotes(buffer, argv);
+    int argc = _process_quotes(buffer, argv, MAX_COMMANDS);
     return kernel_process_command(argc, argv, user->access, session);
 #endif
     return NULL;
@@ -208,6 +531,8 @@ int main() {
     TB_enable();
     CL_enable();
     CHC_init();
+    SLW_init();
+    MDL_init();
 
     #ifdef _WIN32
         WSADATA wsa_data;
@@ -244,8 +569,23 @@ int main() {
     }
 
     print_info("DB server started on %s:%d", inet_ntoa(server_address.sin_addr), ntohs(server_address.sin_port));
+    int metrics_socket = _start_metrics_listener();
+    for (int i = 0; i < METRICS_CLIENTS; i++) metrics_clients[i].socket = -1;
 
     while (1) {
+        // Metrics scrape served in accept loop and don't take session.
+        // Select wakes up every METRICS_TIMEOUT, so silent scrapes closed in time.
+        if (metrics_socket >= 0) {
+            fd_set sockets;
+            FD_ZERO(&sockets);
+            FD_SET(server_socket, &sockets);
+            int max_socket = _set_metrics_sockets(metrics_socket, &sockets);
+            struct timeval timeout = { .tv_sec = METRICS_TIMEOUT, .tv_usec = 0 };
+            if (select(MAX(server_socket, max_socket) + 1, &sockets, NULL, NULL, &timeout) < 0) continue;
+            _serve_metrics(metrics_socket, &sockets);
+            if (!FD_ISSET(server_socket, &sockets)) continue;
+        }
+
         int client_socket_fd   = -1;
         int client_address_len = -1;
 
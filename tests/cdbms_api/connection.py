@@ -1,6 +1,7 @@
 from __future__ import annotations
 
 import socket
+import struct
 
 
 class Connection:
@@ -58,3 +59,83 @@ class Connection:
             pass
         finally:
             self._socket.settimeout(None)
+
+
+class FramedConnection:
+    """
+    Connection with framed protocol. Every request has id, that's why many requests
+    can be sent at once (pipelining) and answers matched by id.
+    """
+    MAGIC = 0xCD
+    OP_AUTH = 0x01
+    OP_COMMAND = 0x02
+    HEADER = struct.Struct('<BBbBII')
+
+    def __init__(self, base_addr: str, port: int, username: str, password: str) -> None:
+        self._socket = socket.socket(socket.AF_INET, socket.SOCK_STREAM)
+        self._addr = base_addr
+        self._port = port
+        self._code = f'{username}:{password}'
+        self._buffer = bytes(0)
+        self._request_id = 0
+
+        self._status: int = 0
+        self._body_data: bytes | None = bytes(0)
+        self._is_opened: bool = False
+
+    def open_connection(self) -> FramedConnection:
+        if self._is_opened:
+            return self
+        else:
+            self._is_opened = True
+
+        self._socket.connect((self._addr, self._port))
+        self._socket.sendall(self._frame(self.OP_AUTH, self._code)[1])
+        self._read_frame()
+        return self
+
+    def send_data(self, data: str) -> FramedConnection:
+        self._status, self._body_data = self.send_pipeline([data])[0]
+        return self
+
+    def send_pipeline(self, commands: list[str]) -> list[tuple[int, bytes]]:
+        frames = [self._frame(self.OP_COMMAND, command) for command in commands]
+        self._socket.sendall(b''.join(frame for _, frame in frames))
+
+        answers = {}
+        while len(answers) < len(frames):
+            request_id, status, body = self._read_frame()
+            answers[request_id] = (status, body)
+
+        return [answers[request_id] for request_id, _ in frames]
+
+    def close_connection(self) -> FramedConnection:
+        self._socket.close()
+        self._is_opened = False
+        return self
+
+    def get_data(self) -> bytes | None:
+        return self._body_data
+
+    def get_status(self) -> int:
+        return self._status
+
+    def _frame(self, opcode: int, data: str) -> tuple[int, bytes]:
+        self._request_id += 1
+        body = data.encode('utf-8')
+        return self._request_id, self.HEADER.pack(self.MAGIC, opcode, 0, 0, self._request_id, len(body)) + body
+
+    def _receive(self, size: int) -> bytes:
+        while len(self._buffer) < size:
+            part = self._socket.recv(65536)
+            if not part:
+                raise ConnectionError("Connection closed by the server")
+
+            self._buffer += part
+
+        data, self._buffer = self._buffer[:size], self._buffer[size:]
+        return data
+
+    def _read_frame(self) -> tuple[int, int, bytes]:
+        _, _, status, _, request_id, body_length = self.HEADER.unpack(self._receive(self.HEADER.size))
+        return request_id, status, self._receive(body_length)
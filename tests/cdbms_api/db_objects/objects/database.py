@@ -10,11 +10,21 @@ class Database(DBobject):
         self.name: str = name
         self._tables: list[Table] = []
 
-    def add_table(self, table_name: str, access: str, **kwargs) -> Table:
+    def add_table(
+        self, table_name: str, access: str, bloom: list[str] | None = None, layout: str | None = None, compress: str | None = None, **kwargs
+    ) -> Table:
         table: Table = Table(table_name=table_name, access=access, connection=self._connection, **kwargs)
-        self._execute_querry(
-            f'{self.name} create table {table_name} {access} columns ( {" ".join([x.body for x in table.get_columns()])} )\0'
-        )
+        querry: str = f'{self.name} create table {table_name} {access} columns ( {" ".join([x.body for x in table.get_columns()])} )'
+        if bloom is not None:
+            querry += f' bloom ( {" ".join(bloom)} )'
+
+        if layout is not None:
+            querry += f' layout {layout}'
+
+        if compress is not None:
+            querry += f' compress {compress}'
+
+        self._execute_querry(f'{querry}\0')
 
         table._database = self.name
         return table
@@ -7,6 +7,10 @@ class ColumnDataType(Enum):
     STR = 'str'
     ANY = 'any'
     FLT = 'dob'
+    I32 = 'i32'
+    I64 = 'i64'
+    F64 = 'f64'
+    DECIMAL = 'decimal'
     NONE = ''
 
     def module(self, body) -> ColumnDataType:
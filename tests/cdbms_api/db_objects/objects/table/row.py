@@ -39,9 +39,9 @@ class Row:
             offset += column.size
 
             value = column_data.decode('utf-8').strip()
-            if column.data_type == ColumnDataType.INT:
+            if column.data_type in [ ColumnDataType.INT, ColumnDataType.I32, ColumnDataType.I64 ]:
                 value = int(column_data.decode('utf-8').strip())
-            elif column.data_type == ColumnDataType.FLT:
+            elif column.data_type in [ ColumnDataType.FLT, ColumnDataType.F64, ColumnDataType.DECIMAL ]:
                 value = float(column_data.decode('utf-8').strip())
 
             setattr(obj, column.name, value)
@@ -63,6 +63,15 @@ class Table(DBobject):
         else:
             return -1
         
+    def append_rows(self, rows: list[dict]) -> int:
+        values: str = " ".join(f'"{self._generate_querry(**row)}"' for row in rows)
+        return_code = self._execute_querry(f'{self._database} append rows {self.name} values ( {values} )\0')
+        if isinstance(return_code, int):
+            # Answer code sent as signed byte
+            return return_code - 256 if return_code > 127 else return_code
+        else:
+            return -1
+
     def get_row_by_index(self, index: int):
         row_body: bytes | int | None = self._execute_querry(querry=f'{self._database} get row {self.name} by_index {index}\0', is_code=False)
         if not isinstance(row_body, bytes):
@@ -101,6 +110,38 @@ class Table(DBobject):
 
         return output
 
+    def iterate_rows_by_expression(self, expression: list[Statement | LogicOperator], offset: int = -1, limit: int = -1):
+        stmt = Table._generate_stmt(base=f"{self._database} open cursor {self.name} by_exp", params=expression)
+        if offset != -1:
+            stmt += f" offset {offset}"
+
+        if limit != -1:
+            stmt += f" limit {limit}"
+
+        if self._execute_querry(querry=f"{stmt}\0") != 1:
+            return
+
+        column_sizes: list | None = self._split_row_params()
+        if column_sizes is None:
+            return
+
+        # Every fetch should fit into one connection recv
+        row_size: int = sum(column_sizes)
+        fetch_count: int = max(4096 // row_size, 1)
+        while True:
+            row_body: bytes | int | None = self._execute_querry(
+                querry=f"{self._database} fetch {fetch_count}\0", is_code=False
+            )
+
+            if not isinstance(row_body, bytes) or len(row_body) < row_size:
+                break
+
+            for x in range(len(row_body) // row_size):
+                row: Row = Row(data=row_body[x * row_size:(x + 1) * row_size])
+                yield row.parse_bytes_to_object(self._columns)
+
+        self._execute_querry(f"{self._database} close cursor\0")
+
     def insert_row_by_index(self, index: int, **kwargs) -> bytes | int | None:
         return self._execute_querry(f'{self._database} update row {self.name} "{self._generate_querry(**kwargs)}" by_index {index}\0')
 
@@ -1,10 +1,13 @@
 import os
 import shutil
+import socket
+import subprocess
 import time
 import glob
 import random
+import string
 
-from cdbms_api.connection import Connection
+from cdbms_api.connection import Connection, FramedConnection
 from cdbms_api.db_objects.objects.table.table import Table
 from cdbms_api.db_objects.objects.database import Database
 from cdbms_api.db_objects.objects.manager import DatabaseManager
@@ -12,6 +15,12 @@ from cdbms_api.db_objects.objects.table.column import Column, ColumnDataType, Co
 from cdbms_api.db_objects.objects.table.table import Expressions, LogicOperator, Statement
 
 
+# Directory, where server started and stores its files. Tests place modules here and read slow query log from here.
+BUILDS_PATH: str = "/Users/nikolaj/Documents/Repositories/CordellDBMS.EXMPL/builds"
+# Server should be started with CDBMS_METRICS_PORT=7778 and CDBMS_SLOW_QUERY_US=0
+METRICS_PORT: int = 7778
+
+
 def _global_test() -> None:
     start_test_time: float = time.perf_counter()
 
@@ -232,6 +241,1013 @@ def _global_test() -> None:
     print('\n')
     
 
+def _connect() -> Connection:
+    return Connection(
+        base_addr='0.0.0.0',
+        port=7777,
+        username='root',
+        password='root'
+    )
+
+
+def _create_table(database_name: str, table_name: str, columns: dict, **options) -> tuple[Connection, Database, Table]:
+    """
+    Create database with table in new connection. Options passed to add_table.
+    """
+    connection: Connection = _connect()
+    database: Database = DatabaseManager(connection=connection).create_database(database_name)
+    table: Table = database.add_table(table_name=table_name, access='same', **options, **columns)
+    return connection, database, table
+
+
+def _reload_table(connection: Connection, database: Database, table: Table, columns: dict) -> tuple[Connection, Database, Table]:
+    """
+    Close connection and select table in new one. Closed session frees cache, that's why table will be loaded from disk.
+    """
+    connection.close_connection()
+    connection = _connect()
+    database = DatabaseManager(connection=connection).select_database(database.name)
+    table = database.get_table(table_name=table.name, access='same', **columns)
+    return connection, database, table
+
+
+def _count_rows(table: Table, expression: list[Statement | LogicOperator] | None = None) -> int:
+    if expression is None:
+        expression = [ Statement(column_name="uid", expression=Expressions.MORE_THEN, value=-1) ]
+
+    return sum(1 for _ in table.iterate_rows_by_expression(expression=expression))
+
+
+def _querry(database: Database, querry: str) -> bytes:
+    """
+    Send command to database without API wrapper. Return raw answer (body or one byte of answer code).
+    """
+    answer: bytes | None = database.get_connection().send_data(f'{database.name} {querry}\0').get_data()
+    return answer if answer is not None else bytes(0)
+
+
+def _code(answer: bytes) -> int:
+    # Answer code sent as signed byte
+    return answer[0] - 256 if answer[0] > 127 else answer[0]
+
+
+def _split(answer: bytes, size: int) -> list[bytes]:
+    return [ answer[i:i + size] for i in range(0, len(answer) - len(answer) % size, size) ]
+
+
+def _append_rows_test() -> None:
+    """
+    Append rows should add all rows of batch or nothing, when primary key repeated in batch or in table.
+    """
+    ROWS: int = 50
+    columns: dict = dict(
+        uid=Column('uid', ColumnDataType.INT, [ColumnType.PRIMARY, ColumnType.WHITOUT_AUTO], 8),
+        name=Column('name', ColumnDataType.STR, [ColumnType.NOT_PRIMARY, ColumnType.WHITOUT_AUTO], 16)
+    )
+
+    connection, database, table = _create_table('rowstest', 'rowpigs', columns)
+
+    # region [APPEND]
+
+    print('\n[Test] Append rows test...')
+    return_code: int = table.append_rows([ dict(uid=i, name=f'Row{i}') for i in range(ROWS) ])
+    assert return_code == 1, f"Append rows failed: {return_code}"
+    assert _count_rows(table) == ROWS, "Appended rows count incorrect"
+
+    row = table.get_row_by_index(ROWS - 1)
+    assert row.uid == ROWS - 1 and row.name == f'Row{ROWS - 1}', "Appended data incorrect"
+
+    # endregion
+
+    # region [DUPLICATES]
+
+    print('\n[Test] Append rows with duplicated primary key in batch test...')
+    return_code = table.append_rows([ dict(uid=i, name='Dup') for i in [ ROWS, ROWS + 1, ROWS ] ])
+    assert return_code == -20, f"Duplicate in batch not rejected: {return_code}"
+    assert _count_rows(table) == ROWS, "Rows of rejected batch appended"
+
+    print('\n[Test] Append rows with existed primary key test...')
+    return_code = table.append_rows([ dict(uid=i, name='Dup') for i in [ ROWS, ROWS + 1, 3 ] ])
+    assert return_code == -20, f"Existed primary key not rejected: {return_code}"
+    assert _count_rows(table) == ROWS, "Rows of rejected batch appended"
+
+    rows: list = table.get_row_by_expression(
+        expression=[ Statement(column_name="name", expression=Expressions.STR_EQUALS, value="Dup") ]
+    )
+
+    assert rows is None or len(rows) == 0, "Rows of rejected batch exist"
+
+    return_code = table.append_rows([ dict(uid=i, name=f'Row{i}') for i in range(ROWS, 2 * ROWS) ])
+    assert return_code == 1, f"Append rows after rejected batch failed: {return_code}"
+    database.sync()
+    assert _count_rows(table) == 2 * ROWS, "Appended rows count incorrect"
+
+    # endregion
+
+    # region [LOAD]
+
+    print('\n[Test] Appended rows load from disk test...')
+    connection, database, table = _reload_table(connection, database, table, columns)
+    assert _count_rows(table) == 2 * ROWS, "Appended rows lost after load"
+
+    # endregion
+
+    connection.close_connection()
+    print('\n[Test] Append rows test complete')
+
+
+def _projection_test() -> None:
+    """
+    Projection should return only listed columns in listed order.
+    """
+    ROWS: int = 20
+    columns: dict = dict(
+        uid=Column('uid', ColumnDataType.INT, [ColumnType.NOT_PRIMARY, ColumnType.WHITOUT_AUTO], 8),
+        name=Column('name', ColumnDataType.STR, [ColumnType.NOT_PRIMARY, ColumnType.WHITOUT_AUTO], 16),
+        weight=Column('weight', ColumnDataType.INT, [ColumnType.NOT_PRIMARY, ColumnType.WHITOUT_AUTO], 4)
+    )
+
+    connection, database, table = _create_table('projtest', 'projpigs', columns)
+    for i in range(ROWS):
+        table.append_row(uid=i, name=f'Proj{i}', weight=i * 3)
+
+    print('\n[Test] Projection by index test...')
+    answer: bytes = _querry(database, 'get row projpigs columns ( weight uid ) by_index 5')
+    assert answer == b'0015' + b'00000005', f"Projection by index incorrect: {answer}"
+
+    print('\n[Test] Projection by expression test...')
+    answer = _querry(database, 'get row projpigs columns ( name ) by_exp column weight > 44 limit 10')
+    names: list = [ x.decode().strip() for x in _split(answer, 16) ]
+    assert names == [ f'Proj{i}' for i in range(15, ROWS) ], f"Projection by expression incorrect: {names}"
+
+    answer = _querry(database, 'get row projpigs columns ( weight nope ) by_index 5')
+    assert len(answer) == 1 and _code(answer) < 0, f"Unknown column not rejected: {answer}"
+
+    connection.close_connection()
+    print('\n[Test] Projection test complete')
+
+
+def _aggregate_test() -> None:
+    """
+    Aggregates should be calculated in kernel for all rows (or groups) and return -2, when sum doesn't fit into i64.
+    """
+    ROWS: int = 100
+    columns: dict = dict(
+        uid=Column('uid', ColumnDataType.INT, [ColumnType.NOT_PRIMARY, ColumnType.WHITOUT_AUTO], 8),
+        grp=Column('grp', ColumnDataType.INT, [ColumnType.NOT_PRIMARY, ColumnType.WHITOUT_AUTO], 4),
+        weight=Column('weight', ColumnDataType.INT, [ColumnType.NOT_PRIMARY, ColumnType.WHITOUT_AUTO], 20)
+    )
+
+    connection, database, table = _create_table('aggtest', 'aggpigs', columns)
+    for i in range(ROWS):
+        table.append_row(uid=i, grp=i % 4, weight=i)
+
+    print('\n[Test] Aggregates test...')
+    assert int(_querry(database, 'get count aggpigs')) == ROWS, "Count incorrect"
+    assert int(_querry(database, 'get sum(weight) aggpigs')) == sum(range(ROWS)), "Sum incorrect"
+    assert int(_querry(database, 'get min(weight) aggpigs')) == 0, "Min incorrect"
+    assert int(_querry(database, 'get max(weight) aggpigs')) == ROWS - 1, "Max incorrect"
+    assert float(_querry(database, 'get avg(weight) aggpigs')) == (ROWS - 1) / 2, "Avg incorrect"
+    assert int(_querry(database, 'get count aggpigs by_exp column weight > 49')) == ROWS - 50, "Count by_exp incorrect"
+
+    print('\n[Test] Aggregates with group by test...')
+    answer: bytes = _querry(database, 'get sum(weight) aggpigs group by grp')
+    groups: dict = { int(x[:4]): int(x[4:]) for x in _split(answer, 4 + 25) }
+    assert groups == { g: sum(range(g, ROWS, 4)) for g in range(4) }, f"Group by incorrect: {groups}"
+
+    print('\n[Test] Aggregate sum overflow test...')
+    for i in range(2):
+        table.append_row(uid=ROWS + i, grp=9, weight=9 * 10 ** 18)
+
+    assert _code(_querry(database, 'get sum(weight) aggpigs')) == -2, "Sum overflow not reported"
+    assert _code(_querry(database, 'get avg(weight) aggpigs by_exp column grp = 9')) == -2, "Avg overflow not reported"
+    assert int(_querry(database, 'get max(weight) aggpigs')) == 9 * 10 ** 18, "Max incorrect after overflow"
+
+    connection.close_connection()
+    print('\n[Test] Aggregates test complete')
+
+
+def _order_test() -> None:
+    """
+    Order by should sort all rows, and keep only first rows with limit (top-K).
+    """
+    ROWS: int = 200
+    columns: dict = dict(
+        uid=Column('uid', ColumnDataType.INT, [ColumnType.NOT_PRIMARY, ColumnType.WHITOUT_AUTO], 8),
+        weight=Column('weight', ColumnDataType.INT, [ColumnType.NOT_PRIMARY, ColumnType.WHITOUT_AUTO], 8)
+    )
+
+    connection, database, table = _create_table('sorttest', 'sortpigs', columns)
+    weights: list = random.sample(range(ROWS), ROWS)
+    for i, weight in enumerate(weights):
+        table.append_row(uid=i, weight=weight)
+
+    def _sorted(querry: str) -> list:
+        return [ int(x[8:]) for x in _split(_querry(database, querry), 16) ]
+
+    print('\n[Test] Order by test...')
+    assert _sorted('get row sortpigs by_exp column uid > -1 order by weight') == list(range(ROWS)), "Order by asc incorrect"
+
+    print('\n[Test] Order by with limit (top-K) test...')
+    top: list = _sorted('get row sortpigs by_exp column uid > -1 limit 5 order by weight desc')
+    assert top == list(range(ROWS - 1, ROWS - 6, -1)), f"Top-K incorrect: {top}"
+
+    answer: bytes = _querry(database, 'get row sortpigs columns ( uid ) by_exp column weight > 9 limit 3 order by weight')
+    uids: list = [ int(x) for x in _split(answer, 8) ]
+    assert uids == [ weights.index(w) for w in [ 10, 11, 12 ] ], f"Top-K with projection incorrect: {uids}"
+
+    connection.close_connection()
+    print('\n[Test] Order by test complete')
+
+
+def _join_test() -> None:
+    """
+    Join should give every pair of matched rows. Database has three tables, that's why join loads tables,
+    while cache is full.
+    """
+    OWNERS: int = 5
+    owners_columns: dict = dict(
+        oid=Column('oid', ColumnDataType.INT, [ColumnType.NOT_PRIMARY, ColumnType.WHITOUT_AUTO], 8),
+        name=Column('name', ColumnDataType.STR, [ColumnType.NOT_PRIMARY, ColumnType.WHITOUT_AUTO], 8)
+    )
+
+    pigs_columns: dict = dict(
+        pid=Column('pid', ColumnDataType.INT, [ColumnType.NOT_PRIMARY, ColumnType.WHITOUT_AUTO], 8),
+        powner=Column('powner', ColumnDataType.INT, [ColumnType.NOT_PRIMARY, ColumnType.WHITOUT_AUTO], 8)
+    )
+
+    farms_columns: dict = dict(
+        fid=Column('fid', ColumnDataType.INT, [ColumnType.NOT_PRIMARY, ColumnType.WHITOUT_AUTO], 8),
+        fowner=Column('fowner', ColumnDataType.INT, [ColumnType.NOT_PRIMARY, ColumnType.WHITOUT_AUTO], 8)
+    )
+
+    connection, database, owners = _create_table('jointest', 'owners', owners_columns)
+    pigs: Table = database.add_table(table_name='jpigs', access='same', **pigs_columns)
+    farms: Table = database.add_table(table_name='farms', access='same', **farms_columns)
+    for i in range(OWNERS):
+        owners.append_row(oid=i, name=f'Owner{i}')
+
+    for i in range(4 * OWNERS):
+        pigs.append_row(pid=i, powner=i % OWNERS)
+
+    for i in range(2 * OWNERS):
+        farms.append_row(fid=i, fowner=i % OWNERS)
+
+    def _join(querry: str) -> list:
+        # Every joined row is four 8 symbols columns: two of first table and two of second
+        return [ [ x[i:i + 8].decode().strip() for i in range(0, 32, 8) ] for x in _split(_querry(database, querry), 32) ]
+
+    print('\n[Test] Join test...')
+    rows: list = _join('get row jpigs join owners on powner = oid')
+    assert len(rows) == 4 * OWNERS, f"Join rows count incorrect: {len(rows)}"
+    for pid, powner, oid, name in rows:
+        assert int(powner) == int(oid) == int(pid) % OWNERS and name == f'Owner{int(oid)}', "Join data incorrect"
+
+    print('\n[Test] Join of every pair of three tables test...')
+    rows = _join('get row farms join owners on fowner = oid by_exp column name eq Owner3')
+    assert sorted(int(x[0]) for x in rows) == [ 3, 3 + OWNERS ], f"Join with expression incorrect: {rows}"
+
+    rows = _join('get row owners join farms on oid = fowner')
+    assert len(rows) == 2 * OWNERS, f"Join rows count incorrect: {len(rows)}"
+    for oid, name, fid, fowner in rows:
+        assert int(oid) == int(fowner) == int(fid) % OWNERS and name == f'Owner{int(oid)}', "Join data incorrect"
+
+    rows = _join('get row jpigs join farms on powner = fowner by_exp column pid < 4')
+    assert len(rows) == 2 * 4, f"Join rows count incorrect: {len(rows)}"
+    for pid, powner, fid, fowner in rows:
+        assert int(powner) == int(fowner) == int(fid) % OWNERS, "Join data incorrect"
+
+    assert owners.get_row_by_index(OWNERS - 1).name == f'Owner{OWNERS - 1}', "Table data incorrect after joins"
+
+    connection.close_connection()
+    print('\n[Test] Join test complete')
+
+
+def _zone_map_test() -> None:
+    """
+    Scans skip pages by zone maps, that's why zone maps should follow every update and delete.
+    """
+    ROWS: int = 1000
+    columns: dict = dict(
+        uid=Column('uid', ColumnDataType.INT, [ColumnType.NOT_PRIMARY, ColumnType.WHITOUT_AUTO], 8),
+        weight=Column('weight', ColumnDataType.INT, [ColumnType.NOT_PRIMARY, ColumnType.WHITOUT_AUTO], 8),
+        name=Column('name', ColumnDataType.STR, [ColumnType.NOT_PRIMARY, ColumnType.WHITOUT_AUTO], 16)
+    )
+
+    connection, database, table = _create_table('zonetest', 'zonepigs', columns)
+    for i in range(ROWS):
+        table.append_row(uid=i, weight=i, name=f'Zone{i}')
+
+    def _uids(expression: list[Statement | LogicOperator]) -> list:
+        rows: list | None = table.get_row_by_expression(expression=expression, limit=100)
+        return sorted(x.uid for x in rows) if rows else []
+
+    print('\n[Test] Zone map scan test...')
+    assert _uids([ Statement(column_name="weight", expression=Expressions.MORE_THEN, value=ROWS - 10) ]) == list(range(ROWS - 9, ROWS)), "Zone map scan incorrect"
+    assert _uids([ Statement(column_name="weight", expression=Expressions.EQUALS, value=500) ]) == [ 500 ], "Zone map scan incorrect"
+
+    print('\n[Test] Zone map after update and delete test...')
+    table.insert_row_by_index(5, uid=5, weight=10 * ROWS, name='ZoneMoved')
+    for index in range(3):
+        table.delete_row_by_index(index)
+
+    assert _uids([ Statement(column_name="weight", expression=Expressions.MORE_THEN, value=5 * ROWS) ]) == [ 5 ], "Zone map don't see updated row"
+    assert _uids([ Statement(column_name="weight", expression=Expressions.LESS_THEN, value=6) ]) == [ 3, 4 ], "Zone map scan incorrect after delete"
+
+    print('\n[Test] Zone map load from disk test...')
+    database.sync()
+    connection, database, table = _reload_table(connection, database, table, columns)
+    assert _uids([ Statement(column_name="weight", expression=Expressions.MORE_THEN, value=5 * ROWS) ]) == [ 5 ], "Zone map incorrect after load"
+    assert _uids([ Statement(column_name="uid", expression=Expressions.LESS_THEN, value=6) ]) == [ 3, 4, 5 ], "Zone map incorrect after load"
+
+    connection.close_connection()
+    print('\n[Test] Zone map test complete')
+
+
+def _bloom_test() -> None:
+    """
+    Scans skip pages by Bloom filters, that's why filters should know every appended and updated value.
+    """
+    ROWS: int = 1000
+    columns: dict = dict(
+        uid=Column('uid', ColumnDataType.INT, [ColumnType.NOT_PRIMARY, ColumnType.WHITOUT_AUTO], 8),
+        name=Column('name', ColumnDataType.STR, [ColumnType.NOT_PRIMARY, ColumnType.WHITOUT_AUTO], 16)
+    )
+
+    connection, database, table = _create_table('bloomtst', 'bloompig', columns, bloom=[ 'name' ])
+    for i in range(ROWS):
+        table.append_row(uid=i, name=f'Bloom{i}')
+
+    def _uids(name: str) -> list:
+        rows: list | None = table.get_row_by_expression(
+            expression=[ Statement(column_name="name", expression=Expressions.STR_EQUALS, value=name) ]
+        )
+
+        return sorted(x.uid for x in rows) if rows else []
+
+    print('\n[Test] Bloom filter scan test...')
+    assert _uids('Bloom500') == [ 500 ], "Bloom filter skipped matched page"
+    assert _uids(f'Bloom{ROWS - 1}') == [ ROWS - 1 ], "Bloom filter skipped matched page"
+    assert _uids('Missing') == [], "Bloom filter scan found missing value"
+
+    print('\n[Test] Bloom filter after update test...')
+    table.insert_row_by_index(10, uid=10, name='Renamed')
+
+    assert _uids('Renamed') == [ 10 ], "Bloom filter don't see updated value"
+    assert _uids('Bloom10') == [], "Updated value found by old name"
+
+    print('\n[Test] Bloom filter load from disk test...')
+    database.sync()
+    connection, database, table = _reload_table(connection, database, table, columns)
+    assert _uids('Renamed') == [ 10 ], "Bloom filter incorrect after load"
+    assert _uids('Bloom999') == [ 999 ], "Bloom filter incorrect after load"
+
+    connection.close_connection()
+    print('\n[Test] Bloom filter test complete')
+
+
+def _cursor_test() -> None:
+    """
+    Cursor should return all rows by parts. Every fetch reads page again, so changed rows are visible.
+    """
+    ROWS: int = 500
+    columns: dict = dict(
+        uid=Column('uid', ColumnDataType.INT, [ColumnType.NOT_PRIMARY, ColumnType.WHITOUT_AUTO], 8),
+        name=Column('name', ColumnDataType.STR, [ColumnType.NOT_PRIMARY, ColumnType.WHITOUT_AUTO], 16)
+    )
+
+    connection, database, table = _create_table('curtest', 'curpigs', columns)
+    for i in range(ROWS):
+        table.append_row(uid=i, name=f'Cursor{i}')
+
+    def _fetch(count: int) -> list:
+        return [ (int(x[:8]), x[8:].decode().strip()) for x in _split(_querry(database, f'fetch {count}'), 24) ]
+
+    print('\n[Test] Cursor fetch test...')
+    assert _querry(database, 'open cursor curpigs by_exp column uid > -1') == b'\x01', "Cursor not opened"
+    rows: list = _fetch(100)
+    assert [ uid for uid, _ in rows ] == list(range(100)), "First fetch incorrect"
+
+    print('\n[Test] Cursor with changed rows test...')
+    for index in range(100, 150):
+        table.delete_row_by_index(index)
+
+    table.insert_row_by_index(150, uid=150, name='CursorNew')
+
+    rows = _fetch(100)
+    assert [ uid for uid, _ in rows ] == list(range(150, 250)), "Cursor returned deleted rows"
+    assert rows[0][1] == 'CursorNew', "Cursor returned old value of updated row"
+
+    fetched: int = 0
+    rows = _fetch(100)
+    while len(rows) > 0:
+        fetched += len(rows)
+        rows = _fetch(100)
+
+    assert fetched == ROWS - 250, f"Cursor rows count incorrect: {fetched}"
+    assert _querry(database, 'fetch 1') == b'\x00', "Fetch after end should return 0"
+
+    print('\n[Test] Cursor close test...')
+    assert _querry(database, 'close cursor') == b'\x01', "Cursor not closed"
+    assert _code(_querry(database, 'fetch 1')) < 0, "Fetch after close should fail"
+
+    assert _querry(database, 'open cursor curpigs columns ( name ) by_exp column uid > 490') == b'\x01', "Cursor not opened"
+    names: list = [ x.decode().strip() for x in _split(_querry(database, 'fetch 100'), 16) ]
+    assert names == [ f'Cursor{i}' for i in range(491, ROWS) ], f"Cursor projection incorrect: {names}"
+    _querry(database, 'close cursor')
+
+    connection.close_connection()
+    print('\n[Test] Cursor test complete')
+
+
+def _set_mutation_test() -> None:
+    """
+    Update and delete by expression should change matched rows of every page and keep other rows.
+    """
+    ROWS: int = 1000
+    columns: dict = dict(
+        uid=Column('uid', ColumnDataType.INT, [ColumnType.NOT_PRIMARY, ColumnType.WHITOUT_AUTO], 8),
+        grp=Column('grp', ColumnDataType.INT, [ColumnType.NOT_PRIMARY, ColumnType.WHITOUT_AUTO], 4),
+        name=Column('name', ColumnDataType.STR, [ColumnType.NOT_PRIMARY, ColumnType.WHITOUT_AUTO], 16)
+    )
+
+    connection, database, table = _create_table('settest', 'setpigs', columns)
+    for i in range(ROWS):
+        table.append_row(uid=i, grp=i % 4, name=f'Set{i}')
+
+    updated: list = [ Statement(column_name="name", expression=Expressions.STR_EQUALS, value="SetUpdated") ]
+    grp_1: list = [ Statement(column_name="grp", expression=Expressions.EQUALS, value=1) ]
+
+    print('\n[Test] Set-based update test...')
+    table.insert_row_by_expression(
+        expression=[ Statement(column_name="grp", expression=Expressions.EQUALS, value=3) ],
+        uid=ROWS, grp=3, name='SetUpdated'
+    )
+
+    assert _count_rows(table, updated) == ROWS // 4, "Not all matched rows updated"
+    assert _count_rows(table) == ROWS, "Rows lost after update"
+
+    print('\n[Test] Set-based delete test...')
+    table.delete_row_by_expression(expression=grp_1)
+    assert _count_rows(table, grp_1) == 0, "Not all matched rows deleted"
+    assert _count_rows(table) == ROWS - ROWS // 4, "Not matched rows deleted"
+
+    print('\n[Test] Set-based changes load from disk test...')
+    database.sync()
+    connection, database, table = _reload_table(connection, database, table, columns)
+    assert _count_rows(table, updated) == ROWS // 4, "Updated rows lost after load"
+    assert _count_rows(table) == ROWS - ROWS // 4, "Rows count incorrect after load"
+
+    connection.close_connection()
+    print('\n[Test] Set-based update and delete test complete')
+
+
+def _prepared_test() -> None:
+    """
+    Prepared statement should be executed with params in place of ?, until statement closed.
+    """
+    ROWS: int = 50
+    columns: dict = dict(
+        uid=Column('uid', ColumnDataType.INT, [ColumnType.NOT_PRIMARY, ColumnType.WHITOUT_AUTO], 8),
+        name=Column('name', ColumnDataType.STR, [ColumnType.NOT_PRIMARY, ColumnType.WHITOUT_AUTO], 16),
+        weight=Column('weight', ColumnDataType.INT, [ColumnType.NOT_PRIMARY, ColumnType.WHITOUT_AUTO], 4)
+    )
+
+    connection, database, table = _create_table('preptest', 'preppigs', columns)
+    for i in range(ROWS):
+        table.append_row(uid=i, name=f'Prep{i}', weight=i)
+
+    print('\n[Test] Prepared get test...')
+    assert _querry(database, 'prepare find get row preppigs by_exp column uid = ?') == b'\x01', "Statement not prepared"
+    for uid in [ 7, 42 ]:
+        answer: bytes = _querry(database, f'execute find {uid}')
+        assert int(answer[:8]) == uid and answer[8:24].decode().strip() == f'Prep{uid}', f"Execute incorrect: {answer}"
+
+    assert _querry(database, 'prepare proj get row preppigs columns ( name ) by_exp column weight > ? limit ?') == b'\x01', "Statement not prepared"
+    names: list = [ x.decode().strip() for x in _split(_querry(database, 'execute proj 45 3'), 16) ]
+    assert names == [ 'Prep46', 'Prep47', 'Prep48' ], f"Execute with projection incorrect: {names}"
+
+    print('\n[Test] Prepared update test...')
+    assert _querry(database, 'prepare up update row preppigs ? by_exp column uid = ?') == b'\x01', "Statement not prepared"
+    _querry(database, f'execute up "{table._generate_querry(uid=7, name="Prepared", weight=7)}" 7')
+    assert _querry(database, 'execute find 7')[8:24].decode().strip() == 'Prepared', "Prepared update not applied"
+
+    print('\n[Test] Prepared statement errors test...')
+    assert _code(_querry(database, 'execute find')) < 0, "Execute without params should fail"
+    assert _querry(database, 'close statement find') == b'\x01', "Statement not closed"
+    assert _code(_querry(database, 'execute find 7')) < 0, "Execute of closed statement should fail"
+
+    connection.close_connection()
+    print('\n[Test] Prepared statements test complete')
+
+
+def _explain_test() -> None:
+    """
+    Explain should describe access path, and explain analyze should execute command and count skipped pages.
+    """
+    ROWS: int = 2000
+    columns: dict = dict(
+        uid=Column('uid', ColumnDataType.INT, [ColumnType.NOT_PRIMARY, ColumnType.WHITOUT_AUTO], 8),
+        name=Column('name', ColumnDataType.STR, [ColumnType.NOT_PRIMARY, ColumnType.WHITOUT_AUTO], 16)
+    )
+
+    connection, database, table = _create_table('explain', 'exppigs', columns, bloom=[ 'name' ])
+    for i in range(ROWS):
+        table.append_row(uid=i, name=f'Exp{i}')
+
+    def _explain(querry: str) -> str:
+        return _querry(database, f'explain {querry}').decode()
+
+    def _skipped(plan: str) -> int:
+        return int(plan.split('skipped=')[1].split()[0])
+
+    print('\n[Test] Explain test...')
+    assert 'index lookup' in _explain('get row exppigs by_index 3'), "Explain of index lookup incorrect"
+    assert '(zone map)' in _explain('get row exppigs by_exp column uid = 42'), "Explain of zone map incorrect"
+    assert 'top-K heap' in _explain('get row exppigs by_exp column uid > 0 limit 5 order by uid desc'), "Explain of order incorrect"
+    assert 'aggregate' in _explain('get count exppigs'), "Explain of aggregate incorrect"
+    assert 'hash join' in _explain('get row exppigs join exppigs on uid = uid'), "Explain of join incorrect"
+
+    print('\n[Test] Explain analyze test...')
+    plan: str = _explain(f'analyze get row exppigs by_exp column uid > {ROWS - 10}')
+    assert _skipped(plan) > 0 and 'rows_out=9' in plan, f"Zone map pages not skipped:\n{plan}"
+
+    plan = _explain('analyze get row exppigs by_exp column name eq Exp77')
+    assert '(bloom filter)' in plan and _skipped(plan) > 0 and 'rows_out=1' in plan, f"Bloom filter pages not skipped:\n{plan}"
+
+    plan = _explain(f'analyze delete row exppigs by_exp column uid > {ROWS - 6}')
+    assert 'set-based delete' in plan, f"Explain of delete incorrect:\n{plan}"
+    assert _count_rows(table) == ROWS - 5, "Explain analyze didn't execute delete"
+
+    connection.close_connection()
+    print('\n[Test] Explain test complete')
+
+
+def _binary_test() -> None:
+    """
+    Binary columns should keep values of column type, compare them as numbers and reject values, that don't fit.
+    """
+    ROWS: int = 100
+    columns: dict = dict(
+        uid=Column('uid', ColumnDataType.INT, [ColumnType.NOT_PRIMARY, ColumnType.WHITOUT_AUTO], 8),
+        small=Column('small', ColumnDataType.I32, [ColumnType.NOT_PRIMARY, ColumnType.WHITOUT_AUTO], 11),
+        big=Column('big', ColumnDataType.I64, [ColumnType.NOT_PRIMARY, ColumnType.WHITOUT_AUTO], 20),
+        real=Column('real', ColumnDataType.F64, [ColumnType.NOT_PRIMARY, ColumnType.WHITOUT_AUTO], 24),
+        price=Column('price', ColumnDataType.DECIMAL, [ColumnType.NOT_PRIMARY, ColumnType.WHITOUT_AUTO], 21)
+    )
+
+    connection, database, table = _create_table('bintest', 'binpigs', columns)
+
+    def _row(uid: int, small: str, big: str, real: str, price: str) -> dict:
+        return dict(uid=uid, small=small, big=big, real=real, price=price)
+
+    def _uids(expression: list[Statement | LogicOperator]) -> list:
+        rows: list | None = table.get_row_by_expression(expression=expression)
+        return sorted(x.uid for x in rows) if rows else []
+
+    print('\n[Test] Binary columns append test...')
+    for i in range(ROWS):
+        table.append_row(**_row(i, str(i - 50), str(i * 10 ** 9), str(i / 4), f'{i}.{i:02d}'))
+
+    row = table.get_row_by_index(3)
+    assert (row.small, row.big, row.real, row.price) == (-47, 3 * 10 ** 9, 0.75, 3.03), "Binary data incorrect"
+
+    print('\n[Test] Binary columns compare test...')
+    assert _uids([ Statement(column_name="small", expression=Expressions.LESS_THEN, value=-45) ]) == list(range(5)), "i32 compare incorrect"
+    assert _uids([ Statement(column_name="big", expression=Expressions.MORE_THEN, value=97 * 10 ** 9) ]) == [ 98, 99 ], "i64 compare incorrect"
+    assert _uids([ Statement(column_name="real", expression=Expressions.MORE_THEN, value=24.5) ]) == [ 99 ], "f64 compare incorrect"
+    assert _uids([ Statement(column_name="price", expression=Expressions.EQUALS, value=3.03) ]) == [ 3 ], "decimal compare incorrect"
+
+    print('\n[Test] Binary columns aggregates test...')
+    assert int(_querry(database, 'get sum(big) binpigs')) == sum(range(ROWS)) * 10 ** 9, "i64 sum incorrect"
+    assert float(_querry(database, 'get sum(real) binpigs')) == sum(range(ROWS)) / 4, "f64 sum incorrect"
+    assert float(_querry(database, 'get max(price) binpigs')) == 99.99, "decimal max incorrect"
+
+    print('\n[Test] Binary columns reject test...')
+    for values in [
+        _row(ROWS, '2147483648', '0', '0', '0'), _row(ROWS, '0', '9223372036854775808', '0', '0'),
+        _row(ROWS, '0', '0', 'nan', '0'), _row(ROWS, '0', '0', 'inf', '0'), _row(ROWS, '0', '0', '1e999', '0'),
+        _row(ROWS, '0', '0', '0', '1000000000000000000'), _row(ROWS, 'x', '0', '0', '0')
+    ]:
+        answer: bytes = _querry(database, f'append row binpigs values "{table._generate_querry(**values)}"')
+        assert _code(answer) == -12, f"Value, that doesn't fit, not rejected: {values} ({answer})"
+
+    assert _count_rows(table) == ROWS, "Rejected rows appended"
+
+    connection.close_connection()
+    print('\n[Test] Binary columns test complete')
+
+
+def _pax_test() -> None:
+    """
+    PAX table should give same rows, as rows table, after every change and after load from disk.
+    """
+    ROWS: int = 1000
+    columns: dict = dict(
+        uid=Column('uid', ColumnDataType.INT, [ColumnType.NOT_PRIMARY, ColumnType.WHITOUT_AUTO], 8),
+        name=Column('name', ColumnDataType.STR, [ColumnType.NOT_PRIMARY, ColumnType.WHITOUT_AUTO], 16),
+        weight=Column('weight', ColumnDataType.INT, [ColumnType.NOT_PRIMARY, ColumnType.WHITOUT_AUTO], 4)
+    )
+
+    connection, database, table = _create_table('paxtest', 'paxpigs', columns, layout='pax')
+
+    # region [CREATE]
+
+    print('\n[Test] PAX table append test...')
+    for i in range(ROWS):
+        table.append_row(uid=i, name=f'Pax{i}', weight=i % 200)
+
+    database.sync()
+    for index in [ 0, random.randint(1, ROWS - 2), ROWS - 1 ]:
+        row = table.get_row_by_index(index)
+        assert row.uid == index and row.name == f'Pax{index}' and row.weight == index % 200, f"PAX row [{index}] incorrect"
+
+    rows: list = table.get_row_by_expression(
+        expression=[
+            Statement(column_name="weight", expression=Expressions.MORE_THEN, value=197)
+        ], limit=100
+    )
+
+    assert len(rows) == 2 * (ROWS // 200), f"PAX get by_exp count incorrect: {len(rows)}"
+    for i in rows:
+        assert i.weight > 197 and i.name == f'Pax{i.uid}', "PAX get by_exp data incorrect"
+
+    # endregion
+
+    # region [UPDATE]
+
+    print('\n[Test] PAX table update test...')
+    table.insert_row_by_expression(
+        expression=[
+            Statement(column_name="weight", expression=Expressions.EQUALS, value=7)
+        ],
+        uid=7, name="PaxUpdated", weight=7
+    )
+
+    database.sync()
+    rows = table.get_row_by_expression(
+        expression=[
+            Statement(column_name="name", expression=Expressions.STR_EQUALS, value="PaxUpdated")
+        ], limit=100
+    )
+
+    assert len(rows) == ROWS // 200, f"PAX updated rows count incorrect: {len(rows)}"
+    for i in rows:
+        assert i.uid == 7 and i.weight == 7, "PAX updated data incorrect"
+
+    # endregion
+
+    # region [DELETE]
+
+    print('\n[Test] PAX table delete test...')
+    table.delete_row_by_expression(
+        expression=[
+            Statement(column_name="name", expression=Expressions.STR_EQUALS, value="PaxUpdated")
+        ]
+    )
+
+    database.sync()
+    assert _count_rows(table, [ Statement(column_name="weight", expression=Expressions.EQUALS, value=7) ]) == 0, "PAX deleted data exists"
+    assert _count_rows(table) == ROWS - ROWS // 200, "PAX rows lost after delete"
+
+    # endregion
+
+    # region [LOAD]
+
+    print('\n[Test] PAX table load from disk test...')
+    connection, database, table = _reload_table(connection, database, table, columns)
+    assert _count_rows(table) == ROWS - ROWS // 200, "PAX rows lost after load"
+
+    row = table.get_row_by_index(ROWS - 1)
+    assert row.uid == ROWS - 1 and row.name == f'Pax{ROWS - 1}', "PAX loaded data incorrect"
+
+    # endregion
+
+    connection.close_connection()
+    print('\n[Test] PAX table test complete')
+
+
+def _compressed_test() -> None:
+    """
+    Compressed table should give same rows after load from disk. Half of rows are random text with random uid,
+    that's why their pages don't give gain and saved without compression.
+    """
+    ROWS: int = 200
+    columns: dict = dict(
+        uid=Column('uid', ColumnDataType.INT, [ColumnType.NOT_PRIMARY, ColumnType.WHITOUT_AUTO], 8),
+        payload=Column('payload', ColumnDataType.STR, [ColumnType.NOT_PRIMARY, ColumnType.WHITOUT_AUTO], 128)
+    )
+
+    connection, database, table = _create_table('lztest', 'lzpigs', columns, compress='lz')
+
+    def _random_payload() -> str:
+        return ''.join(random.choices(string.ascii_letters + string.digits, k=128))
+
+    def _check_rows(expected: dict) -> None:
+        rows: dict = {
+            x.uid: x.payload for x in table.iterate_rows_by_expression(
+                expression=[ Statement(column_name="uid", expression=Expressions.MORE_THEN, value=-1) ]
+            )
+        }
+
+        assert len(rows) == len(expected), f"Compressed table rows count incorrect: {len(rows)}/{len(expected)}"
+        for uid, payload in expected.items():
+            assert rows.get(uid) == payload, f"Compressed table row [{uid}] incorrect"
+
+    # region [CREATE]
+
+    print('\n[Test] Compressed table append test...')
+    expected: dict = {}
+    for i in range(ROWS):
+        expected[i] = f'Lz{i}'
+
+    noise_uids: list = random.sample(range(10 ** 7, 10 ** 8), ROWS)
+    for uid in noise_uids:
+        expected[uid] = _random_payload()
+
+    for uid, payload in expected.items():
+        table.append_row(uid=uid, payload=payload)
+
+    database.sync()
+    _check_rows(expected)
+
+    # endregion
+
+    # region [UPDATE AND DELETE]
+
+    print('\n[Test] Compressed table update and delete test...')
+    expected[5] = _random_payload()
+    expected[noise_uids[5]] = 'LzShrunk'
+    for uid in [ 5, noise_uids[5] ]:
+        table.insert_row_by_expression(
+            expression=[ Statement(column_name="uid", expression=Expressions.EQUALS, value=uid) ],
+            uid=uid, payload=expected[uid]
+        )
+
+    for uid in [ 10, noise_uids[10] ]:
+        table.delete_row_by_expression(
+            expression=[ Statement(column_name="uid", expression=Expressions.EQUALS, value=uid) ]
+        )
+
+        del expected[uid]
+
+    database.sync()
+    _check_rows(expected)
+
+    # endregion
+
+    # region [LOAD]
+
+    print('\n[Test] Compressed table load from disk test...')
+    connection, database, table = _reload_table(connection, database, table, columns)
+    _check_rows(expected)
+
+    # endregion
+
+    connection.close_connection()
+    print('\n[Test] Compressed table test complete')
+
+
+def _modules_test() -> None:
+    """
+    Module columns should give same values with inline bytecode (calc), shared object (calcso.so)
+    and executable worker (calcmd.mdl). Modules are compiled from modules/calc into BUILDS_PATH,
+    that's why server should be started in this directory.
+    """
+    ROWS: int = 200
+    source: str = os.path.join(os.path.dirname(os.path.abspath(__file__)), '..', 'modules', 'calc', 'calc.c')
+    subprocess.run([ 'gcc', '-shared', '-fPIC', source, '-o', os.path.join(BUILDS_PATH, 'calcso.so'), '-lm' ], check=True)
+    subprocess.run([ 'gcc', source, '-o', os.path.join(BUILDS_PATH, 'calcmd.mdl'), '-lm' ], check=True)
+
+    columns: dict = dict(
+        uid=Column('uid', ColumnDataType.INT, [ColumnType.NOT_PRIMARY, ColumnType.WHITOUT_AUTO], 8),
+        weight=Column('weight', ColumnDataType.INT, [ColumnType.NOT_PRIMARY, ColumnType.WHITOUT_AUTO], 8),
+        inline=Column('inline', ColumnDataType.ANY, [ColumnType.NOT_PRIMARY, ColumnType.WHITOUT_AUTO], 12),
+        shared=Column('shared', ColumnDataType.ANY, [ColumnType.NOT_PRIMARY, ColumnType.WHITOUT_AUTO], 12),
+        process=Column('process', ColumnDataType.ANY, [ColumnType.NOT_PRIMARY, ColumnType.WHITOUT_AUTO], 12)
+    )
+
+    connection: Connection = _connect()
+    database: Database = DatabaseManager(connection=connection).create_database('mdltest')
+    _querry(
+        database,
+        'create table mdlpigs same columns ( uid 8 int np na weight 8 int np na '
+        'inline 12 "calc=weight*10+uid,mpost" np na shared 12 "calcso=weight*10+uid,mpost" np na '
+        'process 12 "calcmd=weight*10+uid,mpost" np na )'
+    )
+
+    table: Table = database.get_table(table_name='mdlpigs', access='same', **columns)
+    for i in range(ROWS):
+        table.append_row(uid=i, weight=i % 10)
+
+    def _check_rows() -> None:
+        count: int = 0
+        for row in table.iterate_rows_by_expression(expression=[ Statement(column_name="uid", expression=Expressions.MORE_THEN, value=-1) ]):
+            expected: int = row.weight * 10 + row.uid
+            assert int(row.inline) == int(row.shared) == int(row.process) == expected, f"Module columns of row [{row.uid}] incorrect"
+            count += 1
+
+        assert count == ROWS, f"Module table rows count incorrect: {count}"
+
+    print('\n[Test] Module columns test...')
+    _check_rows()
+
+    print('\n[Test] Module results cache test...')
+    plan: str = _querry(database, 'explain analyze get row mdlpigs columns ( shared ) by_exp column weight = 3 limit 100').decode()
+    memo_hits: int = int(plan.split('memo_hits=')[1].split()[0])
+    inline: int = int(plan.split('inline=')[1].split()[0])
+    assert memo_hits > 0 and inline == 0, f"Deterministic module results not cached:\n{plan}"
+
+    print('\n[Test] Module columns after update test...')
+    table.insert_row_by_expression(
+        expression=[ Statement(column_name="uid", expression=Expressions.EQUALS, value=7) ],
+        uid=7, weight=99
+    )
+
+    _check_rows()
+
+    connection.close_connection()
+    print('\n[Test] Module columns test complete')
+
+
+def _framed_test() -> None:
+    """
+    Framed connection should get answers of pipelined requests by request id, signed status and answers,
+    that bigger then one read of text protocol.
+    """
+    ROWS: int = 500
+    columns: list = [
+        Column('uid', ColumnDataType.INT, [ColumnType.NOT_PRIMARY, ColumnType.WHITOUT_AUTO], 8),
+        Column('name', ColumnDataType.STR, [ColumnType.NOT_PRIMARY, ColumnType.WHITOUT_AUTO], 16)
+    ]
+
+    connection: FramedConnection = FramedConnection(
+        base_addr='0.0.0.0',
+        port=7777,
+        username='root',
+        password='root'
+    ).open_connection()
+
+    print('\n[Test] Framed pipeline test...')
+    answers: list = connection.send_pipeline([
+        'create database frtest',
+        f'frtest create table frpigs same columns ( {" ".join([ x.body for x in columns ])} )'
+    ] + [ f'frtest append row frpigs values "{i:08d}{f"Frame{i}":>16}"' for i in range(ROWS) ])
+
+    assert all(status == 1 for status, _ in answers), "Pipelined requests failed"
+
+    connection.send_data(f'frtest get row frpigs by_exp column uid > -1 limit {ROWS}')
+    rows: list = _split(connection.get_data(), 24)
+    assert connection.get_status() >= 0 and len(rows) == ROWS, f"Big answer incorrect: {len(rows)}"
+    assert [ int(x[:8]) for x in rows ] == list(range(ROWS)), "Big answer data incorrect"
+
+    print('\n[Test] Framed signed status test...')
+    connection.send_data('frtest append row frpigs values "short"')
+    assert connection.get_status() < 0, f"Error status incorrect: {connection.get_status()}"
+
+    connection.send_data('frtest get row frpigs by_index 3')
+    assert connection.get_status() >= 0 and connection.get_data()[8:].decode().strip() == 'Frame3', "Answer after error incorrect"
+
+    connection.close_connection()
+    print('\n[Test] Framed protocol test complete')
+
+
+def _batch_test() -> None:
+    """
+    Batch should return code of every command, and atomic batch should make rollback, if any command failed.
+    """
+    connection: FramedConnection = FramedConnection(
+        base_addr='0.0.0.0',
+        port=7777,
+        username='root',
+        password='root'
+    ).open_connection()
+
+    def _codes() -> list:
+        return [ x - 256 if x > 127 else x for x in connection.get_data() ]
+
+    def _count() -> int:
+        connection.send_data('battest get count batpigs')
+        return int(connection.get_data())
+
+    connection.send_pipeline([
+        'create database battest',
+        'battest create table batpigs same columns ( uid 8 "int" p na name 16 "str" np na )'
+    ])
+
+    print('\n[Test] Batch test...')
+    connection.send_data(
+        f'battest batch append row batpigs values "{1:08d}{"Batch1":>16}" ; append row batpigs values "{2:08d}{"Batch2":>16}" ; '
+        f'append row batpigs values "{1:08d}{"Batch1":>16}" ; delete row batpigs by_index 1 end'
+    )
+
+    # Delete by index answers with size of deleted row
+    assert _codes() == [ 1, 1, -20, 24 ], f"Batch codes incorrect: {_codes()}"
+    assert _count() == 1, "Batch commands not executed"
+
+    print('\n[Test] Atomic batch test...')
+    connection.send_data('battest sync')
+    connection.send_data(
+        f'battest batch atomic append row batpigs values "{3:08d}{"Batch3":>16}" ; append row batpigs values "{1:08d}{"Batch1":>16}" end'
+    )
+
+    assert connection.get_status() == -2 and _codes() == [ 1, -20 ], f"Atomic batch not failed: {connection.get_status()} {_codes()}"
+    assert _count() == 1, "Atomic batch not rolled back"
+
+    connection.send_data(
+        f'battest batch atomic append row batpigs values "{3:08d}{"Batch3":>16}" ; append row batpigs values "{4:08d}{"Batch4":>16}" end'
+    )
+
+    assert _codes() == [ 1, 1 ] and _count() == 3, "Atomic batch not executed"
+
+    connection.close_connection()
+    print('\n[Test] Batch test complete')
+
+
+def _stats_test() -> None:
+    """
+    Stats should count every command. Prometheus metrics are served on METRICS_PORT (server should be started with
+    CDBMS_METRICS_PORT), and scrape without request shouldn't stop new sessions.
+    """
+    COMMANDS: int = 20
+    columns: dict = dict(
+        uid=Column('uid', ColumnDataType.INT, [ColumnType.NOT_PRIMARY, ColumnType.WHITOUT_AUTO], 8)
+    )
+
+    connection, database, table = _create_table('stattest', 'statpigs', columns)
+    table.append_row(uid=1)
+
+    def _gets() -> int:
+        stats: str = _querry(database, 'stats').decode()
+        return int(stats.split('get: count=')[1].split()[0])
+
+    print('\n[Test] Stats test...')
+    table.get_row_by_index(0)
+    before: int = _gets()
+    for _ in range(COMMANDS):
+        table.get_row_by_index(0)
+
+    assert _gets() == before + COMMANDS, "Stats don't count get commands"
+    database.sync()
+    connection.close_connection()
+
+    print('\n[Test] Metrics endpoint test...')
+    silent: socket.socket = socket.create_connection(('127.0.0.1', METRICS_PORT))
+    start_time: float = time.perf_counter()
+    connection = _connect()
+    database = DatabaseManager(connection=connection).select_database('stattest')
+    answer: bytes = _querry(database, 'get count statpigs')
+    assert answer.strip() == b'1', f"Session incorrect with opened scrape: {answer}"
+    assert time.perf_counter() - start_time < 0.5, "Scrape without request stopped session"
+    connection.close_connection()
+
+    with socket.create_connection(('127.0.0.1', METRICS_PORT)) as scrape:
+        scrape.sendall(b'GET /metrics HTTP/1.0\r\n\r\n')
+        answer: bytes = scrape.recv(4096)
+        part: bytes = answer
+        while part:
+            part = scrape.recv(4096)
+            answer += part
+
+    silent.close()
+    assert answer.startswith(b'HTTP/1.0 200 OK') and b'cdbms_' in answer, f"Metrics answer incorrect: {answer[:100]}"
+    print('\n[Test] Stats test complete')
+
+
+def _slow_log_test() -> None:
+    """
+    Slow query log should have record with counters of command. Server should be started in BUILDS_PATH with
+    CDBMS_SLOW_QUERY_US=0, that's why every command is logged.
+    """
+    ROWS: int = 100
+    columns: dict = dict(
+        uid=Column('uid', ColumnDataType.INT, [ColumnType.NOT_PRIMARY, ColumnType.WHITOUT_AUTO], 8)
+    )
+
+    connection, database, table = _create_table('slowtest', 'slowpigs', columns)
+    for i in range(ROWS):
+        table.append_row(uid=i)
+
+    print('\n[Test] Slow query log test...')
+    table.get_row_by_expression(expression=[ Statement(column_name="uid", expression=Expressions.MORE_THEN, value=ROWS - 10) ])
+    connection.close_connection()
+
+    command: str = f'command=[slowtest get row slowpigs by_exp column uid > {ROWS - 10}]'
+    records: list = []
+    for _ in range(10):
+        with open(os.path.join(BUILDS_PATH, 'slow_queries.log')) as log:
+            records = [ x for x in log if command in x ]
+
+        if records:
+            break
+
+        time.sleep(0.1)
+
+    assert len(records) == 1, f"Slow query record not found: {records}"
+    assert f'rows_scanned={ROWS}' in records[0] and 'rows_returned=9' in records[0], f"Slow query record incorrect: {records[0]}"
+    print('\n[Test] Slow query log test complete')
+
+
 def _delete_files(folder: str, extensions: list):
     if not os.path.exists(folder):
         print(f"Dir {folder} does not exist!")
@@ -275,11 +1291,30 @@ if __name__ == "__main__":
         while True:
             try:
                 _global_test()
+                _append_rows_test()
+                _projection_test()
+                _aggregate_test()
+                _order_test()
+                _join_test()
+                _zone_map_test()
+                _bloom_test()
+                _cursor_test()
+                _set_mutation_test()
+                _prepared_test()
+                _explain_test()
+                _binary_test()
+                _pax_test()
+                _compressed_test()
+                _modules_test()
+                _framed_test()
+                _batch_test()
+                _stats_test()
+                _slow_log_test()
             except AssertionError as ex:
                 print("Test failed! Text:", str(ex))
             finally:
                 pass
-                _delete_files("/Users/nikolaj/Documents/Repositories/CordellDBMS.EXMPL/builds", ["db", "pg", "dr", "tb"])
+                _delete_files(BUILDS_PATH, ["db", "pg", "dr", "tb"])
             
             input("\nPress any key to continue...")
     except KeyboardInterrupt: